@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#define DURATION    1.0
+#define CANARY      0x5ca1ab1e
+
+struct value {
+    uintmax_t canary;
+};
+
+struct context {
+    struct rock_epoch epoch;
+    struct rock_hazard hazard;
+    struct value *_Atomic current;
+    atomic_bool done;
+    atomic_uintmax_t reads;
+    uintmax_t writes;
+};
+
+static double now(void) {
+    struct timespec ts;
+    seagrass_required_true(!clock_gettime(CLOCK_MONOTONIC, &ts));
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static struct value *make(void) {
+    struct value *const value = malloc(sizeof(*value));
+    seagrass_required(value);
+    value->canary = CANARY;
+    return value;
+}
+
+static void on_destroy(void *item) {
+    free(item);
+}
+
+static void *epoch_reader(void *arg) {
+    struct context *const context = arg;
+    struct rock_epoch_thread thread;
+    seagrass_required_true(!rock_epoch_register(&context->epoch, &thread));
+    uintmax_t count = 0;
+    while (!atomic_load_explicit(&context->done, memory_order_relaxed)) {
+        seagrass_required_true(!rock_epoch_enter(&context->epoch, &thread));
+        const struct value *const value = atomic_load(&context->current);
+        seagrass_required_true(CANARY == value->canary);
+        seagrass_required_true(!rock_epoch_exit(&context->epoch, &thread));
+        count++;
+    }
+    seagrass_required_true(!rock_epoch_unregister(&context->epoch, &thread));
+    atomic_fetch_add(&context->reads, count);
+    return NULL;
+}
+
+static void *epoch_writer(void *arg) {
+    struct context *const context = arg;
+    struct rock_epoch_thread thread;
+    seagrass_required_true(!rock_epoch_register(&context->epoch, &thread));
+    while (!atomic_load_explicit(&context->done, memory_order_relaxed)) {
+        seagrass_required_true(!rock_epoch_enter(&context->epoch, &thread));
+        struct value *const previous = atomic_exchange(&context->current,
+                                                       make());
+        seagrass_required_true(!rock_epoch_retire(&context->epoch, &thread,
+                                                  previous, on_destroy));
+        seagrass_required_true(!rock_epoch_exit(&context->epoch, &thread));
+        context->writes++;
+    }
+    seagrass_required_true(!rock_epoch_unregister(&context->epoch, &thread));
+    return NULL;
+}
+
+static void *hazard_reader(void *arg) {
+    struct context *const context = arg;
+    struct rock_hazard_thread thread;
+    seagrass_required_true(!rock_hazard_register(&context->hazard, &thread));
+    void *_Atomic const *const source
+            = (void *_Atomic const *) &context->current;
+    uintmax_t count = 0;
+    void *out;
+    while (!atomic_load_explicit(&context->done, memory_order_relaxed)) {
+        seagrass_required_true(!rock_hazard_protect(&context->hazard, &thread,
+                                                    0, source, &out));
+        const struct value *const value = out;
+        seagrass_required_true(CANARY == value->canary);
+        seagrass_required_true(!rock_hazard_clear(&context->hazard, &thread,
+                                                  0));
+        count++;
+    }
+    seagrass_required_true(!rock_hazard_unregister(&context->hazard,
+                                                   &thread));
+    atomic_fetch_add(&context->reads, count);
+    return NULL;
+}
+
+static void *hazard_writer(void *arg) {
+    struct context *const context = arg;
+    struct rock_hazard_thread thread;
+    seagrass_required_true(!rock_hazard_register(&context->hazard, &thread));
+    while (!atomic_load_explicit(&context->done, memory_order_relaxed)) {
+        struct value *const previous = atomic_exchange(&context->current,
+                                                       make());
+        seagrass_required_true(!rock_hazard_retire(&context->hazard, &thread,
+                                                   previous, on_destroy));
+        context->writes++;
+    }
+    seagrass_required_true(!rock_hazard_unregister(&context->hazard,
+                                                   &thread));
+    return NULL;
+}
+
+static void run(const char *const name,
+                void *(*const reader)(void *),
+                void *(*const writer)(void *),
+                const uintmax_t readers) {
+    struct context context = {};
+    seagrass_required_true(!rock_epoch_init(&context.epoch, 64));
+    seagrass_required_true(!rock_hazard_init(&context.hazard, 64));
+    atomic_init(&context.current, make());
+    pthread_t threads[readers + 1];
+    for (uintmax_t i = 0; i < readers; i++) {
+        seagrass_required_true(!pthread_create(&threads[i], NULL, reader,
+                                               &context));
+    }
+    seagrass_required_true(!pthread_create(&threads[readers], NULL, writer,
+                                           &context));
+    const double start = now();
+    struct timespec ts = {
+            .tv_sec = (time_t) DURATION,
+            .tv_nsec = (long) ((DURATION - (time_t) DURATION) * 1e9)
+    };
+    nanosleep(&ts, NULL);
+    atomic_store(&context.done, true);
+    for (uintmax_t i = 0; i <= readers; i++) {
+        seagrass_required_true(!pthread_join(threads[i], NULL));
+    }
+    const double elapsed = now() - start;
+    const uintmax_t reads = atomic_load(&context.reads);
+    fprintf(stdout, "%-6s readers: %2ju, elapsed: %8.3fs, reads/s: %12.0f, "
+                    "writes/s: %12.0f\n",
+            name, readers, elapsed, (double) reads / elapsed,
+            (double) context.writes / elapsed);
+    seagrass_required_true(!rock_epoch_invalidate(&context.epoch));
+    seagrass_required_true(!rock_hazard_invalidate(&context.hazard));
+    free(atomic_load(&context.current));
+}
+
+int main(int argc, char *argv[]) {
+    const uintmax_t limit = argc > 1 ? strtoumax(argv[1], NULL, 10) : 8;
+    for (uintmax_t i = 1; i <= limit; i <<= 1) {
+        run("epoch", epoch_reader, epoch_writer, i);
+        run("hazard", hazard_reader, hazard_writer, i);
+    }
+    return 0;
+}
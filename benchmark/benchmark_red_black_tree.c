@@ -0,0 +1,461 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#define PROBES      (1 << 22)
+#define THREADS     4
+
+struct entry {
+    uintmax_t value;
+    struct rock_red_black_tree_node node;
+};
+
+static double now(void) {
+    struct timespec ts;
+    seagrass_required_true(!clock_gettime(CLOCK_MONOTONIC, &ts));
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+struct named {
+    const char *key;
+    struct rock_red_black_tree_prefixed_node node;
+};
+
+static int compare(const struct rock_red_black_tree_node *a,
+                   const struct rock_red_black_tree_node *b) {
+    const struct entry *A = rock_container_of(a, struct entry, node);
+    const struct entry *B = rock_container_of(b, struct entry, node);
+    return seagrass_uintmax_t_compare(A->value, B->value);
+}
+
+static int compare_typed(const struct entry *a, const struct entry *b) {
+    return seagrass_uintmax_t_compare(a->value, b->value);
+}
+
+ROCK_RED_BLACK_TREE_DEFINE(typed, struct entry, node, compare_typed)
+
+static void run(const uintmax_t count) {
+    /* entries are allocated one by one so that they scatter in memory */
+    struct entry **const entries = malloc(count * sizeof(*entries));
+    seagrass_required(entries);
+    struct rock_red_black_tree tree;
+    seagrass_required_true(!rock_red_black_tree_init(&tree, compare));
+    for (uintmax_t i = 0; i < count; i++) {
+        const uintmax_t j = rand() % (i + 1);
+        entries[i] = entries[j];
+        entries[j] = malloc(sizeof(struct entry));
+        seagrass_required(entries[j]);
+        entries[j]->value = i;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find_or_insert(
+                &tree, &entries[i]->node, &out));
+    }
+    struct entry *const needles = malloc(PROBES * sizeof(*needles));
+    seagrass_required(needles);
+    const struct rock_red_black_tree_node **const nodes
+            = malloc(PROBES * sizeof(*nodes));
+    seagrass_required(nodes);
+    struct rock_red_black_tree_node **const out
+            = malloc(PROBES * sizeof(*out));
+    seagrass_required(out);
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        needles[i].value = rand() % count;
+        nodes[i] = &needles[i].node;
+    }
+    double start = now();
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        seagrass_required_true(!rock_red_black_tree_find(
+                &tree, NULL, nodes[i], &out[i]));
+    }
+    const double find = now() - start;
+    start = now();
+    seagrass_required_true(!rock_red_black_tree_find_batch(
+            &tree, nodes, PROBES, out));
+    const double batch = now() - start;
+    start = now();
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        struct entry *entry;
+        seagrass_required_true(!typed_find(&tree, &needles[i], &entry));
+    }
+    const double typed = now() - start;
+    struct rock_red_black_tree keyed;
+    seagrass_required_true(!rock_red_black_tree_init_keyed(
+            &keyed, offsetof(struct entry, value)
+                    - offsetof(struct entry, node),
+            ROCK_RED_BLACK_TREE_KEY_UINT64));
+    /* same nodes and order, only the way keys are compared differs */
+    keyed.root = tree.root;
+    keyed.count = tree.count;
+    start = now();
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        seagrass_required_true(!rock_red_black_tree_find(
+                &keyed, NULL, nodes[i], &out[i]));
+    }
+    const double key = now() - start;
+    fprintf(stdout, "nodes: %10ju, find/s: %12.0f, find_batch/s: %12.0f, "
+                    "typed_find/s: %12.0f, keyed_find/s: %12.0f\n",
+            count, PROBES / find, PROBES / batch, PROBES / typed,
+            PROBES / key);
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    for (uintmax_t i = 0; i < count; i++) {
+        free(entries[i]);
+    }
+    free(out);
+    free(nodes);
+    free(needles);
+    free(entries);
+}
+
+static void run_update(const uintmax_t count) {
+    struct entry *const entries = malloc(count * sizeof(*entries));
+    seagrass_required(entries);
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = i;
+    }
+    for (uintmax_t i = count - 1; i > 0; i--) {
+        const uintmax_t j = rand() % (i + 1);
+        const uintmax_t value = entries[i].value;
+        entries[i].value = entries[j].value;
+        entries[j].value = value;
+    }
+    struct rock_red_black_tree tree;
+    seagrass_required_true(!rock_red_black_tree_init(&tree, compare));
+    /* insertions and removals are dominated by rotations and repairs */
+    double start = now();
+    for (uintmax_t i = 0; i < count; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find_or_insert(
+                &tree, &entries[i].node, &out));
+    }
+    const double insert = now() - start;
+    start = now();
+    for (uintmax_t i = 0; i < count; i++) {
+        seagrass_required_true(!rock_red_black_tree_remove(
+                &tree, &entries[i].node));
+    }
+    const double remove = now() - start;
+    fprintf(stdout, "nodes: %10ju, insert/s: %12.0f, remove/s: %12.0f\n",
+            count, count / insert, count / remove);
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    free(entries);
+}
+
+static void run_scan(const uintmax_t count) {
+    struct entry **const entries = malloc(count * sizeof(*entries));
+    seagrass_required(entries);
+    struct rock_red_black_tree tree;
+    seagrass_required_true(!rock_red_black_tree_init(&tree, compare));
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i] = malloc(sizeof(struct entry));
+        seagrass_required(entries[i]);
+    }
+    /* order of the values differs from the order of the addresses */
+    for (uintmax_t i = count - 1; i > 0; i--) {
+        const uintmax_t j = rand() % (i + 1);
+        struct entry *const entry = entries[i];
+        entries[i] = entries[j];
+        entries[j] = entry;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i]->value = i;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find_or_insert(
+                &tree, &entries[i]->node, &out));
+    }
+    const uintmax_t passes = 1 + PROBES / count;
+    uintmax_t sum = 0;
+    double start = now();
+    for (uintmax_t i = 0; i < passes; i++) {
+        struct rock_red_black_tree_node *node;
+        seagrass_required_true(!rock_red_black_tree_first(&tree, &node));
+        do {
+            sum += rock_container_of(node, struct entry, node)->value;
+        } while (!rock_red_black_tree_next(node, &node));
+    }
+    const double next = now() - start;
+    struct rock_red_black_tree_cursor cursor;
+    seagrass_required_true(!rock_red_black_tree_cursor_init(&cursor, &tree));
+    start = now();
+    for (uintmax_t i = 0; i < passes; i++) {
+        struct rock_red_black_tree_node *node;
+        seagrass_required_true(!rock_red_black_tree_cursor_first(&cursor,
+                                                                 &node));
+        do {
+            sum -= rock_container_of(node, struct entry, node)->value;
+        } while (!rock_red_black_tree_cursor_next(&cursor, &node));
+    }
+    const double cursor_next = now() - start;
+    seagrass_required_true(!sum);
+    fprintf(stdout, "nodes: %10ju, next/s: %12.0f, cursor_next/s: %12.0f, "
+                    "speedup: %5.2fx\n",
+            count, passes * count / next, passes * count / cursor_next,
+            next / cursor_next);
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    for (uintmax_t i = 0; i < count; i++) {
+        free(entries[i]);
+    }
+    free(entries);
+}
+
+static void run_append(const uintmax_t count) {
+    struct entry *const entries = malloc(count * sizeof(*entries));
+    seagrass_required(entries);
+    for (uintmax_t i = 0; i < count; i++) {
+        /* mostly increasing keys with the occasional straggler */
+        entries[i].value = 8 * i + (rand() % 8 ? 0 : rand() % 64);
+    }
+    struct rock_red_black_tree tree;
+    seagrass_required_true(!rock_red_black_tree_init_cached(&tree, compare));
+    double start = now();
+    for (uintmax_t i = 0; i < count; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find_or_insert(
+                &tree, &entries[i].node, &out));
+    }
+    const double insert = now() - start;
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    seagrass_required_true(!rock_red_black_tree_init_cached(&tree, compare));
+    start = now();
+    for (uintmax_t i = 0; i < count; i++) {
+        const int error = rock_red_black_tree_append(&tree, &entries[i].node);
+        seagrass_required_true(!error
+                               || ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS
+                                  == error);
+    }
+    const double append = now() - start;
+    fprintf(stdout, "nodes: %10ju, find_or_insert/s: %12.0f, "
+                    "append/s: %12.0f, speedup: %5.2fx\n",
+            count, count / insert, count / append, insert / append);
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    free(entries);
+}
+
+static void run_string(const uintmax_t count) {
+    struct named **const entries = malloc(count * sizeof(*entries));
+    seagrass_required(entries);
+    for (uintmax_t i = 0; i < count; i++) {
+        const uintmax_t j = rand() % (i + 1);
+        entries[i] = entries[j];
+        entries[j] = malloc(sizeof(struct named));
+        seagrass_required(entries[j]);
+        /* keys live in their own allocations as they usually do */
+        char *const key = malloc(24);
+        seagrass_required(key);
+        snprintf(key, 24, "%016jx", (uintmax_t) i * 0x9e3779b97f4a7c15);
+        entries[j]->key = key;
+        seagrass_required_true(!rock_red_black_tree_prefixed_node_init(
+                &entries[j]->node, key));
+    }
+    const ptrdiff_t offset = offsetof(struct named, key)
+                             - offsetof(struct named, node);
+    struct rock_red_black_tree tree;
+    seagrass_required_true(!rock_red_black_tree_init_prefixed(
+            &tree, offset, ROCK_RED_BLACK_TREE_KEY_STRING));
+    for (uintmax_t i = 0; i < count; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find_or_insert(
+                &tree, &entries[i]->node.node, &out));
+    }
+    const struct rock_red_black_tree_node **const nodes
+            = malloc(PROBES * sizeof(*nodes));
+    seagrass_required(nodes);
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        nodes[i] = &entries[rand() % count]->node.node;
+    }
+    struct rock_red_black_tree keyed;
+    seagrass_required_true(!rock_red_black_tree_init_keyed(
+            &keyed, offset, ROCK_RED_BLACK_TREE_KEY_STRING));
+    /* same nodes and order, only the prefixes are ignored */
+    keyed.root = tree.root;
+    keyed.count = tree.count;
+    double start = now();
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find(
+                &keyed, NULL, nodes[i], &out));
+    }
+    const double string = now() - start;
+    start = now();
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find(
+                &tree, NULL, nodes[i], &out));
+    }
+    const double prefixed = now() - start;
+    fprintf(stdout, "nodes: %10ju, string_find/s: %12.0f, "
+                    "prefixed_find/s: %12.0f, speedup: %5.2fx\n",
+            count, PROBES / string, PROBES / prefixed, string / prefixed);
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    for (uintmax_t i = 0; i < count; i++) {
+        free((void *) entries[i]->key);
+        free(entries[i]);
+    }
+    free(nodes);
+    free(entries);
+}
+
+static void on_destroy(struct rock_red_black_tree_node *node) {
+    free(rock_container_of(node, struct entry, node));
+}
+
+static void on_destroy_batch(struct rock_red_black_tree_node **nodes,
+                             const uintmax_t count) {
+    for (uintmax_t i = 0; i < count; i++) {
+        free(rock_container_of(nodes[i], struct entry, node));
+    }
+}
+
+static void build(struct rock_red_black_tree *const tree,
+                  const uintmax_t count) {
+    seagrass_required_true(!rock_red_black_tree_init(tree, compare));
+    for (uintmax_t i = 0; i < count; i++) {
+        struct entry *const entry = malloc(sizeof(*entry));
+        seagrass_required(entry);
+        entry->value = rand();
+        struct rock_red_black_tree_node *out;
+        if (rock_red_black_tree_find_or_insert(tree, &entry->node, &out)
+            || out != &entry->node) {
+            free(entry);
+        }
+    }
+}
+
+static void run_teardown(const uintmax_t count, struct rock_thread_pool *pool) {
+    struct rock_red_black_tree tree;
+    build(&tree, count);
+    uintmax_t nodes = tree.count;
+    double start = now();
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, on_destroy));
+    const double serial = now() - start;
+    build(&tree, count);
+    start = now();
+    seagrass_required_true(!rock_red_black_tree_invalidate_parallel(
+            &tree, on_destroy, pool, 1 << 12, THREADS));
+    const double parallel = now() - start;
+    build(&tree, count);
+    start = now();
+    seagrass_required_true(!rock_red_black_tree_invalidate_batch(
+            &tree, on_destroy_batch, 256, pool, 1 << 12, THREADS));
+    const double batch = now() - start;
+    fprintf(stdout, "nodes: %10ju, invalidate/s: %12.0f, "
+                    "invalidate_parallel/s: %12.0f, "
+                    "invalidate_batch/s: %12.0f, speedup: %5.2fx\n",
+            nodes, nodes / serial, nodes / parallel, nodes / batch,
+            serial / parallel);
+}
+
+static struct rock_red_black_tree_node *move(
+        struct rock_red_black_tree_node *node,
+        const uintmax_t index,
+        void *context) {
+    struct entry *const arena = context;
+    arena[index] = *rock_container_of(node, struct entry, node);
+    return &arena[index].node;
+}
+
+static double probe(const struct rock_red_black_tree *const tree,
+                    const struct rock_red_black_tree_node **const nodes) {
+    const double start = now();
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find(
+                tree, NULL, nodes[i], &out));
+    }
+    return now() - start;
+}
+
+static void run_relocate(const uintmax_t count) {
+    /* entries are allocated one by one so that they scatter in memory */
+    struct entry **const entries = malloc(count * sizeof(*entries));
+    seagrass_required(entries);
+    struct rock_red_black_tree tree;
+    seagrass_required_true(!rock_red_black_tree_init(&tree, compare));
+    for (uintmax_t i = 0; i < count; i++) {
+        const uintmax_t j = rand() % (i + 1);
+        entries[i] = entries[j];
+        entries[j] = malloc(sizeof(struct entry));
+        seagrass_required(entries[j]);
+        entries[j]->value = i;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        struct rock_red_black_tree_node *out;
+        seagrass_required_true(!rock_red_black_tree_find_or_insert(
+                &tree, &entries[i]->node, &out));
+    }
+    struct entry *const needles = malloc(PROBES * sizeof(*needles));
+    seagrass_required(needles);
+    const struct rock_red_black_tree_node **const nodes
+            = malloc(PROBES * sizeof(*nodes));
+    seagrass_required(nodes);
+    for (uintmax_t i = 0; i < PROBES; i++) {
+        needles[i].value = rand() % count;
+        nodes[i] = &needles[i].node;
+    }
+    const double scattered = probe(&tree, nodes);
+    struct entry *const breadth = malloc(count * sizeof(*breadth));
+    seagrass_required(breadth);
+    seagrass_required_true(!rock_red_black_tree_relocate(
+            &tree, ROCK_RED_BLACK_TREE_LAYOUT_BREADTH_FIRST, move, breadth));
+    for (uintmax_t i = 0; i < count; i++) {
+        free(entries[i]);
+    }
+    const double breadth_first = probe(&tree, nodes);
+    struct entry *const veb = malloc(count * sizeof(*veb));
+    seagrass_required(veb);
+    seagrass_required_true(!rock_red_black_tree_relocate(
+            &tree, ROCK_RED_BLACK_TREE_LAYOUT_VAN_EMDE_BOAS, move, veb));
+    free(breadth);
+    const double van_emde_boas = probe(&tree, nodes);
+    fprintf(stdout, "nodes: %10ju, scattered/s: %12.0f, "
+                    "breadth_first/s: %12.0f, van_emde_boas/s: %12.0f, "
+                    "speedup: %5.2fx\n",
+            count, PROBES / scattered, PROBES / breadth_first,
+            PROBES / van_emde_boas, scattered / van_emde_boas);
+    seagrass_required_true(!rock_red_black_tree_invalidate(&tree, NULL));
+    free(veb);
+    free(nodes);
+    free(needles);
+    free(entries);
+}
+
+int main(int argc, char *argv[]) {
+    const uintmax_t limit = argc > 1
+                            ? strtoumax(argv[1], NULL, 10)
+                            : 1 << 24;
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run(i);
+    }
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run_update(i);
+    }
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run_scan(i);
+    }
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run_append(i);
+    }
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run_string(i);
+    }
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run_relocate(i);
+    }
+    struct rock_thread_pool pool;
+    seagrass_required_true(!rock_thread_pool_init(&pool, THREADS));
+    for (uintmax_t i = 1 << 10; i <= limit; i <<= 2) {
+        run_teardown(i, &pool);
+    }
+    seagrass_required_true(!rock_thread_pool_invalidate(&pool));
+    return 0;
+}
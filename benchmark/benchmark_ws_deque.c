@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#define LIMIT       10000000
+
+struct context {
+    struct rock_ws_deque deque;
+    atomic_bool done;
+    atomic_uintmax_t stolen;
+};
+
+static double now(void) {
+    struct timespec ts;
+    seagrass_required_true(!clock_gettime(CLOCK_MONOTONIC, &ts));
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static void *thief(void *arg) {
+    struct context *const context = arg;
+    uintmax_t item, count = 0;
+    while (true) {
+        const bool done = atomic_load(&context->done);
+        if (!rock_ws_deque_steal(&context->deque, &item)) {
+            count++;
+        } else if (done) {
+            break;
+        }
+    }
+    atomic_fetch_add(&context->stolen, count);
+    return NULL;
+}
+
+static void run(const uintmax_t thieves) {
+    struct context context = {};
+    seagrass_required_true(!rock_ws_deque_init(&context.deque,
+                                               sizeof(uintmax_t), 1024));
+    pthread_t threads[thieves ? thieves : 1];
+    const double start = now();
+    for (uintmax_t i = 0; i < thieves; i++) {
+        seagrass_required_true(!pthread_create(&threads[i], NULL, thief,
+                                               &context));
+    }
+    uintmax_t item, popped = 0;
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        seagrass_required_true(!rock_ws_deque_push(&context.deque, &i));
+        if (!(i & 1) && !rock_ws_deque_pop(&context.deque, &item)) {
+            popped++;
+        }
+    }
+    while (!rock_ws_deque_pop(&context.deque, &item)) {
+        popped++;
+    }
+    atomic_store(&context.done, true);
+    for (uintmax_t i = 0; i < thieves; i++) {
+        seagrass_required_true(!pthread_join(threads[i], NULL));
+    }
+    const double elapsed = now() - start;
+    const uintmax_t stolen = atomic_load(&context.stolen);
+    seagrass_required_true(LIMIT == stolen + popped);
+    fprintf(stdout, "thieves: %2ju, elapsed: %8.3fs, popped: %10ju, "
+                    "stolen: %10ju, steals/s: %12.0f\n",
+            thieves, elapsed, popped, stolen, (double) stolen / elapsed);
+    seagrass_required_true(!rock_ws_deque_invalidate(&context.deque, NULL));
+}
+
+int main(int argc, char *argv[]) {
+    const uintmax_t limit = argc > 1 ? strtoumax(argv[1], NULL, 10) : 8;
+    for (uintmax_t i = 0; i <= limit; i = i ? i << 1 : 1) {
+        run(i);
+    }
+    return 0;
+}
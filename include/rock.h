@@ -6,9 +6,16 @@
 #include <stdint.h>
 
 #include <rock/array.h>
+#include <rock/concurrent_array.h>
+#include <rock/epoch.h>
 #include <rock/forward_list.h>
+#include <rock/hazard.h>
+#include <rock/interval_tree.h>
 #include <rock/linked_list.h>
+#include <rock/rcu_array.h>
 #include <rock/red_black_tree.h>
+#include <rock/thread_pool.h>
+#include <rock/ws_deque.h>
 
 /**
  * @brief Return the container of the given pointer.
@@ -0,0 +1,137 @@
+#ifndef _ROCK_CONCURRENT_ARRAY_H_
+#define _ROCK_CONCURRENT_ARRAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <sea-urchin.h>
+
+#define ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_CONCURRENT_ARRAY_ERROR_SIZE_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL \
+    SEA_URCHIN_ERROR_OUT_IS_NULL
+#define ROCK_CONCURRENT_ARRAY_ERROR_ITEM_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS \
+    SEA_URCHIN_ERROR_INDEX_IS_OUT_OF_BOUNDS
+
+#define ROCK_CONCURRENT_ARRAY_SEGMENTS      48
+
+struct rock_concurrent_array_segment;
+
+/* segment k holds (first << k) items, hence items never move once added */
+struct rock_concurrent_array {
+    atomic_uintmax_t claimed;
+    atomic_uintmax_t published;
+    struct rock_concurrent_array_segment *_Atomic
+            segments[ROCK_CONCURRENT_ARRAY_SEGMENTS];
+    uintmax_t first;
+    size_t size;
+};
+
+/**
+ * @brief Initialize concurrent array.
+ * <p>The concurrent array is append only. Any number of threads may
+ * concurrently add items, and any number of threads may concurrently
+ * retrieve items, without ever blocking each other. Storage is made up of
+ * geometrically growing segments so that the address of an item remains
+ * the same for the lifetime of the concurrent array.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of an item in the concurrent array.
+ * @param [in] capacity of the first segment which will be rounded up to the
+ * next power of two.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize the concurrent array instance.
+ */
+int rock_concurrent_array_init(struct rock_concurrent_array *object,
+                               size_t size,
+                               uintmax_t capacity);
+
+/**
+ * @brief Invalidate the concurrent array.
+ * <p>All the items contained within the concurrent array will have the
+ * given <i>on destroy</i> callback invoked upon it. The actual <u>concurrent
+ * array instance is not deallocated</u> since it may have been embedded in
+ * a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @note Must not be invoked while other threads are using the concurrent
+ * array.
+ */
+int rock_concurrent_array_invalidate(struct rock_concurrent_array *object,
+                                     void (*on_destroy)(void *));
+
+/**
+ * @brief Retrieve the size of an item.
+ * @param [in] object concurrent array instance.
+ * @param [out] out receive the size of an item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_concurrent_array_size(const struct rock_concurrent_array *object,
+                               size_t *out);
+
+/**
+ * @brief Retrieve the length.
+ * <p>The length is the number of items that have been published, every
+ * index below it may be retrieved.</p>
+ * @param [in] object concurrent array instance.
+ * @param [out] out receive the length.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_concurrent_array_get_length(
+        const struct rock_concurrent_array *object,
+        uintmax_t *out);
+
+/**
+ * @brief Add an item at the end.
+ * <p>A slot is claimed and the item copied into it, after which the item is
+ * published. Items are published in index order, so an item only becomes
+ * visible once every item before it has been published too.</p>
+ * @param [in] object concurrent array instance.
+ * @param [in] item to be copied into the concurrent array.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to add the item.
+ */
+int rock_concurrent_array_add(struct rock_concurrent_array *object,
+                              const void *item);
+
+/**
+ * @brief Retrieve item at index.
+ * @param [in] object concurrent array instance.
+ * @param [in] at index of item.
+ * @param [out] out receive the address of the item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS if index does
+ * not refer to a published item.
+ * @note Published items must not be modified by the caller.
+ */
+int rock_concurrent_array_get(const struct rock_concurrent_array *object,
+                              uintmax_t at,
+                              const void **out);
+
+#endif /* _ROCK_CONCURRENT_ARRAY_H_ */
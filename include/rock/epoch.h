@@ -0,0 +1,169 @@
+#ifndef _ROCK_EPOCH_H_
+#define _ROCK_EPOCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sea-urchin.h>
+#include <rock/array.h>
+#include <rock/linked_list.h>
+
+#define ROCK_EPOCH_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_EPOCH_ERROR_THRESHOLD_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_EPOCH_ERROR_THREAD_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_EPOCH_ERROR_ITEM_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_EPOCH_ERROR_FUNCTION_IS_NULL \
+    SEA_URCHIN_ERROR_FUNCTION_IS_NULL
+
+#define ROCK_EPOCH_LIMBO        3
+
+struct rock_epoch_thread {
+    atomic_uintmax_t epoch;
+    atomic_bool is_active;
+    uintmax_t nesting;
+    uintmax_t retired;
+    struct rock_array limbo[ROCK_EPOCH_LIMBO];
+    struct rock_linked_list_node node;
+};
+
+struct rock_epoch {
+    atomic_uintmax_t epoch;
+    struct rock_linked_list_node threads;
+    struct rock_array orphans;
+    pthread_mutex_t mutex;
+    uintmax_t threshold;
+};
+
+/**
+ * @brief Initialize epoch based reclamation domain.
+ * <p>Threads that access a concurrent container register with the domain
+ * and wrap each access in a critical section. Memory that has been
+ * unlinked from the container is retired instead of being freed, and it is
+ * only destroyed once every thread that could still be referencing it has
+ * left its critical section.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] threshold number of items a thread retires before it attempts
+ * to reclaim memory.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THRESHOLD_IS_ZERO if threshold is zero.
+ * @throws ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize the domain instance.
+ */
+int rock_epoch_init(struct rock_epoch *object,
+                    uintmax_t threshold);
+
+/**
+ * @brief Invalidate the epoch based reclamation domain.
+ * <p>Items retired by threads that have since unregistered are destroyed.
+ * The actual <u>domain instance is not deallocated</u> since it may have
+ * been embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @note abort(3) is called if there are still registered threads.
+ */
+int rock_epoch_invalidate(struct rock_epoch *object);
+
+/**
+ * @brief Register a thread.
+ * @param [in] object domain instance.
+ * @param [in] thread record of the calling thread to be registered.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to register the thread.
+ */
+int rock_epoch_register(struct rock_epoch *object,
+                        struct rock_epoch_thread *thread);
+
+/**
+ * @brief Unregister a thread.
+ * <p>Retired items that cannot be destroyed yet are handed over to the
+ * domain.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread record to be unregistered.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to hand over the retired items, the thread then
+ * remains registered.
+ * @note abort(3) is called if thread is within a critical section.
+ */
+int rock_epoch_unregister(struct rock_epoch *object,
+                          struct rock_epoch_thread *thread);
+
+/**
+ * @brief Enter a critical section.
+ * <p>Critical sections may be nested.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ */
+int rock_epoch_enter(struct rock_epoch *object,
+                     struct rock_epoch_thread *thread);
+
+/**
+ * @brief Exit a critical section.
+ * <p>References obtained within the outermost critical section must no
+ * longer be used.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @note abort(3) is called if thread is not within a critical section.
+ */
+int rock_epoch_exit(struct rock_epoch *object,
+                    struct rock_epoch_thread *thread);
+
+/**
+ * @brief Retire an item.
+ * <p>The item must already be unreachable for threads that enter a critical
+ * section from now on. It is placed on the limbo list of the calling thread
+ * and <i>on destroy</i> is invoked upon it once it is safe to do so. Every
+ * <i>threshold</i> retired items the thread attempts to advance the epoch
+ * and to destroy its expired items.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @param [in] item to be retired.
+ * @param [in] on_destroy called to destroy the item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_FUNCTION_IS_NULL if on_destroy is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to retire the item, the item then remains owned by
+ * the caller.
+ * @note abort(3) is called if thread is not within a critical section.
+ */
+int rock_epoch_retire(struct rock_epoch *object,
+                      struct rock_epoch_thread *thread,
+                      void *item,
+                      void (*on_destroy)(void *));
+
+/**
+ * @brief Attempt to advance the epoch and destroy expired items.
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_EPOCH_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_EPOCH_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ */
+int rock_epoch_reclaim(struct rock_epoch *object,
+                       struct rock_epoch_thread *thread);
+
+#endif /* _ROCK_EPOCH_H_ */
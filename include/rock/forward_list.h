@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <sea-urchin.h>
+#include <rock/inline.h>
 
 #define ROCK_FORWARD_LIST_ERROR_OBJECT_IS_NULL \
     SEA_URCHIN_ERROR_OBJECT_IS_NULL
@@ -27,6 +28,7 @@ struct rock_forward_list_node {
  * @return On success <i>0</i>, otherwise an error code.
  * @throws ROCK_FORWARD_LIST_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_forward_list_node_init(struct rock_forward_list_node *object);
 
 /**
@@ -37,6 +39,7 @@ int rock_forward_list_node_init(struct rock_forward_list_node *object);
  * @throws ROCK_FORWARD_LIST_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
  * @throws ROCK_FORWARD_LIST_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_forward_list_insert(struct rock_forward_list_node *object,
                              struct rock_forward_list_node *node);
 
@@ -50,6 +53,7 @@ int rock_forward_list_insert(struct rock_forward_list_node *object,
  * @throws ROCK_FORWARD_LIST_ERROR_NODE_NOT_NEXT_OF_OBJECT if node is not
  * next of object.
  */
+ROCK_INLINE_API
 int rock_forward_list_remove(struct rock_forward_list_node *object,
                              struct rock_forward_list_node *node);
 
@@ -63,7 +67,12 @@ int rock_forward_list_remove(struct rock_forward_list_node *object,
  * @throws ROCK_FORWARD_LIST_ERROR_END_OF_SEQUENCE if there are no more next
  * nodes.
  */
+ROCK_INLINE_API
 int rock_forward_list_next(const struct rock_forward_list_node *node,
                            struct rock_forward_list_node **out);
 
+#ifdef ROCK_INLINE
+#include <rock/inline/forward_list.h>
+#endif
+
 #endif /* _ROCK_FORWARD_LIST_H_ */
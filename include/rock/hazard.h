@@ -0,0 +1,188 @@
+#ifndef _ROCK_HAZARD_H_
+#define _ROCK_HAZARD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sea-urchin.h>
+#include <rock/array.h>
+#include <rock/linked_list.h>
+
+#define ROCK_HAZARD_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_HAZARD_ERROR_THRESHOLD_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_HAZARD_ERROR_THREAD_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS \
+    SEA_URCHIN_ERROR_INDEX_IS_OUT_OF_BOUNDS
+#define ROCK_HAZARD_ERROR_SOURCE_IS_NULL \
+    SEA_URCHIN_ERROR_OTHER_IS_NULL
+#define ROCK_HAZARD_ERROR_OUT_IS_NULL \
+    SEA_URCHIN_ERROR_OUT_IS_NULL
+#define ROCK_HAZARD_ERROR_ITEM_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_HAZARD_ERROR_FUNCTION_IS_NULL \
+    SEA_URCHIN_ERROR_FUNCTION_IS_NULL
+
+#define ROCK_HAZARD_SLOTS       4
+
+struct rock_hazard_thread {
+    void *_Atomic slots[ROCK_HAZARD_SLOTS];
+    struct rock_array retired;
+    struct rock_array hazards;
+    uintmax_t watermark;
+    struct rock_linked_list_node node;
+};
+
+struct rock_hazard {
+    struct rock_linked_list_node threads;
+    struct rock_array orphans;
+    pthread_mutex_t mutex;
+    uintmax_t threshold;
+};
+
+/**
+ * @brief Initialize hazard pointer domain.
+ * <p>Threads that access a concurrent container register with the domain
+ * and <i>protect</i> every shared reference in one of their hazard slots
+ * before dereferencing it. Memory that has been unlinked from the container
+ * is retired and only destroyed once no hazard slot refers to it. Unlike
+ * epochs a stalled thread only holds back the items it protects.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] threshold number of retired items a thread accumulates before
+ * it scans the hazard slots.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THRESHOLD_IS_ZERO if threshold is zero.
+ * @throws ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize the domain instance.
+ */
+int rock_hazard_init(struct rock_hazard *object,
+                     uintmax_t threshold);
+
+/**
+ * @brief Invalidate the hazard pointer domain.
+ * <p>Items retired by threads that have since unregistered are destroyed.
+ * The actual <u>domain instance is not deallocated</u> since it may have
+ * been embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @note abort(3) is called if there are still registered threads.
+ */
+int rock_hazard_invalidate(struct rock_hazard *object);
+
+/**
+ * @brief Register a thread.
+ * @param [in] object domain instance.
+ * @param [in] thread record of the calling thread to be registered.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to register the thread.
+ */
+int rock_hazard_register(struct rock_hazard *object,
+                         struct rock_hazard_thread *thread);
+
+/**
+ * @brief Unregister a thread.
+ * <p>The hazard slots of the thread are cleared and retired items that are
+ * still protected by other threads are handed over to the domain.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread record to be unregistered.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to hand over the retired items, the thread then
+ * remains registered.
+ */
+int rock_hazard_unregister(struct rock_hazard *object,
+                           struct rock_hazard_thread *thread);
+
+/**
+ * @brief Protect the reference held in source.
+ * <p>The reference is loaded from source and published in the hazard slot
+ * until source is observed to still hold it, from then on the referenced
+ * item will not be destroyed until the slot is cleared or reused.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @param [in] slot index of the hazard slot to use.
+ * @param [in] source shared location holding the reference.
+ * @param [out] out receive the protected reference, which may be
+ * <i>NULL</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS if slot is not less than
+ * ROCK_HAZARD_SLOTS.
+ * @throws ROCK_HAZARD_ERROR_SOURCE_IS_NULL if source is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_hazard_protect(struct rock_hazard *object,
+                        struct rock_hazard_thread *thread,
+                        uintmax_t slot,
+                        void *_Atomic const *source,
+                        void **out);
+
+/**
+ * @brief Clear the hazard slot.
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @param [in] slot index of the hazard slot to clear.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS if slot is not less than
+ * ROCK_HAZARD_SLOTS.
+ */
+int rock_hazard_clear(struct rock_hazard *object,
+                      struct rock_hazard_thread *thread,
+                      uintmax_t slot);
+
+/**
+ * @brief Retire an item.
+ * <p>The item must already be unreachable from the shared locations. Once
+ * <i>threshold</i> items have been retired by the thread the hazard slots of
+ * all the threads are scanned and <i>on destroy</i> is invoked upon every
+ * retired item that is not protected. Items that are still protected do
+ * not count towards the next scan, which happens once another
+ * <i>threshold</i> items have been retired.</p>
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @param [in] item to be retired.
+ * @param [in] on_destroy called to destroy the item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_FUNCTION_IS_NULL if on_destroy is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to retire the item, the item then remains owned by
+ * the caller.
+ */
+int rock_hazard_retire(struct rock_hazard *object,
+                       struct rock_hazard_thread *thread,
+                       void *item,
+                       void (*on_destroy)(void *));
+
+/**
+ * @brief Scan the hazard slots and destroy unprotected retired items.
+ * @param [in] object domain instance.
+ * @param [in] thread registered record of the calling thread.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_THREAD_IS_NULL if thread is <i>NULL</i>.
+ * @throws ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to gather the hazard slots.
+ */
+int rock_hazard_reclaim(struct rock_hazard *object,
+                        struct rock_hazard_thread *thread);
+
+#endif /* _ROCK_HAZARD_H_ */
@@ -0,0 +1,15 @@
+#ifndef _ROCK_INLINE_H_
+#define _ROCK_INLINE_H_
+
+/*
+ * Defining ROCK_INLINE before including rock turns the small operations
+ * into static inline functions, with the same semantics as those of the
+ * library, so that they can be inlined into the caller.
+ */
+#ifdef ROCK_INLINE
+#define ROCK_INLINE_API static inline
+#else
+#define ROCK_INLINE_API
+#endif
+
+#endif /* _ROCK_INLINE_H_ */
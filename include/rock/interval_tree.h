@@ -0,0 +1,185 @@
+#ifndef _ROCK_INTERVAL_TREE_H_
+#define _ROCK_INTERVAL_TREE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sea-urchin.h>
+#include <rock/red_black_tree.h>
+
+#define ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL \
+    SEA_URCHIN_ERROR_OUT_IS_NULL
+#define ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID \
+    SEA_URCHIN_ERROR_ITEM_IS_OUT_OF_BOUNDS
+#define ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND \
+    SEA_URCHIN_ERROR_VALUE_NOT_FOUND
+#define ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE \
+    SEA_URCHIN_ERROR_END_OF_SEQUENCE
+
+struct rock_interval_tree_node {
+    struct rock_red_black_tree_node node;
+    uintmax_t low;
+    uintmax_t high;
+    /* greatest high within the subtree rooted at this node */
+    uintmax_t max;
+};
+
+/**
+ * @brief Initialize the node instance.
+ * @param [in] node instance to be initialized.
+ * @param [in] low inclusive start of the interval.
+ * @param [in] high inclusive end of the interval.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID if low is greater
+ * than high.
+ */
+int rock_interval_tree_node_init(struct rock_interval_tree_node *node,
+                                 uintmax_t low,
+                                 uintmax_t high);
+
+struct rock_interval_tree {
+    struct rock_red_black_tree tree;
+};
+
+/**
+ * @brief Initialize interval tree instance.
+ * <p>Nodes are ordered by their start, then by their end and finally by
+ * their address, so that equal intervals may be inserted more than once.
+ * Every node of the underlying red black tree is augmented with the greatest
+ * end within its subtree.</p>
+ * @param [in] object instance to be initialized.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+int rock_interval_tree_init(struct rock_interval_tree *object);
+
+/**
+ * @brief Invalidate the interval tree instance.
+ * <p>The nodes in the interval tree are destroyed and each node will have
+ * the provided <i>on destroy</i> callback invoked upon itself. The actual
+ * <u>interval tree instance is not deallocated</u> since it may have been
+ * embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the node is to be destroyed.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+int rock_interval_tree_invalidate(
+        struct rock_interval_tree *object,
+        void (*on_destroy)(struct rock_interval_tree_node *node));
+
+/**
+ * @brief Retrieve the count of intervals in the interval tree.
+ * @param [in] object instance whose count we are to retrieve.
+ * @param [out] out receive the count of the interval tree.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_interval_tree_count(const struct rock_interval_tree *object,
+                             uintmax_t *out);
+
+/**
+ * @brief Insert node into the interval tree.
+ * @param [in] object interval tree instance.
+ * @param [in] node initialized with its interval.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ */
+int rock_interval_tree_insert(struct rock_interval_tree *object,
+                              struct rock_interval_tree_node *node);
+
+/**
+ * @brief Remove node from the interval tree.
+ * @param [in] object interval tree instance.
+ * @param [in] node contained within the interval tree.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ */
+int rock_interval_tree_remove(struct rock_interval_tree *object,
+                              struct rock_interval_tree_node *node);
+
+/**
+ * @brief First interval that overlaps the query.
+ * <p>Subtrees whose greatest end lies before low are skipped, so the
+ * interval with the smallest start that overlaps [low, high] is found in a
+ * single descent.</p>
+ * @param [in] object interval tree instance.
+ * @param [in] low inclusive start of the query.
+ * @param [in] high inclusive end of the query.
+ * @param [out] out receive the first overlapping node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID if low is greater
+ * than high.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND if no interval overlaps.
+ */
+int rock_interval_tree_overlap_first(const struct rock_interval_tree *object,
+                                     uintmax_t low,
+                                     uintmax_t high,
+                                     struct rock_interval_tree_node **out);
+
+/**
+ * @brief Next interval that overlaps the query.
+ * <p>Continues in order from node and only descends into subtrees whose
+ * greatest end reaches low, stopping at the first interval that starts
+ * after high. Each call climbs to the in-order successor before descending
+ * again and ancestors are visited whether or not they overlap, so
+ * enumerating K overlapping intervals takes O(min(n, K log n)) time in the
+ * worst case rather than O(log n + K).</p>
+ * @param [in] node previously retrieved overlapping node.
+ * @param [in] low inclusive start of the query.
+ * @param [in] high inclusive end of the query.
+ * @param [out] out receive the next overlapping node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID if low is greater
+ * than high.
+ * @throws ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE if there are no more
+ * overlapping intervals.
+ */
+int rock_interval_tree_overlap_next(const struct rock_interval_tree_node *node,
+                                    uintmax_t low,
+                                    uintmax_t high,
+                                    struct rock_interval_tree_node **out);
+
+/**
+ * @brief First interval that contains point.
+ * @param [in] object interval tree instance.
+ * @param [in] point to be contained.
+ * @param [out] out receive the first containing node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND if no interval contains
+ * point.
+ */
+int rock_interval_tree_stab_first(const struct rock_interval_tree *object,
+                                  uintmax_t point,
+                                  struct rock_interval_tree_node **out);
+
+/**
+ * @brief Next interval that contains point.
+ * @param [in] node previously retrieved containing node.
+ * @param [in] point to be contained.
+ * @param [out] out receive the next containing node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE if there are no more
+ * containing intervals.
+ */
+int rock_interval_tree_stab_next(const struct rock_interval_tree_node *node,
+                                 uintmax_t point,
+                                 struct rock_interval_tree_node **out);
+
+#endif /* _ROCK_INTERVAL_TREE_H_ */
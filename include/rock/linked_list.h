@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <sea-urchin.h>
+#include <rock/inline.h>
 
 #define ROCK_LINKED_LIST_ERROR_OBJECT_IS_NULL \
     SEA_URCHIN_ERROR_OBJECT_IS_NULL
@@ -24,6 +25,7 @@ struct rock_linked_list_node {
  * @return On success <i>0</i>, otherwise an error code.
  * @throws ROCK_LINKED_LIST_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_linked_list_node_init(struct rock_linked_list_node *object);
 
 /**
@@ -34,6 +36,7 @@ int rock_linked_list_node_init(struct rock_linked_list_node *object);
  * @throws ROCK_LINKED_LIST_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
  * @throws ROCK_LINKED_LIST_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_linked_list_insert_after(struct rock_linked_list_node *object,
                                   struct rock_linked_list_node *node);
 
@@ -45,6 +48,7 @@ int rock_linked_list_insert_after(struct rock_linked_list_node *object,
  * @throws ROCK_LINKED_LIST_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
  * @throws ROCK_LINKED_LIST_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_linked_list_insert_before(struct rock_linked_list_node *object,
                                    struct rock_linked_list_node *node);
 
@@ -54,6 +58,7 @@ int rock_linked_list_insert_before(struct rock_linked_list_node *object,
  * @return On success <i>0</i>, otherwise an error code.
  * @throws ROCK_LINKED_LIST_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_linked_list_remove(struct rock_linked_list_node *object);
 
 /**
@@ -64,6 +69,7 @@ int rock_linked_list_remove(struct rock_linked_list_node *object);
  * @throws ROCK_LINKED_LIST_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
  * @throws ROCK_LINKED_LIST_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_linked_list_next(const struct rock_linked_list_node *node,
                           struct rock_linked_list_node **out);
 
@@ -75,7 +81,12 @@ int rock_linked_list_next(const struct rock_linked_list_node *node,
  * @throws ROCK_LINKED_LIST_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
  * @throws ROCK_LINKED_LIST_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
  */
+ROCK_INLINE_API
 int rock_linked_list_prev(const struct rock_linked_list_node *node,
                           struct rock_linked_list_node **out);
 
+#ifdef ROCK_INLINE
+#include <rock/inline/linked_list.h>
+#endif
+
 #endif /* _ROCK_LINKED_LIST_H_ */
@@ -0,0 +1,181 @@
+#ifndef _ROCK_RCU_ARRAY_H_
+#define _ROCK_RCU_ARRAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sea-urchin.h>
+#include <rock/array.h>
+#include <rock/linked_list.h>
+
+#define ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_RCU_ARRAY_ERROR_SIZE_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL \
+    SEA_URCHIN_ERROR_OUT_IS_NULL
+#define ROCK_RCU_ARRAY_ERROR_READER_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_RCU_ARRAY_ERROR_ARRAY_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+
+struct rock_rcu_array_snapshot;
+
+struct rock_rcu_array_reader {
+    atomic_uintmax_t epoch;
+    struct rock_linked_list_node node;
+};
+
+struct rock_rcu_array {
+    struct rock_rcu_array_snapshot *_Atomic current;
+    atomic_uintmax_t epoch;
+    struct rock_rcu_array_snapshot *retired;
+    struct rock_linked_list_node readers;
+    pthread_mutex_t mutex;
+    size_t size;
+};
+
+/**
+ * @brief Initialize RCU array.
+ * <p>Readers access an immutable snapshot of the array. Writers build a new
+ * copy and publish it in place of the current snapshot, older snapshots are
+ * released once every registered reader has since declared a
+ * <i>quiescent</i> state, that is a point at which it holds no snapshot.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of an item in the array.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize the RCU array instance.
+ */
+int rock_rcu_array_init(struct rock_rcu_array *object,
+                        size_t size);
+
+/**
+ * @brief Invalidate the RCU array.
+ * <p>All the items contained within the current snapshot will have the
+ * given <i>on destroy</i> callback invoked upon it. Retired snapshots are
+ * released without invoking the callback. The actual <u>RCU array instance
+ * is not deallocated</u> since it may have been embedded in a larger
+ * structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @note Must not be invoked while readers are registered or writers are
+ * active.
+ */
+int rock_rcu_array_invalidate(struct rock_rcu_array *object,
+                              void (*on_destroy)(void *));
+
+/**
+ * @brief Retrieve the size of an item.
+ * @param [in] object RCU array instance.
+ * @param [out] out receive the size of an item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_rcu_array_size(const struct rock_rcu_array *object,
+                        size_t *out);
+
+/**
+ * @brief Register a reader.
+ * <p>The reader starts out in a quiescent state.</p>
+ * @param [in] object RCU array instance.
+ * @param [in] reader to be registered.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ */
+int rock_rcu_array_register(struct rock_rcu_array *object,
+                            struct rock_rcu_array_reader *reader);
+
+/**
+ * @brief Unregister a reader.
+ * @param [in] object RCU array instance.
+ * @param [in] reader to be unregistered.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ * @note The reader must not hold a snapshot.
+ */
+int rock_rcu_array_unregister(struct rock_rcu_array *object,
+                              struct rock_rcu_array_reader *reader);
+
+/**
+ * @brief Retrieve the current snapshot.
+ * <p>This is a single load. The snapshot remains valid until the reader
+ * next declares a quiescent state.</p>
+ * @param [in] object RCU array instance.
+ * @param [out] out receive the current snapshot.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @note Only registered readers and writers may retrieve a snapshot, and
+ * it must not be modified.
+ */
+int rock_rcu_array_acquire(const struct rock_rcu_array *object,
+                           const struct rock_array **out);
+
+/**
+ * @brief Declare a quiescent state.
+ * <p>Every snapshot previously retrieved by the reader is given up. This is
+ * a load and a store, readers are expected to call it between requests
+ * rather than around each access.</p>
+ * @param [in] object RCU array instance.
+ * @param [in] reader registered reader.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ */
+int rock_rcu_array_quiescent(const struct rock_rcu_array *object,
+                             struct rock_rcu_array_reader *reader);
+
+/**
+ * @brief Copy the current snapshot.
+ * @param [in] object RCU array instance.
+ * @param [out] out array to be initialized with the items of the current
+ * snapshot.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to copy the snapshot.
+ */
+int rock_rcu_array_copy(struct rock_rcu_array *object,
+                        struct rock_array *out);
+
+/**
+ * @brief Publish array as the current snapshot.
+ * <p>The storage of array is taken over, after which array must not be
+ * used unless it is initialized again. The previous snapshot is retired and
+ * released once its grace period has elapsed.</p>
+ * @param [in] object RCU array instance.
+ * @param [in] array whose items are to be published.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_ARRAY_IS_NULL if array is <i>NULL</i>.
+ * @throws ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to publish the array.
+ * @note abort(3) is called if the item size of array differs.
+ */
+int rock_rcu_array_publish(struct rock_rcu_array *object,
+                           struct rock_array *array);
+
+/**
+ * @brief Wait until every retired snapshot has been released.
+ * @param [in] object RCU array instance.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @note Registered readers must keep on declaring quiescent states for this
+ * call to return.
+ */
+int rock_rcu_array_synchronize(struct rock_rcu_array *object);
+
+#endif /* _ROCK_RCU_ARRAY_H_ */
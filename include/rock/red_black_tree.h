@@ -26,6 +26,62 @@
     SEA_URCHIN_ERROR_VALUE_NOT_FOUND
 #define ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS \
     SEA_URCHIN_ERROR_VALUE_ALREADY_EXISTS
+#define ROCK_RED_BLACK_TREE_ERROR_NODES_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY \
+    SEA_URCHIN_ERROR_VALUE_ALREADY_EXISTS
+#define ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL \
+    SEA_URCHIN_ERROR_OTHER_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_RED_BLACK_TREE_ERROR_INDEX_IS_OUT_OF_BOUNDS \
+    SEA_URCHIN_ERROR_INDEX_IS_OUT_OF_BOUNDS
+#define ROCK_RED_BLACK_TREE_ERROR_LOW_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_HIGH_IS_NULL \
+    SEA_URCHIN_ERROR_OTHER_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_AUGMENT_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL \
+    SEA_URCHIN_ERROR_FUNCTION_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_NEEDLES_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID \
+    SEA_URCHIN_ERROR_ITEM_IS_OUT_OF_BOUNDS
+#define ROCK_RED_BLACK_TREE_ERROR_KEY_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_RED_BLACK_TREE_ERROR_SIZE_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_RED_BLACK_TREE_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_RED_BLACK_TREE_ERROR_LAYOUT_IS_INVALID \
+    SEA_URCHIN_ERROR_ITEM_IS_OUT_OF_BOUNDS
+
+/* compare keys through the compare callback */
+#define ROCK_RED_BLACK_TREE_KEY_CALLBACK        0
+/* uint64_t key */
+#define ROCK_RED_BLACK_TREE_KEY_UINT64          1
+/* int64_t key */
+#define ROCK_RED_BLACK_TREE_KEY_INT64           2
+/* double key which must not be NaN */
+#define ROCK_RED_BLACK_TREE_KEY_DOUBLE          3
+/* const char * key to a NUL-terminated string */
+#define ROCK_RED_BLACK_TREE_KEY_STRING          4
+/* NUL-terminated characters stored in place of the key */
+#define ROCK_RED_BLACK_TREE_KEY_CHARS           5
+
+/* nodes level by level from the root down */
+#define ROCK_RED_BLACK_TREE_LAYOUT_BREADTH_FIRST    0
+/* nodes recursively grouped in subtrees of half the height */
+#define ROCK_RED_BLACK_TREE_LAYOUT_VAN_EMDE_BOAS    1
+
+struct rock_thread_pool;
 
 struct rock_red_black_tree_node {
     /* color bit is stored in the lowest bit */
@@ -42,12 +98,83 @@ struct rock_red_black_tree_node {
  */
 int rock_red_black_tree_node_init(struct rock_red_black_tree_node *node);
 
+struct rock_red_black_tree_sized_node {
+    struct rock_red_black_tree_node node;
+    /* number of nodes in the subtree rooted at this node */
+    uintmax_t size;
+};
+
+struct rock_red_black_tree_prefixed_node {
+    struct rock_red_black_tree_node node;
+    /* leading bytes of the string key, most significant byte first */
+    uint64_t prefix;
+};
+
+/**
+ * @brief Initialize the prefixed node instance.
+ * <p>Up to the first 8 characters of key are stored in the node, so that
+ * comparing prefixes as integers orders nodes as comparing their keys does,
+ * unless the prefixes are equal.</p>
+ * @param [in] node instance to be initialized.
+ * @param [in] key string of the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_KEY_IS_NULL if key is <i>NULL</i>.
+ */
+int rock_red_black_tree_prefixed_node_init(
+        struct rock_red_black_tree_prefixed_node *node,
+        const char *key);
+
+/**
+ * @brief Callbacks to maintain a value aggregated over every subtree.
+ * <p>The value is kept in the structure embedding the node and is computed
+ * from the node itself and the values of its children. The red black tree
+ * invokes the callbacks only along the paths it modifies.</p>
+ */
+struct rock_red_black_tree_augment {
+    /**
+     * @brief Recompute the values from node up towards the root.
+     * @param [in] node first node to recompute.
+     * @param [in] stop ancestor at which to stop without recomputing it, or
+     * <i>NULL</i> to continue up to the root.
+     * @note May return early once a recomputed value is unchanged.
+     */
+    void (*propagate)(struct rock_red_black_tree_node *node,
+                      const struct rock_red_black_tree_node *stop);
+    /**
+     * @brief Copy the value of node into other.
+     * @param [in] node whose place other has taken.
+     * @param [in] other node to receive the value.
+     */
+    void (*copy)(const struct rock_red_black_tree_node *node,
+                 struct rock_red_black_tree_node *other);
+    /**
+     * @brief Update the values after a rotation.
+     * <p>Top has been rotated into the place of node, it receives the value
+     * of node after which the value of node is recomputed.</p>
+     * @param [in] node that has been rotated down.
+     * @param [in] top that has been rotated up.
+     */
+    void (*rotate)(struct rock_red_black_tree_node *node,
+                   struct rock_red_black_tree_node *top);
+};
+
 struct rock_red_black_tree {
     struct rock_red_black_tree_node *root;
     uintmax_t count;
 
     int (*compare)(const struct rock_red_black_tree_node *,
                    const struct rock_red_black_tree_node *);
+    const struct rock_red_black_tree_augment *augment;
+    /* offset of the key from the node and how it is compared */
+    ptrdiff_t key_offset;
+    int key_kind;
+    /* string keys are only compared if the prefixes are equal */
+    bool is_prefixed;
+    /* leftmost and rightmost nodes, only maintained if is_cached */
+    struct rock_red_black_tree_node *leftmost;
+    struct rock_red_black_tree_node *rightmost;
+    bool is_cached;
 };
 
 /**
@@ -66,6 +193,124 @@ int rock_red_black_tree_init(
         int (*compare)(const struct rock_red_black_tree_node *first,
                        const struct rock_red_black_tree_node *second));
 
+/**
+ * @brief Initialise order statistic red black tree instance.
+ * <p>Every node of the red black tree must be the <i>node</i> member of a
+ * {@link rock_red_black_tree_sized_node}. The subtree sizes are maintained
+ * as an augmentation along the paths that are modified, which allows nodes
+ * to be selected by their index and ranked in O(log n).</p>
+ * @param [in] object instance to be initialised.
+ * @param [in] compare comparison which must return an integer less than,
+ * equal to, or greater than zero if the <u>first node</u> is considered
+ * to be respectively less than, equal to, or greater than the <u>second
+ * node</u>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL if compare is <i>NULL</i>.
+ */
+int rock_red_black_tree_init_order_statistic(
+        struct rock_red_black_tree *object,
+        int (*compare)(const struct rock_red_black_tree_node *first,
+                       const struct rock_red_black_tree_node *second));
+
+/**
+ * @brief Initialise augmented red black tree instance.
+ * <p>Whenever nodes are linked, unlinked or rotated the callbacks of augment
+ * are invoked on the affected path, so that custom aggregate queries can be
+ * answered by a single descent.</p>
+ * @param [in] object instance to be initialised.
+ * @param [in] compare comparison which must return an integer less than,
+ * equal to, or greater than zero if the <u>first node</u> is considered
+ * to be respectively less than, equal to, or greater than the <u>second
+ * node</u>.
+ * @param [in] augment callbacks which must outlive the red black tree.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL if compare is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_AUGMENT_IS_NULL if augment is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL if any of the callbacks
+ * of augment is <i>NULL</i>.
+ */
+int rock_red_black_tree_init_augmented(
+        struct rock_red_black_tree *object,
+        int (*compare)(const struct rock_red_black_tree_node *first,
+                       const struct rock_red_black_tree_node *second),
+        const struct rock_red_black_tree_augment *augment);
+
+/**
+ * @brief Initialise red black tree instance keyed by a built-in key kind.
+ * <p>Rather than invoking a compare callback the descents compare the keys
+ * directly, each key being read at key offset from its node.</p>
+ * @param [in] object instance to be initialised.
+ * @param [in] key_offset of the key from the node in bytes, may be negative
+ * if the key precedes the node within the structure embedding them.
+ * @param [in] key_kind one of <i>ROCK_RED_BLACK_TREE_KEY_UINT64</i>,
+ * <i>ROCK_RED_BLACK_TREE_KEY_INT64</i>, <i>ROCK_RED_BLACK_TREE_KEY_DOUBLE</i>,
+ * <i>ROCK_RED_BLACK_TREE_KEY_STRING</i> or
+ * <i>ROCK_RED_BLACK_TREE_KEY_CHARS</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID if key kind is not
+ * one of the built-in key kinds.
+ */
+int rock_red_black_tree_init_keyed(struct rock_red_black_tree *object,
+                                   ptrdiff_t key_offset,
+                                   int key_kind);
+
+/**
+ * @brief Initialise string keyed red black tree instance of prefixed nodes.
+ * <p>Every node of the red black tree must be the <i>node</i> member of a
+ * {@link rock_red_black_tree_prefixed_node}. The descents decide on the
+ * prefixes stored next to the nodes and only read the keys when the
+ * prefixes are equal, which saves a cache miss per level for keys which
+ * differ within their first 8 characters.</p>
+ * @param [in] object instance to be initialised.
+ * @param [in] key_offset of the key from the node in bytes.
+ * @param [in] key_kind either <i>ROCK_RED_BLACK_TREE_KEY_STRING</i> or
+ * <i>ROCK_RED_BLACK_TREE_KEY_CHARS</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID if key kind is not
+ * a string key kind.
+ */
+int rock_red_black_tree_init_prefixed(struct rock_red_black_tree *object,
+                                      ptrdiff_t key_offset,
+                                      int key_kind);
+
+/**
+ * @brief Initialise red black tree instance which caches its extremes.
+ * <p>The leftmost and rightmost nodes are maintained whenever nodes are
+ * linked or unlinked, so that the first and last node are retrieved in O(1)
+ * which suits red black trees used as priority queues.</p>
+ * @param [in] object instance to be initialised.
+ * @param [in] compare comparison which must return an integer less than,
+ * equal to, or greater than zero if the <u>first node</u> is considered
+ * to be respectively less than, equal to, or greater than the <u>second
+ * node</u>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL if compare is <i>NULL</i>.
+ */
+int rock_red_black_tree_init_cached(
+        struct rock_red_black_tree *object,
+        int (*compare)(const struct rock_red_black_tree_node *first,
+                       const struct rock_red_black_tree_node *second));
+
+/**
+ * @brief Set whether red black tree caches its extremes.
+ * <p>Caching composes with every other way of initialising the red black
+ * tree, such as keyed, prefixed, order statistic or augmented red black
+ * trees. Once enabled the leftmost and rightmost nodes are maintained as
+ * by {@link rock_red_black_tree_init_cached}. Enabling it on a red black
+ * tree that already contains nodes finds its extremes in O(log n).</p>
+ * @param [in] object instance of red black tree.
+ * @param [in] is_cached true to cache the extremes, false to stop doing so.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+int rock_red_black_tree_set_cached(struct rock_red_black_tree *object,
+                                   bool is_cached);
+
 /**
  * @brief Invalidate the red black tree instance.
  * <p>The nodes in the red black tree are destroyed and each node will have the
@@ -81,6 +326,65 @@ int rock_red_black_tree_invalidate(
         struct rock_red_black_tree *object,
         void (*on_destroy)(struct rock_red_black_tree_node *node));
 
+/**
+ * @brief Invalidate the red black tree instance using a thread pool.
+ * <p>Same result as {@link rock_red_black_tree_invalidate}, except that the
+ * nodes are left unmodified. The top levels of the tree are split so that
+ * the left subtree is handed to the thread pool while the calling thread
+ * continues with the right subtree, the node itself being destroyed once
+ * both are done. Forking stops once the thread budget is spent or once the
+ * nodes expected below the current depth are no more than grain.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the node is to be destroyed.
+ * @param [in] pool thread pool to run the forked subtrees.
+ * @param [in] grain number of nodes below which no more work is forked.
+ * @param [in] threads maximum number of threads to work on the operation.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL if pool is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO if threads is zero.
+ * @note on_destroy may be called concurrently from several threads.
+ */
+int rock_red_black_tree_invalidate_parallel(
+        struct rock_red_black_tree *object,
+        void (*on_destroy)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *pool,
+        uintmax_t grain,
+        uintmax_t threads);
+
+/**
+ * @brief Invalidate the red black tree instance in batches.
+ * <p>Same as {@link rock_red_black_tree_invalidate_parallel}, except that
+ * every thread collects up to size nodes before handing them over to
+ * <i>on destroy</i> at once, so that releasing them may be amortized.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the nodes are to be destroyed.
+ * @param [in] size greatest number of nodes in a batch.
+ * @param [in] pool thread pool to run the forked subtrees.
+ * @param [in] grain number of nodes below which no more work is forked.
+ * @param [in] threads maximum number of threads to work on the operation.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL if on_destroy is
+ * <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL if pool is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO if threads is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_MEMORY_ALLOCATION_FAILED if there is not
+ * enough memory for the batches, the red black tree is left untouched.
+ * @note on_destroy may be called concurrently from several threads.
+ */
+int rock_red_black_tree_invalidate_batch(
+        struct rock_red_black_tree *object,
+        void (*on_destroy)(struct rock_red_black_tree_node **nodes,
+                           uintmax_t count),
+        uintmax_t size,
+        struct rock_thread_pool *pool,
+        uintmax_t grain,
+        uintmax_t threads);
+
 /**
  * @brief Retrieve the count of items in the red black tree.
  * @param [in] object instance whose count we are to retrieve.
@@ -111,6 +415,189 @@ int rock_red_black_tree_find(const struct rock_red_black_tree *object,
                              const struct rock_red_black_tree_node *needle,
                              struct rock_red_black_tree_node **out);
 
+/**
+ * @brief Find a node in red black tree starting from a nearby node.
+ * <p>Rather than descending from the root the search climbs from hint only
+ * as far as needed to reach a subtree that contains needle and descends from
+ * there, so that the cost is logarithmic in the distance between hint and
+ * needle rather than in the count of the red black tree. Climbing from an
+ * extreme node still reaches the root unless the red black tree caches its
+ * extremes.</p>
+ * @param [in] object instance to be searched.
+ * @param [in] hint node in the red black tree close to needle, or <i>NULL</i>
+ * to search from the root.
+ * @param [in] needle used to find the node.
+ * @param [out] out receive the node or node's insertion point.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND if node was not found.
+ */
+int rock_red_black_tree_find_near(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *hint,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Find many nodes in red black tree.
+ * <p>Several searches descend the red black tree in lock-step, while one of
+ * them compares the others have their next node prefetched, so that the cache
+ * misses of independent searches overlap instead of being taken one after
+ * the other.</p>
+ * @param [in] object instance to be searched.
+ * @param [in] needles array of needles used to find the nodes.
+ * @param [in] count of needles.
+ * @param [out] out array of count entries to receive for each needle the
+ * node or <i>NULL</i> if it was not found.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLES_IS_NULL if needles is
+ * <i>NULL</i> and count is not zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i> and
+ * count is not zero.
+ * @note abort(3) is called if any of the needles is <i>NULL</i>.
+ */
+int rock_red_black_tree_find_batch(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *const *needles,
+        uintmax_t count,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Find the first node not less than needle.
+ * <p>The red black tree is descended once, the first node which is equal to or
+ * greater than needle is retrieved.</p>
+ * @param [in] object instance to be searched.
+ * @param [in] needle used to find the node.
+ * @param [out] out receive the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND if there is no such node.
+ */
+int rock_red_black_tree_lower_bound(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Find the first node greater than needle.
+ * <p>The red black tree is descended once, the first node which is greater than
+ * needle is retrieved.</p>
+ * @param [in] object instance to be searched.
+ * @param [in] needle used to find the node.
+ * @param [out] out receive the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND if there is no such node.
+ */
+int rock_red_black_tree_upper_bound(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Find the last node not greater than needle.
+ * <p>The red black tree is descended once, the last node which is equal to or
+ * less than needle is retrieved.</p>
+ * @param [in] object instance to be searched.
+ * @param [in] needle used to find the node.
+ * @param [out] out receive the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND if there is no such node.
+ */
+int rock_red_black_tree_floor(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Find the first node not less than needle.
+ * <p>The red black tree is descended once, the smallest node which is equal to
+ * or greater than needle is retrieved. This is the counterpart of floor and
+ * behaves like lower bound.</p>
+ * @param [in] object instance to be searched.
+ * @param [in] needle used to find the node.
+ * @param [out] out receive the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND if there is no such node.
+ */
+int rock_red_black_tree_ceiling(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Select the node at index.
+ * <p>Nodes are indexed in order starting from zero.</p>
+ * @param [in] object order statistic red black tree instance.
+ * @param [in] index of the node.
+ * @param [out] out receive the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_INDEX_IS_OUT_OF_BOUNDS if index is not
+ * less than the count.
+ * @note abort(3) is called if object is not an order statistic red black
+ * tree.
+ */
+int rock_red_black_tree_select(const struct rock_red_black_tree *object,
+                               uintmax_t index,
+                               struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Rank of node.
+ * <p>The rank is the number of nodes that are less than node, which is also
+ * the index at which {@link rock_red_black_tree_select} retrieves it.</p>
+ * @param [in] object order statistic red black tree instance.
+ * @param [in] node contained within the red black tree.
+ * @param [out] out receive the rank.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @note abort(3) is called if object is not an order statistic red black
+ * tree.
+ */
+int rock_red_black_tree_rank(const struct rock_red_black_tree *object,
+                             const struct rock_red_black_tree_node *node,
+                             uintmax_t *out);
+
+/**
+ * @brief Count the nodes within a range.
+ * <p>The nodes which are equal to or greater than low and equal to or less
+ * than high are counted by descending the red black tree twice. Neither low
+ * nor high need to be present.</p>
+ * @param [in] object order statistic red black tree instance.
+ * @param [in] low inclusive start of the range.
+ * @param [in] high inclusive end of the range.
+ * @param [out] out receive the count, which is zero if low is greater than
+ * high.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_LOW_IS_NULL if low is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_HIGH_IS_NULL if high is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @note abort(3) is called if object is not an order statistic red black
+ * tree.
+ */
+int rock_red_black_tree_count_range(
+        const struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *low,
+        const struct rock_red_black_tree_node *high,
+        uintmax_t *out);
+
 /**
  * @brief Insert node.
  * @param [in] object instance of red black tree.
@@ -129,6 +616,84 @@ int rock_red_black_tree_insert(
         struct rock_red_black_tree_node *insertion_point,
         struct rock_red_black_tree_node *node);
 
+/**
+ * @brief Find node or insert it.
+ * <p>The red black tree is descended once, if a node equal to the given node
+ * is present it is returned, otherwise the given node is linked in at the
+ * position the descent stopped at and the red black tree is rebalanced.</p>
+ * @param [in] object instance of red black tree.
+ * @param [in] node which is to be inserted if not already present.
+ * @param [out] out receive the existing node or node itself if it was
+ * inserted.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_red_black_tree_find_or_insert(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree_node *node,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Insert node starting the search from a nearby node.
+ * <p>The insertion point is found as by
+ * {@link rock_red_black_tree_find_near}, which suits keys that arrive close
+ * to the previously inserted ones.</p>
+ * @param [in] object instance of red black tree.
+ * @param [in] hint node in the red black tree close to node, or <i>NULL</i>
+ * to search from the root.
+ * @param [in] node which is to be inserted.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS if node with value is
+ * already present in the red black tree instance.
+ */
+int rock_red_black_tree_insert_near(
+        struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *hint,
+        struct rock_red_black_tree_node *node);
+
+/**
+ * @brief Insert node expected to be greater than the last node.
+ * <p>A node greater than the last node is linked in as its right child after
+ * a single comparison, other nodes are inserted as by
+ * {@link rock_red_black_tree_insert_near} starting from the last node.
+ * Finding the last node takes O(log n) unless the red black tree caches its
+ * extremes, in which case it is O(1).</p>
+ * @param [in] object instance of red black tree.
+ * @param [in] node which is to be inserted.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS if node with value is
+ * already present in the red black tree instance.
+ */
+int rock_red_black_tree_append(struct rock_red_black_tree *object,
+                               struct rock_red_black_tree_node *node);
+
+/**
+ * @brief Link node at the position a descent stopped at.
+ * <p>The node is linked in as the left or right child of parent, whichever
+ * was found to be <i>NULL</i>, and the red black tree is rebalanced. This
+ * allows custom descents such as those of
+ * {@link ROCK_RED_BLACK_TREE_DEFINE} to share the rebalancing.</p>
+ * @param [in] object instance of red black tree.
+ * @param [in] parent of node or <i>NULL</i> if the red black tree is empty.
+ * @param [in] node which is to be linked in.
+ * @param [in] is_left true if node is to be the left child of parent.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @note abort(3) is called if parent is <i>NULL</i> while the red black tree
+ * is not empty or if parent already has a child on that side.
+ */
+int rock_red_black_tree_link(struct rock_red_black_tree *object,
+                             struct rock_red_black_tree_node *parent,
+                             struct rock_red_black_tree_node *node,
+                             bool is_left);
+
 /**
  * @brief Remove node.
  * @param [in] object instance of red black tree.
@@ -140,6 +705,240 @@ int rock_red_black_tree_insert(
 int rock_red_black_tree_remove(struct rock_red_black_tree *object,
                                struct rock_red_black_tree_node *node);
 
+/**
+ * @brief Build the red black tree from sorted nodes.
+ * <p>A perfectly balanced red black tree is constructed from the nodes in
+ * linear time without performing any comparisons. Nodes on the deepest level
+ * are colored RED and all the others BLACK.</p>
+ * @param [in] object empty instance of red black tree.
+ * @param [in] nodes array of nodes in ascending order without duplicates.
+ * @param [in] count of nodes.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODES_IS_NULL if nodes is <i>NULL</i>
+ * and count is not zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY if the red black tree
+ * already contains nodes.
+ */
+int rock_red_black_tree_build_sorted(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree_node *const *nodes,
+        uintmax_t count);
+
+/**
+ * @brief Join two red black trees around a node.
+ * <p>All the nodes of object must be less than node and node must be less
+ * than all the nodes of other. The nodes of other and node are relinked
+ * into object without allocating and other is left empty.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] node which is to be placed between both red black trees.
+ * @param [in] other instance whose nodes are moved into object.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL if node is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @note abort(3) is called if the nodes are not in order, if object is
+ * other or if they are not augmented alike.
+ */
+int rock_red_black_tree_join(struct rock_red_black_tree *object,
+                             struct rock_red_black_tree_node *node,
+                             struct rock_red_black_tree *other);
+
+/**
+ * @brief Split the red black tree at needle, in O(n) worst case time unless
+ * it is an order statistic red black tree.
+ * <p>Nodes less than needle remain in object and nodes greater than needle
+ * are moved into other. The node equal to needle, if there is one, is
+ * removed from both. Other takes on the comparison and the augmentation of
+ * object. The counts are established by walking both parts in step
+ * until the smaller one is exhausted, or directly from the subtree sizes of an
+ * order statistic red black tree.</p>
+ * @param [in] object instance of red black tree to be split.
+ * @param [in] needle at which the red black tree is split.
+ * @param [in] other empty instance to receive the greater nodes.
+ * @param [out] out receive the node equal to needle or <i>NULL</i> if there
+ * was none.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY if other contains
+ * nodes.
+ * @note Only an order statistic red black tree is split in O(log n). Any
+ * other red black tree has the smaller part walked node by node to count
+ * it, which is O(n) in the worst case, e.g. n / 2 nodes when splitting in
+ * the middle. Use {@link rock_red_black_tree_init_order_statistic} where
+ * splits must stay logarithmic.
+ */
+int rock_red_black_tree_split(
+        struct rock_red_black_tree *object,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree *other,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Union of two red black trees.
+ * <p>All the nodes of other are relinked into object. Where both contain an
+ * equal node the one in object is kept and the one from other is removed.
+ * Nodes are relinked without allocating by splitting object at every node of
+ * other and joining the results, which is efficient when other is much
+ * smaller than object. Other is left empty.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] other instance whose nodes are consumed.
+ * @param [in] on_remove called for every removed node, may be <i>NULL</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @note abort(3) is called if object is other or if they are not augmented
+ * alike.
+ */
+int rock_red_black_tree_union(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree *other,
+        void (*on_remove)(struct rock_red_black_tree_node *node));
+
+/**
+ * @brief Intersection of two red black trees.
+ * <p>Only the nodes of object which have an equal node in other are kept, all
+ * the other nodes of both red black trees are removed.
+ * Nodes are relinked without allocating by splitting object at every node of
+ * other and joining the results, which is efficient when other is much
+ * smaller than object. Other is left empty.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] other instance whose nodes are consumed.
+ * @param [in] on_remove called for every removed node, may be <i>NULL</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @note abort(3) is called if object is other or if they are not augmented
+ * alike.
+ */
+int rock_red_black_tree_intersection(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree *other,
+        void (*on_remove)(struct rock_red_black_tree_node *node));
+
+/**
+ * @brief Difference of two red black trees.
+ * <p>Only the nodes of object which have no equal node in other are kept, all
+ * the other nodes of both red black trees are removed.
+ * Nodes are relinked without allocating by splitting object at every node of
+ * other and joining the results, which is efficient when other is much
+ * smaller than object. Other is left empty.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] other instance whose nodes are consumed.
+ * @param [in] on_remove called for every removed node, may be <i>NULL</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @note abort(3) is called if object is other or if they are not augmented
+ * alike.
+ */
+int rock_red_black_tree_difference(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree *other,
+        void (*on_remove)(struct rock_red_black_tree_node *node));
+
+/**
+ * @brief Union of two red black trees using a thread pool.
+ * <p>Same result as {@link rock_red_black_tree_union}. After object has
+ * been split at a node of other both halves are independent, so the left
+ * half is handed to the thread pool while the calling thread continues with
+ * the right half. Forking stops once the thread budget is spent or once the
+ * nodes of other expected below the current depth are no more than grain,
+ * the remainder is then computed sequentially.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] other instance whose nodes are consumed.
+ * @param [in] on_remove called for every removed node, may be <i>NULL</i>.
+ * @param [in] pool thread pool to run the forked halves.
+ * @param [in] grain number of nodes of other below which no more work is
+ * forked.
+ * @param [in] threads maximum number of threads to work on the operation.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL if pool is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO if threads is zero.
+ * @note abort(3) is called if object is other.
+ * @note compare and on_remove may be called concurrently from several
+ * threads.
+ */
+int rock_red_black_tree_parallel_union(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree *other,
+        void (*on_remove)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *pool,
+        uintmax_t grain,
+        uintmax_t threads);
+
+/**
+ * @brief Intersection of two red black trees using a thread pool.
+ * <p>Same result as {@link rock_red_black_tree_intersection}. After object has
+ * been split at a node of other both halves are independent, so the left
+ * half is handed to the thread pool while the calling thread continues with
+ * the right half. Forking stops once the thread budget is spent or once the
+ * nodes of other expected below the current depth are no more than grain,
+ * the remainder is then computed sequentially.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] other instance whose nodes are consumed.
+ * @param [in] on_remove called for every removed node, may be <i>NULL</i>.
+ * @param [in] pool thread pool to run the forked halves.
+ * @param [in] grain number of nodes of other below which no more work is
+ * forked.
+ * @param [in] threads maximum number of threads to work on the operation.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL if pool is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO if threads is zero.
+ * @note abort(3) is called if object is other.
+ * @note compare and on_remove may be called concurrently from several
+ * threads.
+ */
+int rock_red_black_tree_parallel_intersection(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree *other,
+        void (*on_remove)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *pool,
+        uintmax_t grain,
+        uintmax_t threads);
+
+/**
+ * @brief Difference of two red black trees using a thread pool.
+ * <p>Same result as {@link rock_red_black_tree_difference}. After object has
+ * been split at a node of other both halves are independent, so the left
+ * half is handed to the thread pool while the calling thread continues with
+ * the right half. Forking stops once the thread budget is spent or once the
+ * nodes of other expected below the current depth are no more than grain,
+ * the remainder is then computed sequentially.</p>
+ * @param [in] object instance of red black tree to receive the result.
+ * @param [in] other instance whose nodes are consumed.
+ * @param [in] on_remove called for every removed node, may be <i>NULL</i>.
+ * @param [in] pool thread pool to run the forked halves.
+ * @param [in] grain number of nodes of other below which no more work is
+ * forked.
+ * @param [in] threads maximum number of threads to work on the operation.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL if other is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL if pool is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO if threads is zero.
+ * @note abort(3) is called if object is other.
+ * @note compare and on_remove may be called concurrently from several
+ * threads.
+ */
+int rock_red_black_tree_parallel_difference(
+        struct rock_red_black_tree *object,
+        struct rock_red_black_tree *other,
+        void (*on_remove)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *pool,
+        uintmax_t grain,
+        uintmax_t threads);
+
 /**
  * @brief First value in the red black tree.
  * @param [in] object instance from which the first value is to be retrieved.
@@ -166,6 +965,32 @@ int rock_red_black_tree_first(const struct rock_red_black_tree *object,
 int rock_red_black_tree_last(const struct rock_red_black_tree *object,
                              struct rock_red_black_tree_node **out);
 
+/**
+ * @brief Remove the first value from the red black tree.
+ * @param [in] object instance from which the first value is to be removed.
+ * @param [out] out receive the removed first value.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY if the red black tree is
+ * empty.
+ */
+int rock_red_black_tree_pop_first(struct rock_red_black_tree *object,
+                                  struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Remove the last value from the red black tree.
+ * @param [in] object instance from which the last value is to be removed.
+ * @param [out] out receive the removed last value.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY if the red black tree is
+ * empty.
+ */
+int rock_red_black_tree_pop_last(struct rock_red_black_tree *object,
+                                 struct rock_red_black_tree_node **out);
+
 /**
  * @brief Retrieve the next node.
  * @param [in] node whose next node we are to retrieve.
@@ -191,4 +1016,271 @@ int rock_red_black_tree_next(const struct rock_red_black_tree_node *node,
 int rock_red_black_tree_prev(const struct rock_red_black_tree_node *node,
                              struct rock_red_black_tree_node **out);
 
+/**
+ * @brief Visit every node in post-order.
+ * <p>Children are visited before their parent. The tree is not modified and
+ * the links of a node are no longer read once it has been visited, hence
+ * function may release the node it was given, in which case the red black
+ * tree must be initialized again before it is used.</p>
+ * @param [in] object red black tree instance.
+ * @param [in] function called for every node.
+ * @param [in] context passed on to function, may be <i>NULL</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL if function is
+ * <i>NULL</i>.
+ */
+int rock_red_black_tree_post_order(
+        const struct rock_red_black_tree *object,
+        void (*function)(struct rock_red_black_tree_node *node,
+                         void *context),
+        void *context);
+
+/**
+ * @brief Relocate every node of the red black tree.
+ * <p>Nodes are handed to move in the order of layout together with their
+ * position in that order, so that move may copy the structure containing
+ * the node into a contiguous arena at that position. Once every node has
+ * been moved the links between the copies are set, hence the tree is
+ * neither rebuilt nor are any nodes compared. A descent then visits nodes
+ * that are close in memory.</p>
+ * @param [in] object red black tree instance.
+ * @param [in] layout order in which nodes are moved.
+ * @param [in] move copy the structure containing node to its new location
+ * and return the node within the copy.
+ * @param [in] context passed on to move, may be <i>NULL</i>.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_LAYOUT_IS_INVALID if layout is not one
+ * of the <i>ROCK_RED_BLACK_TREE_LAYOUT_*</i> values.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL if move is <i>NULL</i>.
+ * @note The former locations of the nodes must remain valid until this
+ * function returns, after which they may be released.
+ * @note abort(3) is called if move returns <i>NULL</i> or node itself.
+ */
+int rock_red_black_tree_relocate(
+        struct rock_red_black_tree *object,
+        int layout,
+        struct rock_red_black_tree_node *(*move)(
+                struct rock_red_black_tree_node *node,
+                uintmax_t index,
+                void *context),
+        void *context);
+
+/* a red black tree of n nodes is at most 2 * log2(n + 1) nodes high */
+#define ROCK_RED_BLACK_TREE_CURSOR_DEPTH        128
+
+struct rock_red_black_tree_cursor {
+    const struct rock_red_black_tree *tree;
+    /* nodes from the root down to the current node */
+    struct rock_red_black_tree_node *path[ROCK_RED_BLACK_TREE_CURSOR_DEPTH];
+    /* whether each node on the path is the left child of the one above */
+    bool is_left[ROCK_RED_BLACK_TREE_CURSOR_DEPTH];
+    uintmax_t depth;
+};
+
+/**
+ * @brief Initialise cursor instance.
+ * <p>The cursor keeps the path from the root down to its current node, so
+ * that stepping to the next or previous node never climbs through the
+ * parents of the nodes, nor reads them again. Stepping is amortized O(1) and
+ * a full scan reads every node once.</p>
+ * @param [in] object instance to be initialised.
+ * @param [in] tree red black tree which is to be traversed.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NULL if tree is <i>NULL</i>.
+ * @note The cursor is invalidated when nodes are added to or removed from
+ * the red black tree, it must be positioned again before being used.
+ */
+int rock_red_black_tree_cursor_init(struct rock_red_black_tree_cursor *object,
+                                    const struct rock_red_black_tree *tree);
+
+/**
+ * @brief Position the cursor at the first node.
+ * @param [in] object cursor instance.
+ * @param [out] out receive the first node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY if the red black tree is
+ * empty.
+ */
+int rock_red_black_tree_cursor_first(struct rock_red_black_tree_cursor *object,
+                                     struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Position the cursor at the last node.
+ * @param [in] object cursor instance.
+ * @param [out] out receive the last node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY if the red black tree is
+ * empty.
+ */
+int rock_red_black_tree_cursor_last(struct rock_red_black_tree_cursor *object,
+                                    struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Position the cursor at the first node not less than needle.
+ * @param [in] object cursor instance.
+ * @param [in] needle used to find the node.
+ * @param [out] out receive the node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL if needle is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND if there is no such node,
+ * the cursor is then no longer positioned.
+ */
+int rock_red_black_tree_cursor_seek(
+        struct rock_red_black_tree_cursor *object,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Move the cursor to the next node.
+ * @param [in] object cursor instance.
+ * @param [out] out receive the next node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE if there is no next node
+ * or the cursor is not positioned, the cursor is then left unchanged.
+ */
+int rock_red_black_tree_cursor_next(struct rock_red_black_tree_cursor *object,
+                                    struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Move the cursor to the previous node.
+ * @param [in] object cursor instance.
+ * @param [out] out receive the previous node.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE if there is no previous
+ * node or the cursor is not positioned, the cursor is then left unchanged.
+ */
+int rock_red_black_tree_cursor_prev(struct rock_red_black_tree_cursor *object,
+                                    struct rock_red_black_tree_node **out);
+
+/**
+ * @brief Define red black tree functions specialised for type.
+ * <p>Emits static inline functions prefixed with name whose descents invoke
+ * cmp directly, so that it may be inlined, and read the children of the
+ * nodes without calling the getters. Linking and rebalancing is shared
+ * through {@link rock_red_black_tree_link} and the red black tree remains a
+ * regular instance upon which every other function may be used.</p>
+ * <ul>
+ * <li><i>name_init(object)</i></li>
+ * <li><i>name_find(object, needle, out)</i></li>
+ * <li><i>name_lower_bound(object, needle, out)</i></li>
+ * <li><i>name_insert(object, item)</i></li>
+ * </ul>
+ * <p>They return the same errors as their generic counterparts.</p>
+ * @param [in] name prefix of the emitted functions.
+ * @param [in] type of the structure which embeds the node.
+ * @param [in] member name of the node within type.
+ * @param [in] cmp function or macro comparing two <i>const type *</i> which
+ * must return an integer less than, equal to, or greater than zero if the
+ * <u>first</u> is considered to be respectively less than, equal to, or
+ * greater than the <u>second</u>.
+ */
+#define ROCK_RED_BLACK_TREE_DEFINE(name, type, member, cmp)                   \
+static inline type *name##_entry(                                             \
+        const struct rock_red_black_tree_node *const node) {                  \
+    return (type *) ((char *) node - offsetof(type, member));                 \
+}                                                                             \
+                                                                              \
+static inline int name##_compare(                                             \
+        const struct rock_red_black_tree_node *const first,                   \
+        const struct rock_red_black_tree_node *const second) {                \
+    return cmp(name##_entry(first), name##_entry(second));                    \
+}                                                                             \
+                                                                              \
+static inline int name##_init(struct rock_red_black_tree *const object) {     \
+    return rock_red_black_tree_init(object, name##_compare);                  \
+}                                                                             \
+                                                                              \
+static inline int name##_find(const struct rock_red_black_tree *const object, \
+                              const type *const needle,                       \
+                              type **const out) {                             \
+    if (!object) {                                                            \
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;                      \
+    }                                                                         \
+    if (!needle) {                                                            \
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;                      \
+    }                                                                         \
+    if (!out) {                                                               \
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;                         \
+    }                                                                         \
+    for (const struct rock_red_black_tree_node *node = object->root; node;) { \
+        type *const entry = name##_entry(node);                               \
+        const int result = cmp(needle, entry);                                \
+        if (!result) {                                                        \
+            *out = entry;                                                     \
+            return 0;                                                         \
+        }                                                                     \
+        node = result < 0 ? node->left : node->right;                         \
+    }                                                                         \
+    return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;                          \
+}                                                                             \
+                                                                              \
+static inline int name##_lower_bound(                                         \
+        const struct rock_red_black_tree *const object,                       \
+        const type *const needle,                                             \
+        type **const out) {                                                   \
+    if (!object) {                                                            \
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;                      \
+    }                                                                         \
+    if (!needle) {                                                            \
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;                      \
+    }                                                                         \
+    if (!out) {                                                               \
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;                         \
+    }                                                                         \
+    type *bound = NULL;                                                       \
+    for (const struct rock_red_black_tree_node *node = object->root; node;) { \
+        type *const entry = name##_entry(node);                               \
+        const int result = cmp(needle, entry);                                \
+        if (result > 0) {                                                     \
+            node = node->right;                                               \
+            continue;                                                         \
+        }                                                                     \
+        bound = entry;                                                        \
+        if (!result) { /* keys are unique */                                  \
+            break;                                                            \
+        }                                                                     \
+        node = node->left;                                                    \
+    }                                                                         \
+    if (!bound) {                                                             \
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;                      \
+    }                                                                         \
+    *out = bound;                                                             \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+static inline int name##_insert(struct rock_red_black_tree *const object,     \
+                                type *const item) {                           \
+    if (!object) {                                                            \
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;                      \
+    }                                                                         \
+    if (!item) {                                                              \
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;                        \
+    }                                                                         \
+    struct rock_red_black_tree_node *parent = NULL;                           \
+    bool is_left = false;                                                     \
+    for (struct rock_red_black_tree_node *node = object->root; node;) {       \
+        parent = node;                                                        \
+        const int result = cmp(item, name##_entry(node));                     \
+        if (!result) {                                                        \
+            return ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS;             \
+        }                                                                     \
+        is_left = result < 0;                                                 \
+        node = is_left ? node->left : node->right;                            \
+    }                                                                         \
+    return rock_red_black_tree_link(object, parent, &item->member, is_left);  \
+}
+
 #endif /* _ROCK_RED_BLACK_TREE_H_ */
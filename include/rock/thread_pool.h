@@ -0,0 +1,168 @@
+#ifndef _ROCK_THREAD_POOL_H_
+#define _ROCK_THREAD_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sea-urchin.h>
+#include <rock/array.h>
+
+#define ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_THREAD_POOL_ERROR_COUNT_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_THREAD_POOL_ERROR_OUT_IS_NULL \
+    SEA_URCHIN_ERROR_OUT_IS_NULL
+#define ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL \
+    SEA_URCHIN_ERROR_VALUE_IS_NULL
+#define ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL \
+    SEA_URCHIN_ERROR_FUNCTION_IS_NULL
+#define ROCK_THREAD_POOL_ERROR_SIZE_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_THREAD_POOL_ERROR_IDENTITY_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+
+struct rock_thread_pool_worker;
+
+struct rock_thread_pool {
+    struct rock_thread_pool_worker *workers;
+    uintmax_t count;
+    struct rock_array queue;
+    uintmax_t head;
+    atomic_uintmax_t pending;
+    atomic_uintmax_t sleeping;
+    atomic_bool is_shutdown;
+    pthread_mutex_t mutex;
+    pthread_cond_t available;
+    pthread_cond_t completed;
+};
+
+/**
+ * @brief Initialize thread pool.
+ * <p>Each worker owns a work-stealing deque onto which it pushes the tasks it
+ * forks, idle workers steal from the other workers' deques and tasks
+ * submitted from threads outside the thread pool are placed on a shared
+ * queue.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] count number of worker threads.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_COUNT_IS_ZERO if count is zero.
+ * @throws ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory or resources to start the worker threads.
+ */
+int rock_thread_pool_init(struct rock_thread_pool *object,
+                          uintmax_t count);
+
+/**
+ * @brief Invalidate the thread pool.
+ * <p>The worker threads are stopped and joined. The actual <u>thread pool
+ * instance is not deallocated</u> since it may have been embedded in a
+ * larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @note Must not be invoked while a parallel operation is in progress or
+ * from within a worker thread.
+ */
+int rock_thread_pool_invalidate(struct rock_thread_pool *object);
+
+/**
+ * @brief Retrieve the count of worker threads.
+ * @param [in] object thread pool instance.
+ * @param [out] out receive the number of worker threads.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_thread_pool_count(const struct rock_thread_pool *object,
+                           uintmax_t *out);
+
+/**
+ * @brief Invoke function over all the items of the array in parallel.
+ * <p>The index range of the array is recursively halved, with one half
+ * made available to be stolen, until a range holds at most <i>grain</i>
+ * items upon which the function is then invoked. This call returns once
+ * the function has been invoked over every item. It may be invoked from
+ * within a worker thread, in which case the worker executes other tasks
+ * while waiting.</p>
+ * @param [in] object thread pool instance.
+ * @param [in] array whose items are to be processed.
+ * @param [in] grain the maximum number of items in a range.
+ * @param [in] function invoked with a range <i>[begin, end)</i> of
+ * indexes within the array.
+ * @param [in] context passed through to function.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL if array is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL if function is
+ * <i>NULL</i>.
+ * @note The array must not be modified until this call returns.
+ */
+int rock_thread_pool_parallel_for(
+        struct rock_thread_pool *object,
+        const struct rock_array *array,
+        uintmax_t grain,
+        void (*function)(const struct rock_array *array,
+                         uintmax_t begin,
+                         uintmax_t end,
+                         void *context),
+        void *context);
+
+/**
+ * @brief Reduce all the items of the array in parallel.
+ * <p>Every worker keeps its own accumulator, of <i>size</i> bytes,
+ * initialized with a copy of <i>identity</i>. Ranges of at most
+ * <i>grain</i> items are folded into the accumulator of the worker that
+ * executes them and once all the items have been processed the accumulators
+ * are combined into <i>out</i>. As ranges are not folded in index order
+ * both fold and combine must be associative and commutative.</p>
+ * @param [in] object thread pool instance.
+ * @param [in] array whose items are to be reduced.
+ * @param [in] grain the maximum number of items in a range.
+ * @param [in] size of an accumulator.
+ * @param [in] identity initial value of every accumulator.
+ * @param [in] fold invoked to accumulate the range <i>[begin, end)</i> of
+ * indexes within the array into accumulator.
+ * @param [in] combine invoked to accumulate other into accumulator.
+ * @param [in] context passed through to fold and combine.
+ * @param [out] out receive the reduced value, of <i>size</i> bytes.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL if array is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO if grain is zero.
+ * @throws ROCK_THREAD_POOL_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws ROCK_THREAD_POOL_ERROR_IDENTITY_IS_NULL if identity is
+ * <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL if fold or combine is
+ * <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory for the accumulators.
+ * @note The array must not be modified until this call returns.
+ */
+int rock_thread_pool_parallel_reduce(
+        struct rock_thread_pool *object,
+        const struct rock_array *array,
+        uintmax_t grain,
+        size_t size,
+        const void *identity,
+        void (*fold)(void *accumulator,
+                     const struct rock_array *array,
+                     uintmax_t begin,
+                     uintmax_t end,
+                     void *context),
+        void (*combine)(void *accumulator,
+                        const void *other,
+                        void *context),
+        void *context,
+        void *out);
+
+#endif /* _ROCK_THREAD_POOL_H_ */
@@ -0,0 +1,146 @@
+#ifndef _ROCK_WS_DEQUE_H_
+#define _ROCK_WS_DEQUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <sea-urchin.h>
+
+#define ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL \
+    SEA_URCHIN_ERROR_OBJECT_IS_NULL
+#define ROCK_WS_DEQUE_ERROR_SIZE_IS_ZERO \
+    SEA_URCHIN_ERROR_VALUE_IS_ZERO
+#define ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED \
+    SEA_URCHIN_ERROR_MEMORY_ALLOCATION_FAILED
+#define ROCK_WS_DEQUE_ERROR_OUT_IS_NULL \
+    SEA_URCHIN_ERROR_OUT_IS_NULL
+#define ROCK_WS_DEQUE_ERROR_ITEM_IS_NULL \
+    SEA_URCHIN_ERROR_ITEM_IS_NULL
+#define ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY \
+    SEA_URCHIN_ERROR_IS_EMPTY
+
+struct rock_ws_deque_buffer;
+
+/* top and bottom are kept on separate cache lines as thieves contend on the
+ * former while the owner continuously updates the latter */
+struct rock_ws_deque {
+    atomic_intmax_t top;
+    unsigned char padding_top[64 - sizeof(atomic_intmax_t)];
+    atomic_intmax_t bottom;
+    unsigned char padding_bottom[64 - sizeof(atomic_intmax_t)];
+    struct rock_ws_deque_buffer *_Atomic buffer;
+    struct rock_ws_deque_buffer *retired;
+    size_t size;
+};
+
+/**
+ * @brief Initialize work-stealing deque.
+ * <p>The work-stealing deque has a single owner thread which may
+ * <i>push</i> and <i>pop</i> items at the bottom, while any number of other
+ * threads may concurrently <i>steal</i> items from the top.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of an item in the work-stealing deque.
+ * @param [in] capacity set the initial capacity which will be rounded up to
+ * the next power of two.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize the work-stealing deque instance.
+ */
+int rock_ws_deque_init(struct rock_ws_deque *object,
+                       size_t size,
+                       uintmax_t capacity);
+
+/**
+ * @brief Invalidate the work-stealing deque.
+ * <p>All the items contained within the work-stealing deque will have the
+ * given <i>on destroy</i> callback invoked upon it. Buffers that were retired
+ * while growing are released as well. The actual <u>work-stealing deque
+ * instance is not deallocated</u> since it may have been embedded in a larger
+ * structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @note Must only be invoked once no other thread accesses the instance.
+ */
+int rock_ws_deque_invalidate(struct rock_ws_deque *object,
+                             void (*on_destroy)(void *));
+
+/**
+ * @brief Retrieve the size of an item.
+ * @param [in] object work-stealing deque instance.
+ * @param [out] out receive the size of an item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+int rock_ws_deque_size(const struct rock_ws_deque *object,
+                       size_t *out);
+
+/**
+ * @brief Retrieve the count of items.
+ * @param [in] object work-stealing deque instance.
+ * @param [out] out receive the number of items.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @note The count is only a snapshot when other threads are stealing.
+ */
+int rock_ws_deque_count(const struct rock_ws_deque *object,
+                        uintmax_t *out);
+
+/**
+ * @brief Add an item at the bottom.
+ * <p>If there is no free capacity the items are copied into a buffer of
+ * twice the capacity and the previous buffer is retired until the instance is
+ * invalidated, since thieves may still be reading from it. The retired
+ * buffers together are always smaller than the buffer in use.</p>
+ * @param [in] object work-stealing deque instance.
+ * @param [in] item whose <u>pointed to contents</u> will be copied into the
+ * work-stealing deque.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if there is not
+ * enough memory to add another item.
+ * @note Must only be invoked by the owner thread.
+ */
+int rock_ws_deque_push(struct rock_ws_deque *object,
+                       const void *item);
+
+/**
+ * @brief Remove the item at the bottom.
+ * @param [in] object work-stealing deque instance.
+ * @param [out] out receive a copy of the most recently pushed item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY if the work-stealing deque is
+ * empty or the last item was stolen concurrently.
+ * @note Must only be invoked by the owner thread.
+ */
+int rock_ws_deque_pop(struct rock_ws_deque *object,
+                      void *out);
+
+/**
+ * @brief Remove the item at the top.
+ * <p>Thieves compete with each other and with the owner using a
+ * compare-and-swap on the top index. A thief that loses the race retries
+ * for as long as there are items left.</p>
+ * @param [in] object work-stealing deque instance.
+ * @param [out] out receive a copy of the least recently pushed item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY if the work-stealing deque is
+ * empty.
+ * @note May be invoked by any thread.
+ * @note The contents of out are unspecified if an error is returned.
+ */
+int rock_ws_deque_steal(struct rock_ws_deque *object,
+                        void *out);
+
+#endif /* _ROCK_WS_DEQUE_H_ */
@@ -228,6 +228,8 @@ int rock_array_remove_last(struct rock_array *const object) {
     return 0;
 }
 
+#if !defined(ROCK_UNCHECKED) || defined(TEST)
+
 void *rock_array_address(const struct rock_array *const object,
                          const uintmax_t at) {
     seagrass_required(object);
@@ -235,6 +237,8 @@ void *rock_array_address(const struct rock_array *const object,
     return ((unsigned char *) object->data) + (object->size * at);
 }
 
+#endif
+
 int rock_array_insert(struct rock_array *const object,
                       const uintmax_t at,
                       const void *const item) {
@@ -0,0 +1,289 @@
+#include <stdlib.h>
+#include <string.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/concurrent_array.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+int rock_concurrent_array_segment_of(
+        const size_t size,
+        const uintmax_t capacity,
+        struct rock_concurrent_array_segment **const out) {
+    seagrass_required(out);
+    seagrass_required_true(size > 0);
+    seagrass_required_true(capacity > 0);
+    int error;
+    uintmax_t length;
+    if ((error = seagrass_uintmax_t_add(size, sizeof(atomic_bool), &length))
+        || (error = seagrass_uintmax_t_multiply(length, capacity, &length))
+        || (error = seagrass_uintmax_t_add(
+            sizeof(struct rock_concurrent_array_segment), length, &length))
+        || length > SIZE_MAX) {
+        seagrass_required_true(
+                !error
+                || SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT
+                   == error);
+        return ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    struct rock_concurrent_array_segment *const segment = malloc(length);
+    if (!segment) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    segment->capacity = capacity;
+    for (uintmax_t i = 0; i < capacity; i++) {
+        atomic_init(rock_concurrent_array_segment_ready(segment, size, i),
+                    false);
+    }
+    *out = segment;
+    return 0;
+}
+
+atomic_bool *rock_concurrent_array_segment_ready(
+        const struct rock_concurrent_array_segment *const segment,
+        const size_t size,
+        const uintmax_t at) {
+    seagrass_required(segment);
+    seagrass_required_true(at < segment->capacity);
+    unsigned char *const flags = ((unsigned char *) segment->data)
+                                 + (size * segment->capacity);
+    return ((atomic_bool *) flags) + at;
+}
+
+int rock_concurrent_array_locate(
+        const struct rock_concurrent_array *const object,
+        const uintmax_t at,
+        uintmax_t *const segment,
+        uintmax_t *const offset) {
+    seagrass_required(object);
+    seagrass_required(segment);
+    seagrass_required(offset);
+    seagrass_required_true(sizeof(uintmax_t)
+                           == sizeof(unsigned long long));
+    uintmax_t index;
+    int error;
+    if ((error = seagrass_uintmax_t_add(at, object->first, &index))) {
+        seagrass_required_true(
+                SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT
+                == error);
+        return ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+    }
+    /* segment k covers [first << k, first << (k + 1)) of index */
+    const uintmax_t msb = 63 - __builtin_clzll(index);
+    const uintmax_t shift = __builtin_ctzll(object->first);
+    if (msb - shift >= ROCK_CONCURRENT_ARRAY_SEGMENTS) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+    }
+    *segment = msb - shift;
+    *offset = index - ((uintmax_t) 1 << msb);
+    return 0;
+}
+
+int rock_concurrent_array_segment(
+        struct rock_concurrent_array *const object,
+        const uintmax_t at,
+        struct rock_concurrent_array_segment **const out) {
+    seagrass_required(object);
+    seagrass_required(out);
+    seagrass_required_true(at < ROCK_CONCURRENT_ARRAY_SEGMENTS);
+    struct rock_concurrent_array_segment *segment = atomic_load_explicit(
+            &object->segments[at], memory_order_acquire);
+    if (segment) {
+        *out = segment;
+        return 0;
+    }
+    int error;
+    struct rock_concurrent_array_segment *allocated;
+    if ((error = rock_concurrent_array_segment_of(
+            object->size, object->first << at, &allocated))) {
+        seagrass_required_true(
+                ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                == error);
+        return error;
+    }
+    /* another writer may have installed the segment first */
+    if (!atomic_compare_exchange_strong_explicit(
+            &object->segments[at], &segment, allocated,
+            memory_order_acq_rel, memory_order_acquire)) {
+        free(allocated);
+        *out = segment;
+        return 0;
+    }
+    *out = allocated;
+    return 0;
+}
+
+void rock_concurrent_array_publish(struct rock_concurrent_array *const object) {
+    seagrass_required(object);
+    uintmax_t at = atomic_load(&object->published);
+    while (at < atomic_load(&object->claimed)) {
+        uintmax_t segment, offset;
+        seagrass_required_true(!rock_concurrent_array_locate(
+                object, at, &segment, &offset));
+        const struct rock_concurrent_array_segment *const s
+                = atomic_load(&object->segments[segment]);
+        seagrass_required(s);
+        if (!atomic_load(rock_concurrent_array_segment_ready(
+                s, object->size, offset))) {
+            break; /* the writer of this slot will carry on from here */
+        }
+        if (atomic_compare_exchange_strong(&object->published, &at,
+                                           1 + at)) {
+            at++;
+        }
+    }
+}
+
+int rock_concurrent_array_init(struct rock_concurrent_array *const object,
+                               const size_t size,
+                               const uintmax_t capacity) {
+    if (!object) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!size) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_SIZE_IS_ZERO;
+    }
+    int error;
+    uintmax_t first = 1;
+    while (first < capacity) {
+        if ((error = seagrass_uintmax_t_multiply(2, first, &first))) {
+            seagrass_required_true(
+                    SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT
+                    == error);
+            return ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+    }
+    struct rock_concurrent_array_segment *segment;
+    if ((error = rock_concurrent_array_segment_of(size, first, &segment))) {
+        seagrass_required_true(
+                ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                == error);
+        return error;
+    }
+    atomic_init(&object->claimed, 0);
+    atomic_init(&object->published, 0);
+    atomic_init(&object->segments[0], segment);
+    for (uintmax_t i = 1; i < ROCK_CONCURRENT_ARRAY_SEGMENTS; i++) {
+        atomic_init(&object->segments[i], NULL);
+    }
+    object->first = first;
+    object->size = size;
+    return 0;
+}
+
+int rock_concurrent_array_invalidate(
+        struct rock_concurrent_array *const object,
+        void (*const on_destroy)(void *)) {
+    if (!object) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (on_destroy) {
+        const uintmax_t length = atomic_load(&object->published);
+        for (uintmax_t i = 0; i < length; i++) {
+            void *item;
+            seagrass_required_true(!rock_concurrent_array_get(
+                    object, i, (const void **) &item));
+            on_destroy(item);
+        }
+    }
+    for (uintmax_t i = 0; i < ROCK_CONCURRENT_ARRAY_SEGMENTS; i++) {
+        free(atomic_load(&object->segments[i]));
+        atomic_init(&object->segments[i], NULL);
+    }
+    atomic_init(&object->claimed, 0);
+    atomic_init(&object->published, 0);
+    object->first = 0;
+    object->size = 0;
+    return 0;
+}
+
+int rock_concurrent_array_size(const struct rock_concurrent_array *const object,
+                               size_t *const out) {
+    if (!object) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL;
+    }
+    *out = object->size;
+    return 0;
+}
+
+int rock_concurrent_array_get_length(
+        const struct rock_concurrent_array *const object,
+        uintmax_t *const out) {
+    if (!object) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL;
+    }
+    struct rock_concurrent_array *const array
+            = (struct rock_concurrent_array *) object;
+    *out = atomic_load_explicit(&array->published, memory_order_acquire);
+    return 0;
+}
+
+int rock_concurrent_array_add(struct rock_concurrent_array *const object,
+                              const void *const item) {
+    if (!object) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!item) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_ITEM_IS_NULL;
+    }
+    int error;
+    uintmax_t at = atomic_load(&object->claimed);
+    uintmax_t segment, offset;
+    struct rock_concurrent_array_segment *s;
+    /* segment is ensured before the slot is claimed so that a failed
+     * allocation never leaves a hole that would stall publishing */
+    do {
+        if ((error = rock_concurrent_array_locate(
+                object, at, &segment, &offset))) {
+            seagrass_required_true(
+                    ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS
+                    == error);
+            return ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+        if ((error = rock_concurrent_array_segment(object, segment, &s))) {
+            seagrass_required_true(
+                    ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                    == error);
+            return error;
+        }
+    } while (!atomic_compare_exchange_weak(&object->claimed, &at, 1 + at));
+    memcpy(s->data + (object->size * offset), item, object->size);
+    atomic_store(rock_concurrent_array_segment_ready(s, object->size, offset),
+                 true);
+    rock_concurrent_array_publish(object);
+    return 0;
+}
+
+int rock_concurrent_array_get(const struct rock_concurrent_array *const object,
+                              const uintmax_t at,
+                              const void **const out) {
+    if (!object) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL;
+    }
+    struct rock_concurrent_array *const array
+            = (struct rock_concurrent_array *) object;
+    if (at >= atomic_load_explicit(&array->published, memory_order_acquire)) {
+        return ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+    }
+    uintmax_t segment, offset;
+    seagrass_required_true(!rock_concurrent_array_locate(
+            object, at, &segment, &offset));
+    const struct rock_concurrent_array_segment *const s
+            = atomic_load_explicit(&array->segments[segment],
+                                   memory_order_acquire);
+    seagrass_required(s);
+    *out = s->data + (object->size * offset);
+    return 0;
+}
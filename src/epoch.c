@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/epoch.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+int rock_epoch_init(struct rock_epoch *const object,
+                    const uintmax_t threshold) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!threshold) {
+        return ROCK_EPOCH_ERROR_THRESHOLD_IS_ZERO;
+    }
+    int error;
+    if ((error = rock_array_init(&object->orphans,
+                                 sizeof(struct rock_epoch_item),
+                                 0))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    atomic_init(&object->epoch, 0);
+    seagrass_required_true(!rock_linked_list_node_init(&object->threads));
+    seagrass_required_true(!pthread_mutex_init(&object->mutex, NULL));
+    object->threshold = threshold;
+    return 0;
+}
+
+int rock_epoch_invalidate(struct rock_epoch *const object) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    seagrass_required_true(object->threads.next == &object->threads);
+    rock_epoch_destroy(&object->orphans, UINTMAX_MAX);
+    seagrass_required_true(!rock_array_invalidate(&object->orphans, NULL));
+    seagrass_required_true(!pthread_mutex_destroy(&object->mutex));
+    atomic_init(&object->epoch, 0);
+    object->threshold = 0;
+    return 0;
+}
+
+void rock_epoch_destroy(struct rock_array *const array,
+                        const uintmax_t epoch) {
+    seagrass_required(array);
+    struct rock_epoch_item *const items = array->data;
+    uintmax_t kept = 0;
+    for (uintmax_t i = 0; i < array->length; i++) {
+        if (items[i].epoch <= epoch) {
+            items[i].on_destroy(items[i].item);
+        } else {
+            items[kept++] = items[i];
+        }
+    }
+    seagrass_required_true(!rock_array_set_length(array, kept));
+}
+
+bool rock_epoch_advance(struct rock_epoch *const object) {
+    seagrass_required(object);
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    const uintmax_t epoch = atomic_load(&object->epoch);
+    bool is_advanced = true;
+    for (struct rock_linked_list_node *node = object->threads.next;
+         is_advanced && node != &object->threads;
+         node = node->next) {
+        struct rock_epoch_thread *const thread
+                = rock_container_of(node, struct rock_epoch_thread, node);
+        is_advanced = !atomic_load(&thread->is_active)
+                      || epoch == atomic_load(&thread->epoch);
+    }
+    if (is_advanced) {
+        atomic_store(&object->epoch, 1 + epoch);
+        if (epoch) {
+            rock_epoch_destroy(&object->orphans, epoch - 1);
+        }
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return is_advanced;
+}
+
+void rock_epoch_collect(struct rock_epoch *const object,
+                        struct rock_epoch_thread *const thread) {
+    seagrass_required(object);
+    seagrass_required(thread);
+    const uintmax_t epoch = atomic_load(&object->epoch);
+    if (epoch < 2) {
+        return;
+    }
+    /* items retired at e may be referenced until the epoch reaches e + 2 */
+    for (uintmax_t i = 0; i < ROCK_EPOCH_LIMBO; i++) {
+        rock_epoch_destroy(&thread->limbo[i], epoch - 2);
+    }
+}
+
+int rock_epoch_register(struct rock_epoch *const object,
+                        struct rock_epoch_thread *const thread) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_EPOCH_ERROR_THREAD_IS_NULL;
+    }
+    int error;
+    for (uintmax_t i = 0; i < ROCK_EPOCH_LIMBO; i++) {
+        if ((error = rock_array_init(&thread->limbo[i],
+                                     sizeof(struct rock_epoch_item),
+                                     0))) {
+            seagrass_required_true(
+                    ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED == error);
+            for (uintmax_t o = 0; o < i; o++) {
+                seagrass_required_true(!rock_array_invalidate(
+                        &thread->limbo[o], NULL));
+            }
+            return ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+    }
+    atomic_init(&thread->epoch, 0);
+    atomic_init(&thread->is_active, false);
+    thread->nesting = 0;
+    thread->retired = 0;
+    seagrass_required_true(!rock_linked_list_node_init(&thread->node));
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    seagrass_required_true(!rock_linked_list_insert_before(
+            &object->threads, &thread->node));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+int rock_epoch_unregister(struct rock_epoch *const object,
+                          struct rock_epoch_thread *const thread) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_EPOCH_ERROR_THREAD_IS_NULL;
+    }
+    seagrass_required_true(!thread->nesting);
+    rock_epoch_collect(object, thread);
+    uintmax_t count = 0;
+    for (uintmax_t i = 0; i < ROCK_EPOCH_LIMBO; i++) {
+        count += thread->limbo[i].length;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    /* hand the items that have yet to expire over to the domain */
+    uintmax_t at = object->orphans.length;
+    int error;
+    if (count && (error = rock_array_set_length(&object->orphans,
+                                                at + count))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+        return ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    struct rock_epoch_item *const orphans = object->orphans.data;
+    for (uintmax_t i = 0; i < ROCK_EPOCH_LIMBO; i++) {
+        const struct rock_array *const limbo = &thread->limbo[i];
+        if (limbo->length) {
+            memcpy(&orphans[at], limbo->data,
+                   sizeof(struct rock_epoch_item) * limbo->length);
+            at += limbo->length;
+        }
+        seagrass_required_true(!rock_array_invalidate(&thread->limbo[i],
+                                                      NULL));
+    }
+    seagrass_required_true(!rock_linked_list_remove(&thread->node));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+int rock_epoch_enter(struct rock_epoch *const object,
+                     struct rock_epoch_thread *const thread) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_EPOCH_ERROR_THREAD_IS_NULL;
+    }
+    if (thread->nesting++) {
+        return 0;
+    }
+    atomic_store_explicit(&thread->epoch, atomic_load(&object->epoch),
+                          memory_order_relaxed);
+    atomic_store_explicit(&thread->is_active, true, memory_order_relaxed);
+    /* being active must be visible before any shared reference is read */
+    atomic_thread_fence(memory_order_seq_cst);
+    return 0;
+}
+
+int rock_epoch_exit(struct rock_epoch *const object,
+                    struct rock_epoch_thread *const thread) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_EPOCH_ERROR_THREAD_IS_NULL;
+    }
+    seagrass_required_true(thread->nesting);
+    if (--thread->nesting) {
+        return 0;
+    }
+    atomic_store_explicit(&thread->is_active, false, memory_order_release);
+    return 0;
+}
+
+int rock_epoch_retire(struct rock_epoch *const object,
+                      struct rock_epoch_thread *const thread,
+                      void *const item,
+                      void (*const on_destroy)(void *)) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_EPOCH_ERROR_THREAD_IS_NULL;
+    }
+    if (!item) {
+        return ROCK_EPOCH_ERROR_ITEM_IS_NULL;
+    }
+    if (!on_destroy) {
+        return ROCK_EPOCH_ERROR_FUNCTION_IS_NULL;
+    }
+    seagrass_required_true(thread->nesting);
+    /* stamped after the item was unlinked, so that no thread that entered
+     * before then can be ahead of the stamp */
+    const uintmax_t epoch = atomic_load(&object->epoch);
+    struct rock_array *const limbo = &thread->limbo[epoch % ROCK_EPOCH_LIMBO];
+    if (limbo->length
+        && epoch != ((const struct rock_epoch_item *) limbo->data)->epoch) {
+        /* left over from at least ROCK_EPOCH_LIMBO epochs ago */
+        rock_epoch_destroy(limbo, epoch - ROCK_EPOCH_LIMBO);
+    }
+    const struct rock_epoch_item entry = {
+            .item = item,
+            .on_destroy = on_destroy,
+            .epoch = epoch
+    };
+    int error;
+    if ((error = rock_array_add(limbo, &entry))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if (++thread->retired >= object->threshold) {
+        thread->retired = 0;
+        rock_epoch_advance(object);
+        rock_epoch_collect(object, thread);
+    }
+    return 0;
+}
+
+int rock_epoch_reclaim(struct rock_epoch *const object,
+                       struct rock_epoch_thread *const thread) {
+    if (!object) {
+        return ROCK_EPOCH_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_EPOCH_ERROR_THREAD_IS_NULL;
+    }
+    rock_epoch_advance(object);
+    rock_epoch_collect(object, thread);
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include <stdlib.h>
+#include <string.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/hazard.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+int rock_hazard_init(struct rock_hazard *const object,
+                     const uintmax_t threshold) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!threshold) {
+        return ROCK_HAZARD_ERROR_THRESHOLD_IS_ZERO;
+    }
+    int error;
+    if ((error = rock_array_init(&object->orphans,
+                                 sizeof(struct rock_hazard_item),
+                                 0))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    seagrass_required_true(!rock_linked_list_node_init(&object->threads));
+    seagrass_required_true(!pthread_mutex_init(&object->mutex, NULL));
+    object->threshold = threshold;
+    return 0;
+}
+
+int rock_hazard_invalidate(struct rock_hazard *const object) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    seagrass_required_true(object->threads.next == &object->threads);
+    rock_hazard_destroy(&object->orphans, NULL);
+    seagrass_required_true(!rock_array_invalidate(&object->orphans, NULL));
+    seagrass_required_true(!pthread_mutex_destroy(&object->mutex));
+    object->threshold = 0;
+    return 0;
+}
+
+static int rock_hazard_compare(const void *const a, const void *const b) {
+    return seagrass_void_ptr_compare(*(void *const *) a, *(void *const *) b);
+}
+
+int rock_hazard_gather(struct rock_hazard *const object,
+                       struct rock_array *const hazards) {
+    seagrass_required(object);
+    seagrass_required(hazards);
+    uintmax_t count = 0;
+    for (struct rock_linked_list_node *node = object->threads.next;
+         node != &object->threads;
+         node = node->next) {
+        count += ROCK_HAZARD_SLOTS;
+    }
+    int error;
+    if ((error = rock_array_set_length(hazards, count))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    void **const data = hazards->data;
+    uintmax_t length = 0;
+    for (struct rock_linked_list_node *node = object->threads.next;
+         node != &object->threads;
+         node = node->next) {
+        struct rock_hazard_thread *const thread
+                = rock_container_of(node, struct rock_hazard_thread, node);
+        for (uintmax_t i = 0; i < ROCK_HAZARD_SLOTS; i++) {
+            void *const hazard = atomic_load(&thread->slots[i]);
+            if (hazard) {
+                data[length++] = hazard;
+            }
+        }
+    }
+    seagrass_required_true(!rock_array_set_length(hazards, length));
+    if (length) {
+        qsort(data, length, sizeof(void *), rock_hazard_compare);
+    }
+    return 0;
+}
+
+void rock_hazard_destroy(struct rock_array *const array,
+                         const struct rock_array *const hazards) {
+    seagrass_required(array);
+    struct rock_hazard_item *const items = array->data;
+    uintmax_t kept = 0;
+    for (uintmax_t i = 0; i < array->length; i++) {
+        if (hazards && hazards->length
+            && bsearch(&items[i].item, hazards->data, hazards->length,
+                       sizeof(void *), rock_hazard_compare)) {
+            items[kept++] = items[i];
+        } else {
+            items[i].on_destroy(items[i].item);
+        }
+    }
+    seagrass_required_true(!rock_array_set_length(array, kept));
+}
+
+int rock_hazard_register(struct rock_hazard *const object,
+                         struct rock_hazard_thread *const thread) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_HAZARD_ERROR_THREAD_IS_NULL;
+    }
+    int error;
+    if ((error = rock_array_init(&thread->retired,
+                                 sizeof(struct rock_hazard_item),
+                                 0))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if ((error = rock_array_init(&thread->hazards, sizeof(void *), 0))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        seagrass_required_true(!rock_array_invalidate(&thread->retired,
+                                                      NULL));
+        return ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    for (uintmax_t i = 0; i < ROCK_HAZARD_SLOTS; i++) {
+        atomic_init(&thread->slots[i], NULL);
+    }
+    thread->watermark = object->threshold;
+    seagrass_required_true(!rock_linked_list_node_init(&thread->node));
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    seagrass_required_true(!rock_linked_list_insert_before(
+            &object->threads, &thread->node));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+int rock_hazard_unregister(struct rock_hazard *const object,
+                           struct rock_hazard_thread *const thread) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_HAZARD_ERROR_THREAD_IS_NULL;
+    }
+    for (uintmax_t i = 0; i < ROCK_HAZARD_SLOTS; i++) {
+        atomic_store(&thread->slots[i], NULL);
+    }
+    int error;
+    if ((error = rock_hazard_reclaim(object, thread))) {
+        seagrass_required_true(
+                ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED == error);
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    /* hand the items that are still protected over to the domain */
+    const uintmax_t at = object->orphans.length;
+    const uintmax_t count = thread->retired.length;
+    if (count && (error = rock_array_set_length(&object->orphans,
+                                                at + count))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+        return ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if (count) {
+        memcpy(((struct rock_hazard_item *) object->orphans.data) + at,
+               thread->retired.data,
+               sizeof(struct rock_hazard_item) * count);
+    }
+    seagrass_required_true(!rock_linked_list_remove(&thread->node));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    seagrass_required_true(!rock_array_invalidate(&thread->retired, NULL));
+    seagrass_required_true(!rock_array_invalidate(&thread->hazards, NULL));
+    return 0;
+}
+
+int rock_hazard_protect(struct rock_hazard *const object,
+                        struct rock_hazard_thread *const thread,
+                        const uintmax_t slot,
+                        void *_Atomic const *const source,
+                        void **const out) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_HAZARD_ERROR_THREAD_IS_NULL;
+    }
+    if (slot >= ROCK_HAZARD_SLOTS) {
+        return ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS;
+    }
+    if (!source) {
+        return ROCK_HAZARD_ERROR_SOURCE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_HAZARD_ERROR_OUT_IS_NULL;
+    }
+    void *_Atomic *const s = (void *_Atomic *) source;
+    void *item = atomic_load(s);
+    while (true) {
+        atomic_store(&thread->slots[slot], item);
+        /* the hazard must be visible before we validate the reference,
+         * otherwise it may have been retired and scanned in between */
+        void *const current = atomic_load(s);
+        if (current == item) {
+            break;
+        }
+        item = current;
+    }
+    *out = item;
+    return 0;
+}
+
+int rock_hazard_clear(struct rock_hazard *const object,
+                      struct rock_hazard_thread *const thread,
+                      const uintmax_t slot) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_HAZARD_ERROR_THREAD_IS_NULL;
+    }
+    if (slot >= ROCK_HAZARD_SLOTS) {
+        return ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS;
+    }
+    atomic_store_explicit(&thread->slots[slot], NULL, memory_order_release);
+    return 0;
+}
+
+int rock_hazard_retire(struct rock_hazard *const object,
+                       struct rock_hazard_thread *const thread,
+                       void *const item,
+                       void (*const on_destroy)(void *)) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_HAZARD_ERROR_THREAD_IS_NULL;
+    }
+    if (!item) {
+        return ROCK_HAZARD_ERROR_ITEM_IS_NULL;
+    }
+    if (!on_destroy) {
+        return ROCK_HAZARD_ERROR_FUNCTION_IS_NULL;
+    }
+    const struct rock_hazard_item entry = {
+            .item = item,
+            .on_destroy = on_destroy
+    };
+    int error;
+    if ((error = rock_array_add(&thread->retired, &entry))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if (thread->retired.length >= thread->watermark
+        && (error = rock_hazard_reclaim(object, thread))) {
+        /* the item is retired, scanning is attempted again later */
+        seagrass_required_true(
+                ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED == error);
+    }
+    return 0;
+}
+
+int rock_hazard_reclaim(struct rock_hazard *const object,
+                        struct rock_hazard_thread *const thread) {
+    if (!object) {
+        return ROCK_HAZARD_ERROR_OBJECT_IS_NULL;
+    }
+    if (!thread) {
+        return ROCK_HAZARD_ERROR_THREAD_IS_NULL;
+    }
+    int error;
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    if ((error = rock_hazard_gather(object, &thread->hazards))) {
+        seagrass_required_true(
+                ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED == error);
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+        return error;
+    }
+    rock_hazard_destroy(&object->orphans, &thread->hazards);
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    rock_hazard_destroy(&thread->retired, &thread->hazards);
+    /* protected items stay behind, do not let them trigger every retire */
+    if ((error = seagrass_uintmax_t_add(thread->retired.length,
+                                        object->threshold,
+                                        &thread->watermark))) {
+        seagrass_required_true(
+                SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT == error);
+        thread->watermark = UINTMAX_MAX;
+    }
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <stdlib.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/red_black_tree.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+static struct rock_interval_tree_node *rock_interval_tree_of(
+        const struct rock_red_black_tree_node *const node) {
+    return node
+           ? rock_container_of(node, struct rock_interval_tree_node, node)
+           : NULL;
+}
+
+static bool rock_interval_tree_compute(
+        struct rock_red_black_tree_node *const node) {
+    struct rock_interval_tree_node *const object
+            = rock_interval_tree_of(node);
+    uintmax_t max = object->high;
+    struct rock_red_black_tree_node *child;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &child));
+    if (child && rock_interval_tree_of(child)->max > max) {
+        max = rock_interval_tree_of(child)->max;
+    }
+    seagrass_required_true(!rock_red_black_tree_node_get_right(node, &child));
+    if (child && rock_interval_tree_of(child)->max > max) {
+        max = rock_interval_tree_of(child)->max;
+    }
+    if (max == object->max) {
+        return false;
+    }
+    object->max = max;
+    return true;
+}
+
+static void rock_interval_tree_propagate(
+        struct rock_red_black_tree_node *node,
+        const struct rock_red_black_tree_node *const stop) {
+    while (node && node != stop && rock_interval_tree_compute(node)) {
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &node));
+    }
+}
+
+static void rock_interval_tree_copy(
+        const struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const other) {
+    rock_interval_tree_of(other)->max = rock_interval_tree_of(node)->max;
+}
+
+static void rock_interval_tree_rotate(
+        struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const top) {
+    rock_interval_tree_copy(node, top);
+    rock_interval_tree_compute(node);
+}
+
+static const struct rock_red_black_tree_augment rock_interval_tree_augment = {
+        .propagate = rock_interval_tree_propagate,
+        .copy = rock_interval_tree_copy,
+        .rotate = rock_interval_tree_rotate
+};
+
+static int rock_interval_tree_compare(
+        const struct rock_red_black_tree_node *const a,
+        const struct rock_red_black_tree_node *const b) {
+    const struct rock_interval_tree_node *const A = rock_interval_tree_of(a);
+    const struct rock_interval_tree_node *const B = rock_interval_tree_of(b);
+    int result;
+    if ((result = seagrass_uintmax_t_compare(A->low, B->low))) {
+        return result;
+    }
+    if ((result = seagrass_uintmax_t_compare(A->high, B->high))) {
+        return result;
+    }
+    /* equal intervals are told apart by their nodes */
+    return seagrass_void_ptr_compare(A, B);
+}
+
+int rock_interval_tree_node_init(struct rock_interval_tree_node *const node,
+                                 const uintmax_t low,
+                                 const uintmax_t high) {
+    if (!node) {
+        return ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (low > high) {
+        return ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID;
+    }
+    seagrass_required_true(!rock_red_black_tree_node_init(&node->node));
+    node->low = low;
+    node->high = high;
+    node->max = high;
+    return 0;
+}
+
+int rock_interval_tree_init(struct rock_interval_tree *const object) {
+    if (!object) {
+        return ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    seagrass_required_true(!rock_red_black_tree_init_augmented(
+            &object->tree, rock_interval_tree_compare,
+            &rock_interval_tree_augment));
+    return 0;
+}
+
+int rock_interval_tree_invalidate(
+        struct rock_interval_tree *const object,
+        void (*const on_destroy)(struct rock_interval_tree_node *node)) {
+    if (!object) {
+        return ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    struct rock_red_black_tree_node *node = object->tree.root;
+    object->tree.root = NULL;
+    seagrass_required_true(!rock_red_black_tree_invalidate(
+            &object->tree, NULL));
+    if (node) {
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                node, NULL));
+    }
+    /* on_destroy expects the interval node hence the red black tree's own
+     * teardown cannot invoke it directly */
+    while (node) {
+        struct rock_red_black_tree_node *next;
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                node, &next));
+        if (next) {
+            seagrass_required_true(!rock_red_black_tree_node_set_left(
+                    node, NULL));
+            node = next;
+            continue;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_right(
+                node, &next));
+        if (next) {
+            seagrass_required_true(!rock_red_black_tree_node_set_right(
+                    node, NULL));
+            node = next;
+            continue;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &next));
+        if (on_destroy) {
+            on_destroy(rock_interval_tree_of(node));
+        }
+        node = next;
+    }
+    return 0;
+}
+
+int rock_interval_tree_count(const struct rock_interval_tree *const object,
+                             uintmax_t *const out) {
+    if (!object) {
+        return ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL;
+    }
+    seagrass_required_true(!rock_red_black_tree_count(&object->tree, out));
+    return 0;
+}
+
+int rock_interval_tree_insert(struct rock_interval_tree *const object,
+                              struct rock_interval_tree_node *const node) {
+    if (!object) {
+        return ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL;
+    }
+    node->max = node->high;
+    struct rock_red_black_tree_node *out;
+    seagrass_required_true(!rock_red_black_tree_find_or_insert(
+            &object->tree, &node->node, &out));
+    /* nodes are unique by address, hence node is always linked in */
+    seagrass_required_true(out == &node->node);
+    return 0;
+}
+
+int rock_interval_tree_remove(struct rock_interval_tree *const object,
+                              struct rock_interval_tree_node *const node) {
+    if (!object) {
+        return ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL;
+    }
+    seagrass_required_true(!rock_red_black_tree_remove(&object->tree,
+                                                       &node->node));
+    return 0;
+}
+
+static struct rock_interval_tree_node *rock_interval_tree_search(
+        struct rock_interval_tree_node *node,
+        const uintmax_t low,
+        const uintmax_t high) {
+    seagrass_required(node);
+    while (true) {
+        struct rock_red_black_tree_node *child;
+        /* the leftmost overlapping interval is within the left subtree if
+         * any interval there reaches low */
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                &node->node, &child));
+        if (child && rock_interval_tree_of(child)->max >= low) {
+            node = rock_interval_tree_of(child);
+            continue;
+        }
+        if (node->low > high) {
+            return NULL;
+        }
+        if (node->high >= low) {
+            return node;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_right(
+                &node->node, &child));
+        if (!child || rock_interval_tree_of(child)->max < low) {
+            return NULL;
+        }
+        node = rock_interval_tree_of(child);
+    }
+}
+
+int rock_interval_tree_overlap_first(
+        const struct rock_interval_tree *const object,
+        const uintmax_t low,
+        const uintmax_t high,
+        struct rock_interval_tree_node **const out) {
+    if (!object) {
+        return ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL;
+    }
+    if (low > high) {
+        return ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID;
+    }
+    struct rock_interval_tree_node *const root
+            = rock_interval_tree_of(object->tree.root);
+    struct rock_interval_tree_node *node;
+    if (!root || root->max < low
+        || !(node = rock_interval_tree_search(root, low, high))) {
+        return ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND;
+    }
+    *out = node;
+    return 0;
+}
+
+int rock_interval_tree_overlap_next(
+        const struct rock_interval_tree_node *const node,
+        const uintmax_t low,
+        const uintmax_t high,
+        struct rock_interval_tree_node **const out) {
+    if (!node) {
+        return ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL;
+    }
+    if (low > high) {
+        return ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID;
+    }
+    struct rock_red_black_tree_node *N = (struct rock_red_black_tree_node *)
+            &node->node;
+    struct rock_red_black_tree_node *R;
+    seagrass_required_true(!rock_red_black_tree_node_get_right(N, &R));
+    while (true) {
+        /* intervals after N are either in its right subtree ... */
+        if (R && rock_interval_tree_of(R)->max >= low) {
+            struct rock_interval_tree_node *const result
+                    = rock_interval_tree_search(rock_interval_tree_of(R),
+                                                low, high);
+            if (!result) {
+                return ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE;
+            }
+            *out = result;
+            return 0;
+        }
+        /* ... or at the first ancestor which we reach from its left */
+        struct rock_red_black_tree_node *child;
+        do {
+            child = N;
+            seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                    child, &N));
+            if (!N) {
+                return ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE;
+            }
+            seagrass_required_true(!rock_red_black_tree_node_get_right(
+                    N, &R));
+        } while (R == child);
+        struct rock_interval_tree_node *const current
+                = rock_interval_tree_of(N);
+        if (current->low > high) {
+            return ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE;
+        }
+        if (current->high >= low) {
+            *out = current;
+            return 0;
+        }
+    }
+}
+
+int rock_interval_tree_stab_first(
+        const struct rock_interval_tree *const object,
+        const uintmax_t point,
+        struct rock_interval_tree_node **const out) {
+    return rock_interval_tree_overlap_first(object, point, point, out);
+}
+
+int rock_interval_tree_stab_next(
+        const struct rock_interval_tree_node *const node,
+        const uintmax_t point,
+        struct rock_interval_tree_node **const out) {
+    return rock_interval_tree_overlap_next(node, point, point, out);
+}
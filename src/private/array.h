@@ -7,8 +7,21 @@
 
 struct rock_array;
 
+#if !defined(ROCK_UNCHECKED) || defined(TEST)
+
 void *rock_array_address(const struct rock_array *object, uintmax_t at);
 
+#else
+#include <rock/array.h>
+
+/* Unchecked builds compute the address in place. */
+static inline void *rock_array_address(const struct rock_array *const object,
+                                       const uintmax_t at) {
+    return ((unsigned char *) object->data) + (object->size * at);
+}
+
+#endif
+
 /**
  * @brief Set the capacity.
  * @param [in] object array instance.
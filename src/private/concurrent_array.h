@@ -0,0 +1,77 @@
+#ifndef _ROCK_PRIVATE_CONCURRENT_ARRAY_H_
+#define _ROCK_PRIVATE_CONCURRENT_ARRAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* items are followed by a ready flag for each slot */
+struct rock_concurrent_array_segment {
+    uintmax_t capacity;
+    unsigned char data[];
+};
+
+struct rock_concurrent_array;
+
+/**
+ * @brief Allocate a segment.
+ * @param [in] size of an item.
+ * @param [in] capacity of the segment.
+ * @param [out] out receive the segment.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to allocate the segment.
+ */
+int rock_concurrent_array_segment_of(
+        size_t size,
+        uintmax_t capacity,
+        struct rock_concurrent_array_segment **out);
+
+/**
+ * @brief Locate the segment and offset of index.
+ * @param [in] object concurrent array instance.
+ * @param [in] at index of item.
+ * @param [out] segment receive the segment's position.
+ * @param [out] offset receive the slot's position within segment.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS if index is
+ * beyond the last segment.
+ */
+int rock_concurrent_array_locate(const struct rock_concurrent_array *object,
+                                 uintmax_t at,
+                                 uintmax_t *segment,
+                                 uintmax_t *offset);
+
+/**
+ * @brief Retrieve the segment at position, allocating it if needed.
+ * @param [in] object concurrent array instance.
+ * @param [in] at position of segment.
+ * @param [out] out receive the segment.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to allocate the segment.
+ */
+int rock_concurrent_array_segment(struct rock_concurrent_array *object,
+                                  uintmax_t at,
+                                  struct rock_concurrent_array_segment **out);
+
+/**
+ * @brief Retrieve the ready flag of a slot.
+ * @param [in] segment containing the slot.
+ * @param [in] size of an item.
+ * @param [in] at offset of the slot within segment.
+ * @return ready flag of the slot.
+ */
+atomic_bool *rock_concurrent_array_segment_ready(
+        const struct rock_concurrent_array_segment *segment,
+        size_t size,
+        uintmax_t at);
+
+/**
+ * @brief Advance the published watermark past every ready slot.
+ * @param [in] object concurrent array instance.
+ */
+void rock_concurrent_array_publish(struct rock_concurrent_array *object);
+
+#endif /* _ROCK_PRIVATE_CONCURRENT_ARRAY_H_ */
@@ -0,0 +1,42 @@
+#ifndef _ROCK_PRIVATE_EPOCH_H_
+#define _ROCK_PRIVATE_EPOCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rock/array.h>
+
+struct rock_epoch_item {
+    void *item;
+    void (*on_destroy)(void *);
+    uintmax_t epoch;
+};
+
+struct rock_epoch;
+struct rock_epoch_thread;
+
+/**
+ * @brief Advance the epoch if every active thread has observed it.
+ * @param [in] object domain instance.
+ * @return True if the epoch was advanced, otherwise false.
+ */
+bool rock_epoch_advance(struct rock_epoch *object);
+
+/**
+ * @brief Destroy the items of the limbo lists that have expired.
+ * @param [in] object domain instance.
+ * @param [in] thread whose limbo lists are to be examined.
+ */
+void rock_epoch_collect(struct rock_epoch *object,
+                        struct rock_epoch_thread *thread);
+
+/**
+ * @brief Destroy all the items within array that retired at or before
+ * epoch.
+ * @param [in] array of items.
+ * @param [in] epoch latest retirement epoch to be destroyed.
+ */
+void rock_epoch_destroy(struct rock_array *array,
+                        uintmax_t epoch);
+
+#endif /* _ROCK_PRIVATE_EPOCH_H_ */
@@ -0,0 +1,37 @@
+#ifndef _ROCK_PRIVATE_HAZARD_H_
+#define _ROCK_PRIVATE_HAZARD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rock/array.h>
+
+struct rock_hazard_item {
+    void *item;
+    void (*on_destroy)(void *);
+};
+
+struct rock_hazard;
+struct rock_hazard_thread;
+
+/**
+ * @brief Gather the sorted hazard slots of all the registered threads.
+ * @param [in] object domain instance.
+ * @param [in] hazards array to receive the protected references.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to gather the hazard slots.
+ * @note The caller must hold the mutex.
+ */
+int rock_hazard_gather(struct rock_hazard *object,
+                       struct rock_array *hazards);
+
+/**
+ * @brief Destroy all the items within array that are not protected.
+ * @param [in] array of items.
+ * @param [in] hazards sorted protected references.
+ */
+void rock_hazard_destroy(struct rock_array *array,
+                         const struct rock_array *hazards);
+
+#endif /* _ROCK_PRIVATE_HAZARD_H_ */
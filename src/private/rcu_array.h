@@ -0,0 +1,24 @@
+#ifndef _ROCK_PRIVATE_RCU_ARRAY_H_
+#define _ROCK_PRIVATE_RCU_ARRAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rock/array.h>
+
+struct rock_rcu_array_snapshot {
+    struct rock_array array;
+    uintmax_t epoch;
+    struct rock_rcu_array_snapshot *retired;
+};
+
+struct rock_rcu_array;
+
+/**
+ * @brief Release the retired snapshots whose grace period has elapsed.
+ * @param [in] object RCU array instance.
+ * @note The caller must hold the mutex.
+ */
+void rock_rcu_array_reclaim(struct rock_rcu_array *object);
+
+#endif /* _ROCK_PRIVATE_RCU_ARRAY_H_ */
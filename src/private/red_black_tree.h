@@ -17,6 +17,7 @@
 #define ROCK_RED_BLACK_TREE_ERROR_X_IS_NOT_RIGHT_CHILD_OF_Z     (-7)
 
 struct rock_red_black_tree_node;
+struct rock_red_black_tree;
 
 /**
  * @brief Check if a node is on the left or right.
@@ -42,6 +43,8 @@ void rock_red_black_tree_minimum(const struct rock_red_black_tree_node *root,
 void rock_red_black_tree_maximum(const struct rock_red_black_tree_node *root,
                                  struct rock_red_black_tree_node **out);
 
+#if !defined(ROCK_UNCHECKED) || defined(TEST)
+
 /**
  * @brief Retrieve parent of node.
  * @param [in] node whose parent we are to retrieve.
@@ -138,6 +141,245 @@ int rock_red_black_tree_node_set_right(
         struct rock_red_black_tree_node *restrict node,
         struct rock_red_black_tree_node *restrict right);
 
+#else
+#include <rock/red_black_tree.h>
+
+/* Unchecked builds replace the accessors with plain field accesses, so that
+ * the rotations and repair loops do not pay for a call, the argument checks
+ * and the error code on every step. The callers' invariant checks fold away
+ * as these always succeed. */
+
+static inline int rock_red_black_tree_node_get_parent(
+        const struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node **const out) {
+    *out = (struct rock_red_black_tree_node *) ((uintptr_t) node->parent & ~1);
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_set_parent(
+        struct rock_red_black_tree_node *restrict const node,
+        struct rock_red_black_tree_node *restrict const parent) {
+    const uintptr_t value = (uintptr_t) parent | ((uintptr_t) node->parent & 1);
+    node->parent = (struct rock_red_black_tree_node *) value;
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_get_color(
+        const struct rock_red_black_tree_node *const node,
+        bool *const out) {
+    /* NIL nodes are black */
+    *out = !node || (uintptr_t) node->parent & 1;
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_set_color(
+        struct rock_red_black_tree_node *const node,
+        const bool color) {
+    const uintptr_t value = (~1 & (uintptr_t) node->parent) | color;
+    node->parent = (struct rock_red_black_tree_node *) value;
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_get_left(
+        const struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node **const out) {
+    *out = node->left;
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_set_left(
+        struct rock_red_black_tree_node *restrict const node,
+        struct rock_red_black_tree_node *restrict const left) {
+    node->left = left;
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_get_right(
+        const struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node **const out) {
+    *out = node->right;
+    return 0;
+}
+
+static inline int rock_red_black_tree_node_set_right(
+        struct rock_red_black_tree_node *restrict const node,
+        struct rock_red_black_tree_node *restrict const right) {
+    node->right = right;
+    return 0;
+}
+
+#endif
+
+/**
+ * @brief Restore the red black properties after a node has been linked.
+ * @param [in] augment of the red black tree, may be <i>NULL</i>.
+ * @param [in,out] root of the tree or subtree that child was linked into.
+ * @param [in] parent of the linked node or <i>NULL</i> if it is the root.
+ * @param [in] child RED node that has just been linked under parent.
+ * @return true if the black height has grown by one, otherwise false.
+ */
+bool rock_red_black_tree_insert_repair(
+        const struct rock_red_black_tree_augment *augment,
+        struct rock_red_black_tree_node **root,
+        struct rock_red_black_tree_node *parent,
+        struct rock_red_black_tree_node *child);
+
+/**
+ * @brief Unlink node and restore the red black properties.
+ * @param [in] augment of the red black tree, may be <i>NULL</i>.
+ * @param [in,out] root of the tree or subtree that contains node.
+ * @param [in] node to be unlinked.
+ * @return true if the black height has shrunk by one, otherwise false.
+ */
+bool rock_red_black_tree_unlink(
+        const struct rock_red_black_tree_augment *augment,
+        struct rock_red_black_tree_node **root,
+        struct rock_red_black_tree_node *node);
+
+/**
+ * @brief Destroy all the nodes of the subtree.
+ * @param [in] node root of the subtree.
+ * @param [in] on_destroy called for every node, may be <i>NULL</i>.
+ */
+void rock_red_black_tree_destroy(
+        struct rock_red_black_tree_node *node,
+        void (*on_destroy)(struct rock_red_black_tree_node *node));
+
+/**
+ * @brief Count the BLACK nodes from node down to a NIL node.
+ * @param [in] node root of the subtree, may be <i>NULL</i>.
+ * @return black height of the subtree.
+ */
+uintmax_t rock_red_black_tree_black_height(
+        const struct rock_red_black_tree_node *node);
+
+/**
+ * @brief Augmentation maintaining the subtree sizes of
+ * {@link rock_red_black_tree_sized_node}.
+ */
+extern const struct rock_red_black_tree_augment
+        rock_red_black_tree_size_augment;
+
+/**
+ * @brief Recompute the augmented value of node from its children.
+ * @param [in] augment of the red black tree, may be <i>NULL</i>.
+ * @param [in] node whose children have up to date values.
+ * @note Nothing is done unless augment is provided.
+ */
+void rock_red_black_tree_update(
+        const struct rock_red_black_tree_augment *augment,
+        struct rock_red_black_tree_node *node);
+
+/**
+ * @brief Recompute the augmented values from node up towards the root.
+ * @param [in] augment of the red black tree, may be <i>NULL</i>.
+ * @param [in] node lowest node whose subtree has been modified, may be
+ * <i>NULL</i>.
+ * @param [in] stop ancestor at which to stop, or <i>NULL</i> for the root.
+ * @note Nothing is done unless augment is provided.
+ */
+void rock_red_black_tree_propagate(
+        const struct rock_red_black_tree_augment *augment,
+        struct rock_red_black_tree_node *node,
+        const struct rock_red_black_tree_node *stop);
+
+/**
+ * @brief Restore the augmented values after node has been linked.
+ * @param [in] augment of the red black tree, may be <i>NULL</i>.
+ * @param [in] node that has just been linked.
+ * @note Nothing is done unless augment is provided.
+ */
+void rock_red_black_tree_linked(
+        const struct rock_red_black_tree_augment *augment,
+        struct rock_red_black_tree_node *node);
+
+/**
+ * @brief Restore the augmented values after a rotation.
+ * <p>Top has taken the place of node, so it now roots the same nodes that
+ * node used to root.</p>
+ * @param [in] augment of the red black tree, may be <i>NULL</i>.
+ * @param [in] node that has been rotated down.
+ * @param [in] top that has been rotated up into the place of node.
+ * @note Nothing is done unless augment is provided.
+ */
+void rock_red_black_tree_rotated(
+        const struct rock_red_black_tree_augment *augment,
+        struct rock_red_black_tree_node *node,
+        struct rock_red_black_tree_node *top);
+
+/**
+ * @brief Recompute the cached leftmost and rightmost nodes from the root.
+ * @param [in] object instance of red black tree.
+ * @note Nothing is done unless object caches its extremes.
+ */
+void rock_red_black_tree_extremes(struct rock_red_black_tree *object);
+
+/**
+ * @brief Join two subtrees around node.
+ * <p>Only the spine of the taller subtree is descended, down to where the
+ * black heights match, hence the cost is proportional to the difference
+ * of both black heights.</p>
+ * @param [in] object instance of red black tree the subtrees belong to.
+ * @param [in] left root of subtree whose nodes are less than node.
+ * @param [in] left_height black height of left.
+ * @param [in] node to be placed between both subtrees.
+ * @param [in] right root of subtree whose nodes are greater than node.
+ * @param [in] right_height black height of right.
+ * @param [out] height receive the black height of the joined subtree.
+ * @return root of the joined subtree.
+ */
+struct rock_red_black_tree_node *rock_red_black_tree_join_subtrees(
+        const struct rock_red_black_tree *object,
+        struct rock_red_black_tree_node *left,
+        uintmax_t left_height,
+        struct rock_red_black_tree_node *node,
+        struct rock_red_black_tree_node *right,
+        uintmax_t right_height,
+        uintmax_t *height);
+
+/**
+ * @brief Join two subtrees.
+ * @param [in] object instance of red black tree the subtrees belong to.
+ * @param [in] left root of subtree whose nodes are less than those of right.
+ * @param [in] left_height black height of left.
+ * @param [in] right root of subtree.
+ * @param [in] right_height black height of right.
+ * @param [out] height receive the black height of the joined subtree.
+ * @return root of the joined subtree.
+ */
+struct rock_red_black_tree_node *rock_red_black_tree_concatenate(
+        const struct rock_red_black_tree *object,
+        struct rock_red_black_tree_node *left,
+        uintmax_t left_height,
+        struct rock_red_black_tree_node *right,
+        uintmax_t right_height,
+        uintmax_t *height);
+
+/**
+ * @brief Split subtree at needle.
+ * <p>Black heights are derived on the way down from that of root, so that
+ * every join along the search path is paid for by the difference of black
+ * heights and the split takes O(log n) overall.</p>
+ * @param [in] object instance of red black tree providing the comparison.
+ * @param [in] root of the subtree to be split.
+ * @param [in] height black height of root.
+ * @param [in] needle at which the subtree is split.
+ * @param [out] left receive the root of the nodes less than needle.
+ * @param [out] left_height receive the black height of left.
+ * @param [out] right receive the root of the nodes greater than needle.
+ * @param [out] right_height receive the black height of right.
+ * @return node equal to needle or <i>NULL</i> if there was none.
+ */
+struct rock_red_black_tree_node *rock_red_black_tree_split_subtree(
+        const struct rock_red_black_tree *object,
+        struct rock_red_black_tree_node *root,
+        uintmax_t height,
+        const struct rock_red_black_tree_node *needle,
+        struct rock_red_black_tree_node **left,
+        uintmax_t *left_height,
+        struct rock_red_black_tree_node **right,
+        uintmax_t *right_height);
+
 /**
  * @brief Perform left rotation.
  * @verbatim
@@ -0,0 +1,82 @@
+#ifndef _ROCK_PRIVATE_THREAD_POOL_H_
+#define _ROCK_PRIVATE_THREAD_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <rock/ws_deque.h>
+
+struct rock_thread_pool;
+
+struct rock_thread_pool_task {
+    void (*function)(void *context, uintmax_t begin, uintmax_t end);
+    void *context;
+    uintmax_t begin;
+    uintmax_t end;
+};
+
+struct rock_thread_pool_worker {
+    struct rock_ws_deque deque;
+    struct rock_thread_pool *pool;
+    uintmax_t id;
+    pthread_t thread;
+};
+
+/**
+ * @brief Retrieve the worker of the calling thread.
+ * @param [in] object thread pool instance.
+ * @return The worker if the calling thread is one of the thread pool's
+ * workers, otherwise <i>NULL</i>.
+ */
+struct rock_thread_pool_worker *rock_thread_pool_worker_current(
+        const struct rock_thread_pool *object);
+
+/**
+ * @brief Make a task available for execution.
+ * <p>A task spawned from a worker is pushed onto the worker's own deque,
+ * otherwise it is placed on the shared queue. Sleeping workers are
+ * woken up.</p>
+ * @param [in] object thread pool instance.
+ * @param [in] task to be copied and executed later.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED if there is not
+ * enough memory to queue the task, the caller should then execute the task
+ * itself.
+ */
+int rock_thread_pool_spawn(struct rock_thread_pool *object,
+                           const struct rock_thread_pool_task *task);
+
+/**
+ * @brief Find a task and execute it.
+ * @param [in] object thread pool instance.
+ * @param [in] worker of the calling thread or <i>NULL</i>.
+ * @return True if a task was executed, false if no task was found.
+ */
+bool rock_thread_pool_execute(struct rock_thread_pool *object,
+                              struct rock_thread_pool_worker *worker);
+
+/**
+ * @brief Wait until remaining has dropped to zero.
+ * <p>A worker keeps on executing tasks while it waits, any other thread
+ * sleeps until it is woken by {@link rock_thread_pool_complete}.</p>
+ * @param [in] object thread pool instance.
+ * @param [in] remaining amount of outstanding work.
+ */
+void rock_thread_pool_wait(struct rock_thread_pool *object,
+                           atomic_uintmax_t *remaining);
+
+/**
+ * @brief Account for finished work.
+ * @param [in] object thread pool instance.
+ * @param [in] remaining amount of outstanding work.
+ * @param [in] amount of work that has been finished.
+ * @note remaining must not be accessed by the caller afterwards as the
+ * waiting thread may have already returned.
+ */
+void rock_thread_pool_complete(struct rock_thread_pool *object,
+                               atomic_uintmax_t *remaining,
+                               uintmax_t amount);
+
+#endif /* _ROCK_PRIVATE_THREAD_POOL_H_ */
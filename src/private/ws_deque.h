@@ -0,0 +1,86 @@
+#ifndef _ROCK_PRIVATE_WS_DEQUE_H_
+#define _ROCK_PRIVATE_WS_DEQUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* slots are made of words so that thieves may read them atomically */
+struct rock_ws_deque_buffer {
+    struct rock_ws_deque_buffer *retired;
+    uintmax_t capacity;
+    atomic_uintptr_t data[];
+};
+
+struct rock_ws_deque;
+
+/**
+ * @brief Allocate a buffer.
+ * @param [in] size of an item.
+ * @param [in] capacity of the buffer which must be a power of two.
+ * @param [out] out receive the buffer.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to allocate the buffer.
+ */
+int rock_ws_deque_buffer_of(size_t size,
+                            uintmax_t capacity,
+                            struct rock_ws_deque_buffer **out);
+
+/**
+ * @brief Number of words in the slot of an item.
+ * @param [in] size of an item.
+ * @return slot length in words.
+ */
+size_t rock_ws_deque_buffer_words(size_t size);
+
+void *rock_ws_deque_buffer_address(const struct rock_ws_deque_buffer *buffer,
+                                   size_t size,
+                                   intmax_t at);
+
+/**
+ * @brief Copy an item into its slot.
+ * <p>Words are written with relaxed atomic stores so that thieves reading
+ * the slot concurrently do not race with the owner.</p>
+ * @param [in] buffer to write to.
+ * @param [in] size of an item.
+ * @param [in] at index of the slot.
+ * @param [in] item to be copied.
+ */
+void rock_ws_deque_buffer_store(struct rock_ws_deque_buffer *buffer,
+                                size_t size,
+                                intmax_t at,
+                                const void *item);
+
+/**
+ * @brief Copy an item out of its slot.
+ * <p>Words are read with relaxed atomic loads. A thief may observe a torn
+ * item if the owner reuses the slot, in which case its claim on top fails
+ * and the copy is discarded.</p>
+ * @param [in] buffer to read from.
+ * @param [in] size of an item.
+ * @param [in] at index of the slot.
+ * @param [out] out receive the item.
+ */
+void rock_ws_deque_buffer_load(const struct rock_ws_deque_buffer *buffer,
+                               size_t size,
+                               intmax_t at,
+                               void *out);
+
+/**
+ * @brief Double the capacity.
+ * <p>Items between top and bottom are copied into the new buffer which is
+ * then published to thieves. The previous buffer is retired.</p>
+ * @param [in] object work-stealing deque instance.
+ * @param [in] top index of the first item.
+ * @param [in] bottom index one past the last item.
+ * @return On success <i>0</i>, otherwise an error code.
+ * @throws ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to grow the buffer.
+ */
+int rock_ws_deque_grow(struct rock_ws_deque *object,
+                       intmax_t top,
+                       intmax_t bottom);
+
+#endif /* _ROCK_PRIVATE_WS_DEQUE_H_ */
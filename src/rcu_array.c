@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/rcu_array.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+int rock_rcu_array_init(struct rock_rcu_array *const object,
+                        const size_t size) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!size) {
+        return ROCK_RCU_ARRAY_ERROR_SIZE_IS_ZERO;
+    }
+    struct rock_rcu_array_snapshot *const snapshot
+            = calloc(1, sizeof(*snapshot));
+    if (!snapshot) {
+        return ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    int error;
+    if ((error = rock_array_init(&snapshot->array, size, 0))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        free(snapshot);
+        return ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    atomic_init(&object->current, snapshot);
+    atomic_init(&object->epoch, 1);
+    object->retired = NULL;
+    seagrass_required_true(!rock_linked_list_node_init(&object->readers));
+    seagrass_required_true(!pthread_mutex_init(&object->mutex, NULL));
+    object->size = size;
+    return 0;
+}
+
+int rock_rcu_array_invalidate(struct rock_rcu_array *const object,
+                              void (*const on_destroy)(void *)) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    struct rock_rcu_array_snapshot *snapshot = atomic_load(&object->current);
+    seagrass_required_true(!rock_array_invalidate(&snapshot->array,
+                                                  on_destroy));
+    free(snapshot);
+    for (snapshot = object->retired; snapshot;) {
+        struct rock_rcu_array_snapshot *const retired = snapshot->retired;
+        seagrass_required_true(!rock_array_invalidate(&snapshot->array,
+                                                      NULL));
+        free(snapshot);
+        snapshot = retired;
+    }
+    seagrass_required_true(!pthread_mutex_destroy(&object->mutex));
+    atomic_init(&object->current, NULL);
+    atomic_init(&object->epoch, 0);
+    object->retired = NULL;
+    object->size = 0;
+    return 0;
+}
+
+int rock_rcu_array_size(const struct rock_rcu_array *const object,
+                        size_t *const out) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL;
+    }
+    *out = object->size;
+    return 0;
+}
+
+int rock_rcu_array_register(struct rock_rcu_array *const object,
+                            struct rock_rcu_array_reader *const reader) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!reader) {
+        return ROCK_RCU_ARRAY_ERROR_READER_IS_NULL;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    atomic_init(&reader->epoch, atomic_load(&object->epoch));
+    seagrass_required_true(!rock_linked_list_node_init(&reader->node));
+    seagrass_required_true(!rock_linked_list_insert_before(
+            &object->readers, &reader->node));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+int rock_rcu_array_unregister(struct rock_rcu_array *const object,
+                              struct rock_rcu_array_reader *const reader) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!reader) {
+        return ROCK_RCU_ARRAY_ERROR_READER_IS_NULL;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    seagrass_required_true(!rock_linked_list_remove(&reader->node));
+    rock_rcu_array_reclaim(object);
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+int rock_rcu_array_acquire(const struct rock_rcu_array *const object,
+                           const struct rock_array **const out) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL;
+    }
+    struct rock_rcu_array *const array = (struct rock_rcu_array *) object;
+    const struct rock_rcu_array_snapshot *const snapshot
+            = atomic_load_explicit(&array->current, memory_order_acquire);
+    *out = &snapshot->array;
+    return 0;
+}
+
+int rock_rcu_array_quiescent(const struct rock_rcu_array *const object,
+                             struct rock_rcu_array_reader *const reader) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!reader) {
+        return ROCK_RCU_ARRAY_ERROR_READER_IS_NULL;
+    }
+    struct rock_rcu_array *const array = (struct rock_rcu_array *) object;
+    /* release so that our reads of older snapshots happen before they are
+     * freed by the writer that observes this epoch */
+    atomic_store_explicit(
+            &reader->epoch,
+            atomic_load_explicit(&array->epoch, memory_order_acquire),
+            memory_order_release);
+    return 0;
+}
+
+int rock_rcu_array_copy(struct rock_rcu_array *const object,
+                        struct rock_array *const out) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL;
+    }
+    int error;
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    const struct rock_array *const array
+            = &atomic_load(&object->current)->array;
+    if ((error = rock_array_init(out, object->size, array->length))
+        || (error = rock_array_set_length(out, array->length))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+        return ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if (array->length) {
+        memcpy(out->data, array->data, object->size * array->length);
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+void rock_rcu_array_reclaim(struct rock_rcu_array *const object) {
+    seagrass_required(object);
+    if (!object->retired) {
+        return;
+    }
+    uintmax_t minimum = atomic_load(&object->epoch);
+    for (struct rock_linked_list_node *node = object->readers.next;
+         node != &object->readers;
+         node = node->next) {
+        struct rock_rcu_array_reader *const reader
+                = rock_container_of(node, struct rock_rcu_array_reader, node);
+        const uintmax_t epoch = atomic_load_explicit(&reader->epoch,
+                                                     memory_order_acquire);
+        if (epoch < minimum) {
+            minimum = epoch;
+        }
+    }
+    /* retired snapshots are kept newest first */
+    struct rock_rcu_array_snapshot **link = &object->retired;
+    while (*link && (*link)->epoch > minimum) {
+        link = &(*link)->retired;
+    }
+    struct rock_rcu_array_snapshot *snapshot = *link;
+    *link = NULL;
+    while (snapshot) {
+        struct rock_rcu_array_snapshot *const retired = snapshot->retired;
+        seagrass_required_true(!rock_array_invalidate(&snapshot->array,
+                                                      NULL));
+        free(snapshot);
+        snapshot = retired;
+    }
+}
+
+int rock_rcu_array_publish(struct rock_rcu_array *const object,
+                           struct rock_array *const array) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    if (!array) {
+        return ROCK_RCU_ARRAY_ERROR_ARRAY_IS_NULL;
+    }
+    seagrass_required_true(object->size == array->size);
+    struct rock_rcu_array_snapshot *const snapshot
+            = calloc(1, sizeof(*snapshot));
+    if (!snapshot) {
+        return ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    snapshot->array = *array;
+    *array = (struct rock_array) {0};
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    struct rock_rcu_array_snapshot *const previous
+            = atomic_exchange(&object->current, snapshot);
+    /* readers that observe the new epoch can no longer hold previous */
+    previous->epoch = 1 + atomic_fetch_add(&object->epoch, 1);
+    previous->retired = object->retired;
+    object->retired = previous;
+    rock_rcu_array_reclaim(object);
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    return 0;
+}
+
+int rock_rcu_array_synchronize(struct rock_rcu_array *const object) {
+    if (!object) {
+        return ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL;
+    }
+    while (true) {
+        seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+        rock_rcu_array_reclaim(object);
+        const bool is_done = !object->retired;
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+        if (is_done) {
+            return 0;
+        }
+        sched_yield();
+    }
+}
@@ -1,8 +1,10 @@
 #include <stdlib.h>
+#include <string.h>
 #include <seagrass.h>
 #include <rock.h>
 
 #include "private/red_black_tree.h"
+#include "private/thread_pool.h"
 
 #ifdef TEST
 #include <test/cmocka.h>
@@ -18,6 +20,27 @@ int rock_red_black_tree_node_init(
     return 0;
 }
 
+int rock_red_black_tree_prefixed_node_init(
+        struct rock_red_black_tree_prefixed_node *const node,
+        const char *const key) {
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (!key) {
+        return ROCK_RED_BLACK_TREE_ERROR_KEY_IS_NULL;
+    }
+    seagrass_required_true(!rock_red_black_tree_node_init(&node->node));
+    uint64_t prefix = 0;
+    for (uintmax_t i = 0; i < sizeof(prefix) && key[i]; i++) {
+        prefix |= (uint64_t) (unsigned char) key[i]
+                << (8 * (sizeof(prefix) - 1 - i));
+    }
+    node->prefix = prefix;
+    return 0;
+}
+
+#if !defined(ROCK_UNCHECKED) || defined(TEST)
+
 int rock_red_black_tree_node_get_parent(
         const struct rock_red_black_tree_node *const node,
         struct rock_red_black_tree_node **const out) {
@@ -121,6 +144,8 @@ int rock_red_black_tree_node_set_right(
     return 0;
 }
 
+#endif
+
 bool rock_red_black_tree_node_is_on_left(
         const struct rock_red_black_tree_node *const node,
         const struct rock_red_black_tree_node *const left) {
@@ -198,8 +223,9 @@ int rock_red_black_tree_prev(const struct rock_red_black_tree_node *node,
     return ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE;
 }
 
-int rock_red_black_tree_rotate_N(struct rock_red_black_tree_node *const Y,
-                                 const bool is_N_left) {
+static inline __attribute__((always_inline)) int rock_red_black_tree_rotate(
+        struct rock_red_black_tree_node *const Y,
+        const bool is_N_left) {
     seagrass_required(Y);
     int (*const get_P)(const struct rock_red_black_tree_node *,
                        struct rock_red_black_tree_node **)
@@ -263,6 +289,14 @@ int rock_red_black_tree_rotate_N(struct rock_red_black_tree_node *const Y,
     return 0;
 }
 
+int rock_red_black_tree_rotate_N(struct rock_red_black_tree_node *const Y,
+                                 const bool is_N_left) {
+    /* a copy for each side, so that the accessors are called directly */
+    return is_N_left
+           ? rock_red_black_tree_rotate(Y, true)
+           : rock_red_black_tree_rotate(Y, false);
+}
+
 int rock_red_black_tree_rotate_left(
         struct rock_red_black_tree_node *const Y) {
     if (!Y) {
@@ -343,6 +377,208 @@ int rock_red_black_tree_rotate_right_left(
     return rock_red_black_tree_rotate_N_O(Y, false);
 }
 
+static uintmax_t rock_red_black_tree_size(
+        const struct rock_red_black_tree_node *const node) {
+    if (!node) {
+        return 0;
+    }
+    return rock_container_of(node, struct rock_red_black_tree_sized_node,
+                             node)->size;
+}
+
+static bool rock_red_black_tree_size_compute(
+        struct rock_red_black_tree_node *const node) {
+    struct rock_red_black_tree_node *left, *right;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(node, &right));
+    const uintmax_t size = 1 + rock_red_black_tree_size(left)
+                           + rock_red_black_tree_size(right);
+    struct rock_red_black_tree_sized_node *const sized
+            = rock_container_of(node, struct rock_red_black_tree_sized_node,
+                                node);
+    if (size == sized->size) {
+        return false;
+    }
+    sized->size = size;
+    return true;
+}
+
+static void rock_red_black_tree_size_propagate(
+        struct rock_red_black_tree_node *node,
+        const struct rock_red_black_tree_node *const stop) {
+    while (node && node != stop && rock_red_black_tree_size_compute(node)) {
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &node));
+    }
+}
+
+static void rock_red_black_tree_size_copy(
+        const struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const other) {
+    rock_container_of(other, struct rock_red_black_tree_sized_node, node)->size
+            = rock_red_black_tree_size(node);
+}
+
+static void rock_red_black_tree_size_rotate(
+        struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const top) {
+    rock_red_black_tree_size_copy(node, top);
+    rock_red_black_tree_size_compute(node);
+}
+
+const struct rock_red_black_tree_augment rock_red_black_tree_size_augment = {
+        .propagate = rock_red_black_tree_size_propagate,
+        .copy = rock_red_black_tree_size_copy,
+        .rotate = rock_red_black_tree_size_rotate
+};
+
+void rock_red_black_tree_update(
+        const struct rock_red_black_tree_augment *const augment,
+        struct rock_red_black_tree_node *const node) {
+    seagrass_required(node);
+    if (!augment) {
+        return;
+    }
+    struct rock_red_black_tree_node *parent;
+    seagrass_required_true(!rock_red_black_tree_node_get_parent(
+            node, &parent));
+    augment->propagate(node, parent);
+}
+
+void rock_red_black_tree_propagate(
+        const struct rock_red_black_tree_augment *const augment,
+        struct rock_red_black_tree_node *const node,
+        const struct rock_red_black_tree_node *const stop) {
+    if (!augment || !node) {
+        return;
+    }
+    augment->propagate(node, stop);
+}
+
+void rock_red_black_tree_linked(
+        const struct rock_red_black_tree_augment *const augment,
+        struct rock_red_black_tree_node *const node) {
+    seagrass_required(node);
+    if (!augment) {
+        return;
+    }
+    /* the value of node may be stale, so it is recomputed before the
+     * ancestors whose values only change if the subtree did */
+    rock_red_black_tree_update(augment, node);
+    struct rock_red_black_tree_node *parent;
+    seagrass_required_true(!rock_red_black_tree_node_get_parent(
+            node, &parent));
+    rock_red_black_tree_propagate(augment, parent, NULL);
+}
+
+void rock_red_black_tree_rotated(
+        const struct rock_red_black_tree_augment *const augment,
+        struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const top) {
+    seagrass_required(node);
+    seagrass_required(top);
+    if (!augment) {
+        return;
+    }
+    augment->rotate(node, top);
+}
+
+void rock_red_black_tree_extremes(struct rock_red_black_tree *const object) {
+    seagrass_required(object);
+    if (!object->is_cached) {
+        return;
+    }
+    if (!object->root) {
+        object->leftmost = NULL;
+        object->rightmost = NULL;
+        return;
+    }
+    rock_red_black_tree_minimum(object->root, &object->leftmost);
+    rock_red_black_tree_maximum(object->root, &object->rightmost);
+}
+
+static void rock_red_black_tree_cache_linked(
+        struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const parent,
+        struct rock_red_black_tree_node *const node,
+        const bool is_N_left) {
+    seagrass_required(object);
+    seagrass_required(node);
+    if (!object->is_cached) {
+        return;
+    }
+    if (!parent) {
+        object->leftmost = node;
+        object->rightmost = node;
+    } else if (is_N_left && parent == object->leftmost) {
+        /* only a node linked below the leftmost can precede it */
+        object->leftmost = node;
+    } else if (!is_N_left && parent == object->rightmost) {
+        object->rightmost = node;
+    }
+}
+
+static void rock_red_black_tree_cache_unlinked(
+        struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const node) {
+    seagrass_required(object);
+    seagrass_required(node);
+    if (!object->is_cached) {
+        return;
+    }
+    if (node == object->leftmost
+        && rock_red_black_tree_next(node, &object->leftmost)) {
+        object->leftmost = NULL;
+    }
+    if (node == object->rightmost
+        && rock_red_black_tree_prev(node, &object->rightmost)) {
+        object->rightmost = NULL;
+    }
+}
+
+static inline int rock_red_black_tree_compare(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const first,
+        const struct rock_red_black_tree_node *const second) {
+    if (object->is_prefixed) {
+        const uint64_t x = rock_container_of(
+                first, struct rock_red_black_tree_prefixed_node, node)->prefix;
+        const uint64_t y = rock_container_of(
+                second, struct rock_red_black_tree_prefixed_node, node)->prefix;
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    const char *const a = (const char *) first + object->key_offset;
+    const char *const b = (const char *) second + object->key_offset;
+    switch (object->key_kind) {
+        case ROCK_RED_BLACK_TREE_KEY_UINT64: {
+            const uint64_t x = *(const uint64_t *) a;
+            const uint64_t y = *(const uint64_t *) b;
+            return (x > y) - (x < y);
+        }
+        case ROCK_RED_BLACK_TREE_KEY_INT64: {
+            const int64_t x = *(const int64_t *) a;
+            const int64_t y = *(const int64_t *) b;
+            return (x > y) - (x < y);
+        }
+        case ROCK_RED_BLACK_TREE_KEY_DOUBLE: {
+            const double x = *(const double *) a;
+            const double y = *(const double *) b;
+            return (x > y) - (x < y);
+        }
+        case ROCK_RED_BLACK_TREE_KEY_STRING: {
+            return strcmp(*(const char *const *) a, *(const char *const *) b);
+        }
+        case ROCK_RED_BLACK_TREE_KEY_CHARS: {
+            return strcmp(a, b);
+        }
+        default: { /* ROCK_RED_BLACK_TREE_KEY_CALLBACK */
+            return object->compare(first, second);
+        }
+    }
+}
+
 int rock_red_black_tree_init(
         struct rock_red_black_tree *const object,
         int (*const compare)(const struct rock_red_black_tree_node *first,
@@ -358,434 +594,1512 @@ int rock_red_black_tree_init(
     return 0;
 }
 
-int rock_red_black_tree_invalidate(
+int rock_red_black_tree_init_order_statistic(
         struct rock_red_black_tree *const object,
-        void (*const on_destroy)(struct rock_red_black_tree_node *node)) {
+        int (*const compare)(const struct rock_red_black_tree_node *first,
+                             const struct rock_red_black_tree_node *second)) {
+    int error;
+    if ((error = rock_red_black_tree_init(object, compare))) {
+        return error;
+    }
+    object->augment = &rock_red_black_tree_size_augment;
+    return 0;
+}
+
+int rock_red_black_tree_init_keyed(struct rock_red_black_tree *const object,
+                                  const ptrdiff_t key_offset,
+                                  const int key_kind) {
     if (!object) {
         return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
     }
-    for (struct rock_red_black_tree_node *node = object->root; node;) {
-        struct rock_red_black_tree_node *next;
-        seagrass_required_true(!rock_red_black_tree_node_get_left(
-                node, &next));
-        if (next) {
-            seagrass_required_true(!rock_red_black_tree_node_set_left(
-                    node, NULL));
-            node = next;
-            continue;
-        }
-        seagrass_required_true(!rock_red_black_tree_node_get_right(
-                node, &next));
-        if (next) {
-            seagrass_required_true(!rock_red_black_tree_node_set_right(
-                    node, NULL));
-            node = next;
-            continue;
-        }
-        seagrass_required_true(!rock_red_black_tree_node_get_parent(
-                node, &next));
-        if (on_destroy) {
-            on_destroy(node);
-        }
-        node = next;
+    if (key_kind < ROCK_RED_BLACK_TREE_KEY_UINT64
+        || key_kind > ROCK_RED_BLACK_TREE_KEY_CHARS) {
+        return ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID;
     }
     *object = (struct rock_red_black_tree) {0};
+    object->key_offset = key_offset;
+    object->key_kind = key_kind;
     return 0;
 }
 
-int rock_red_black_tree_count(const struct rock_red_black_tree *const object,
-                              uintmax_t *const out) {
+int rock_red_black_tree_init_prefixed(
+        struct rock_red_black_tree *const object,
+        const ptrdiff_t key_offset,
+        const int key_kind) {
     if (!object) {
         return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
     }
-    if (!out) {
-        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    if (ROCK_RED_BLACK_TREE_KEY_STRING != key_kind
+        && ROCK_RED_BLACK_TREE_KEY_CHARS != key_kind) {
+        return ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID;
     }
-    *out = object->count;
+    seagrass_required_true(!rock_red_black_tree_init_keyed(
+            object, key_offset, key_kind));
+    object->is_prefixed = true;
     return 0;
 }
 
-int rock_red_black_tree_first(const struct rock_red_black_tree *const object,
-                              struct rock_red_black_tree_node **const out) {
+int rock_red_black_tree_init_cached(
+        struct rock_red_black_tree *const object,
+        int (*const compare)(const struct rock_red_black_tree_node *first,
+                             const struct rock_red_black_tree_node *second)) {
+    int error;
+    if ((error = rock_red_black_tree_init(object, compare))) {
+        return error;
+    }
+    seagrass_required_true(!rock_red_black_tree_set_cached(object, true));
+    return 0;
+}
+
+int rock_red_black_tree_set_cached(struct rock_red_black_tree *const object,
+                                   const bool is_cached) {
     if (!object) {
         return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
     }
-    if (!out) {
-        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
-    }
-    if (!object->root) {
-        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY;
-    }
-    rock_red_black_tree_minimum(object->root, out);
+    object->is_cached = is_cached;
+    object->leftmost = NULL;
+    object->rightmost = NULL;
+    /* a tree that already holds nodes has its extremes found once */
+    rock_red_black_tree_extremes(object);
     return 0;
 }
 
-int rock_red_black_tree_last(const struct rock_red_black_tree *const object,
-                             struct rock_red_black_tree_node **const out) {
+int rock_red_black_tree_init_augmented(
+        struct rock_red_black_tree *const object,
+        int (*const compare)(const struct rock_red_black_tree_node *first,
+                             const struct rock_red_black_tree_node *second),
+        const struct rock_red_black_tree_augment *const augment) {
     if (!object) {
         return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
     }
-    if (!out) {
-        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    if (!compare) {
+        return ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL;
     }
-    if (!object->root) {
-        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY;
+    if (!augment) {
+        return ROCK_RED_BLACK_TREE_ERROR_AUGMENT_IS_NULL;
     }
-    rock_red_black_tree_maximum(object->root, out);
+    if (!augment->propagate || !augment->copy || !augment->rotate) {
+        return ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL;
+    }
+    seagrass_required_true(!rock_red_black_tree_init(object, compare));
+    object->augment = augment;
     return 0;
 }
 
-void rock_red_black_tree_minimum(const struct rock_red_black_tree_node *root,
-                                 struct rock_red_black_tree_node **const out) {
-    seagrass_required(root);
-    seagrass_required(out);
-    struct rock_red_black_tree_node *left;
+int rock_red_black_tree_invalidate(
+        struct rock_red_black_tree *const object,
+        void (*const on_destroy)(struct rock_red_black_tree_node *node)) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    rock_red_black_tree_destroy(object->root, on_destroy);
+    *object = (struct rock_red_black_tree) {0};
+    return 0;
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_post_order_first(
+        struct rock_red_black_tree_node *node) {
+    struct rock_red_black_tree_node *child;
     while (true) {
         seagrass_required_true(!rock_red_black_tree_node_get_left(
-                root, &left));
-        if (!left) {
-            *out = (struct rock_red_black_tree_node *) root;
-            return;
+                node, &child));
+        if (!child) {
+            seagrass_required_true(!rock_red_black_tree_node_get_right(
+                    node, &child));
         }
-        root = left;
+        if (!child) {
+            return node;
+        }
+        node = child;
     }
 }
 
-void rock_red_black_tree_maximum(const struct rock_red_black_tree_node *root,
-                                 struct rock_red_black_tree_node **const out) {
-    seagrass_required(root);
-    seagrass_required(out);
-    struct rock_red_black_tree_node *right;
-    while (true) {
+static void rock_red_black_tree_post_order_subtree(
+        struct rock_red_black_tree_node *const root,
+        void (*const function)(struct rock_red_black_tree_node *, void *),
+        void *const context) {
+    if (!root) {
+        return;
+    }
+    struct rock_red_black_tree_node *node
+            = rock_red_black_tree_post_order_first(root);
+    while (node != root) {
+        /* the successor is found before node is handed out since function
+         * may release it */
+        struct rock_red_black_tree_node *next, *right;
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &next));
         seagrass_required_true(!rock_red_black_tree_node_get_right(
-                root, &right));
-        if (!right) {
-            *out = (struct rock_red_black_tree_node *) root;
-            return;
+                next, &right));
+        if (right && right != node) {
+            next = rock_red_black_tree_post_order_first(right);
         }
-        root = right;
+        function(node, context);
+        node = next;
     }
+    function(root, context);
 }
 
-int rock_red_black_tree_find(
+int rock_red_black_tree_post_order(
         const struct rock_red_black_tree *const object,
-        const struct rock_red_black_tree_node *const root,
-        const struct rock_red_black_tree_node *const needle,
-        struct rock_red_black_tree_node **const out) {
+        void (*const function)(struct rock_red_black_tree_node *node,
+                               void *context),
+        void *const context) {
     if (!object) {
         return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
     }
-    if (!needle) {
-        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;
-    }
-    if (!out) {
-        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    if (!function) {
+        return ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL;
     }
-    *out = NULL;
-    for (struct rock_red_black_tree_node *node
-            = (struct rock_red_black_tree_node *)
-                    (root ? root : object->root); node;) {
-        *out = node;
-        const int result = object->compare(needle, node);
-        if (!result) {
-            return 0;
-        } else if (result < 0) {
-            seagrass_required_true(!rock_red_black_tree_node_get_left(
-                    node, &node));
-        } else {
-            seagrass_required_true(!rock_red_black_tree_node_get_right(
-                    node, &node));
-        }
+    rock_red_black_tree_post_order_subtree(object->root, function, context);
+    return 0;
+}
+
+struct rock_red_black_tree_relocate {
+    struct rock_red_black_tree_node *(*move)(
+            struct rock_red_black_tree_node *, uintmax_t, void *);
+    void *context;
+    uintmax_t index;
+};
+
+static uintmax_t rock_red_black_tree_height(
+        const struct rock_red_black_tree_node *const node) {
+    if (!node) {
+        return 0;
     }
-    return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;
+    struct rock_red_black_tree_node *left, *right;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(node, &right));
+    const uintmax_t a = rock_red_black_tree_height(left);
+    const uintmax_t b = rock_red_black_tree_height(right);
+    return 1 + (a > b ? a : b);
 }
 
-int rock_red_black_tree_insert(struct rock_red_black_tree *const object,
-                               struct rock_red_black_tree_node *parent,
-                               struct rock_red_black_tree_node *child) {
-    if (!object) {
-        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+static void rock_red_black_tree_relocate_node(
+        struct rock_red_black_tree_relocate *const relocate,
+        struct rock_red_black_tree_node *const node) {
+    struct rock_red_black_tree_node *const copy = relocate->move(
+            node, relocate->index++, relocate->context);
+    seagrass_required(copy);
+    /* the tree is only walked downwards while nodes are moved, hence the
+     * parent link of the former location can forward to the copy */
+    seagrass_required_true(!rock_red_black_tree_node_set_parent(node, copy));
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_relocated(
+        const struct rock_red_black_tree_node *const node) {
+    struct rock_red_black_tree_node *copy = NULL;
+    if (node) {
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &copy));
     }
-    if (!child) {
-        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    return copy;
+}
+
+static void rock_red_black_tree_relocate_subtree(
+        struct rock_red_black_tree_relocate *relocate,
+        struct rock_red_black_tree_node *node,
+        uintmax_t height);
+
+static void rock_red_black_tree_relocate_level(
+        struct rock_red_black_tree_relocate *const relocate,
+        struct rock_red_black_tree_node *const node,
+        const uintmax_t depth,
+        const uintmax_t height) {
+    if (!node) {
+        return;
     }
-    if (!parent && object->root) {
-        return ROCK_RED_BLACK_TREE_ERROR_INSERTION_POINT_IS_NULL;
+    if (!depth) {
+        rock_red_black_tree_relocate_subtree(relocate, node, height);
+        return;
     }
-    /* reset child node */
-    seagrass_required_true(!rock_red_black_tree_node_init(
-            child));
-    bool color;
-    /* insert */
-    if (!parent) {
-        parent = object->root;
+    struct rock_red_black_tree_node *left, *right;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(node, &right));
+    rock_red_black_tree_relocate_level(relocate, left, depth - 1, height);
+    rock_red_black_tree_relocate_level(relocate, right, depth - 1, height);
+}
+
+static void rock_red_black_tree_relocate_subtree(
+        struct rock_red_black_tree_relocate *const relocate,
+        struct rock_red_black_tree_node *const node,
+        const uintmax_t height) {
+    seagrass_required(node);
+    if (1 == height) {
+        rock_red_black_tree_relocate_node(relocate, node);
+        return;
     }
-    if (!parent) {
-        object->root = child;
-    } else {
-        const int result = object->compare(child, parent);
-        if (!result) { /* duplicates are not allowed */
-            return ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS;
-        }
-        const bool is_N_left = result < 0;
-        int (*const get_N)(const struct rock_red_black_tree_node *,
-                           struct rock_red_black_tree_node **)
-        = is_N_left
-          ? rock_red_black_tree_node_get_left
-          : rock_red_black_tree_node_get_right;
-        int (*const set_N)(struct rock_red_black_tree_node *,
-                            struct rock_red_black_tree_node *)
-        = is_N_left
-          ? rock_red_black_tree_node_set_left
-          : rock_red_black_tree_node_set_right;
-        struct rock_red_black_tree_node *node;
-        seagrass_required_true(!get_N(parent, &node));
-        if (node) { /* replace existing node in parent */
-            seagrass_required_true(!rock_red_black_tree_node_get_color(
-                    node, &color));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    node, ROCK_RED_BLACK_TREE_COLOR_RED));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    child, color));
-            seagrass_required_true(!rock_red_black_tree_node_set_parent(
-                    child, parent));
-            seagrass_required_true(!set_N(parent, child));
-            parent = child;
-            child = node;
-        }
-        seagrass_required_true(!rock_red_black_tree_node_set_parent(
-                child, parent));
-        seagrass_required_true(!set_N(parent, child));
+    /* the top half is laid out ahead of every subtree hanging below it */
+    const uintmax_t top = height / 2;
+    rock_red_black_tree_relocate_subtree(relocate, node, top);
+    rock_red_black_tree_relocate_level(relocate, node, top, height - top);
+}
+
+static void rock_red_black_tree_relocate_link(
+        const struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const parent) {
+    struct rock_red_black_tree_node *const copy
+            = rock_red_black_tree_relocated(node);
+    struct rock_red_black_tree_node *left, *right;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(node, &right));
+    seagrass_required_true(!rock_red_black_tree_node_set_parent(
+            copy, parent));
+    seagrass_required_true(!rock_red_black_tree_node_set_left(
+            copy, rock_red_black_tree_relocated(left)));
+    seagrass_required_true(!rock_red_black_tree_node_set_right(
+            copy, rock_red_black_tree_relocated(right)));
+    if (left) {
+        rock_red_black_tree_relocate_link(left, copy);
     }
-    seagrass_required_true(!seagrass_uintmax_t_add(
-            1, object->count, &object->count));
-    /* repair */
-    while (true) {
-        seagrass_required_true(!rock_red_black_tree_node_get_color(
-                child, &color));
-        seagrass_required_true(ROCK_RED_BLACK_TREE_COLOR_RED == color);
-        if (!parent) {
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    child, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-            return 0;
-        }
-        seagrass_required_true(!rock_red_black_tree_node_get_color(
-                parent, &color));
-        /* case 1: parent is BLACK */
-        if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
-            return 0;
-        }
-        struct rock_red_black_tree_node *grandparent, *sibling;
-        seagrass_required_true(!rock_red_black_tree_node_get_parent(
-                parent, &grandparent));
-        seagrass_required_true(!rock_red_black_tree_node_get_left(
-                grandparent, &sibling));
-        if (sibling == parent) {
-            seagrass_required_true(!rock_red_black_tree_node_get_right(
-                    grandparent, &sibling));
-        }
-        seagrass_required_true(!rock_red_black_tree_node_get_color(
-                sibling, &color));
-        /* Legend: C - child            B - BLACK
-         *         P - parent           R - RED
-         *         G - grandparent
-         *         S - sibling
-         */
-        /* case 2a: parent's sibling is RED */
-        if (ROCK_RED_BLACK_TREE_COLOR_RED == color) {
-            /*         G(B)                      G(R)
-             *         /  \                      /  \
-             *      P(R)  S(R)       =>       P(B)  S(B)
-             *      /                         /
-             *   C(R)                       C(R)
-             * --------------------- or ---------------------
-             *         G(B)                      G(R)
-             *         /  \                      /  \
-             *      S(R)  P(R)       =>       S(B)  P(B)
-             *              \                         \
-             *              C(R)                      C(R)
-             */
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    parent, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    sibling, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    grandparent, ROCK_RED_BLACK_TREE_COLOR_RED));
-            /* Changing grandparent to RED may have introduced two consecutive
-             * REDs - grandparent and possibly great-grandparent. We will
-             * iterate to correct this violation.
-             */
-            child = grandparent;
-            seagrass_required_true(!rock_red_black_tree_node_get_parent(
-                    child, &parent));
-            continue;
-        }
-        /* case 2b: parent's sibling is BLACK */
-        const bool is_parent_left = rock_red_black_tree_node_is_on_left(
-                grandparent, parent);
-        const bool is_child_left = rock_red_black_tree_node_is_on_left(
-                parent, child);
-        switch (is_parent_left << 1 | is_child_left) {
-            /*         G(B)                      P(B)
-             *         /  \                      /  \
-             *     S(B)    P(R)      =>       G(R)   C(R)
-             *                \                /
-             *                C(R)           S(B)
-             * --------------------- or ---------------------
-             *         G(B)                      P(B)
-             *         /  \                      /  \
-             *     P(R)    S(B)      =>      C(R)    G(R)
-             *     /                                    \
-             *  C(R)                                    S(B)
-             */
-            case 0:
-            case 3: {
-                seagrass_required_true(!rock_red_black_tree_rotate_N(
-                        parent, !is_parent_left));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        parent, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        grandparent, ROCK_RED_BLACK_TREE_COLOR_RED));
-                if (object->root == grandparent) {
-                    object->root = parent;
-                }
-                return 0;
-            }
-                /*         G(B)                      C(B)
-                 *         /  \                      /  \
-                 *     S(B)    P(R)      =>       G(R)   P(R)
-                 *             /                   /
-                 *           C(R)                S(B)
-                 * --------------------- or ---------------------
-                 *         G(B)                      C(B)
-                 *         /  \                      /  \
-                 *     P(R)    S(B)      =>      P(R)    G(R)
-                 *        \                                 \
-                 *        C(R)                              S(B)
-                 */
-            case 1:
-            case 2: {
-                seagrass_required_true(!rock_red_black_tree_rotate_N_O(
-                        child, !is_child_left));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        child, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        grandparent, ROCK_RED_BLACK_TREE_COLOR_RED));
-                if (object->root == grandparent) {
-                    object->root = child;
-                }
-                return 0;
-            }
-        }
+    if (right) {
+        rock_red_black_tree_relocate_link(right, copy);
     }
 }
 
-int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
-                               struct rock_red_black_tree_node *const node) {
+int rock_red_black_tree_relocate(
+        struct rock_red_black_tree *const object,
+        const int layout,
+        struct rock_red_black_tree_node *(*const move)(
+                struct rock_red_black_tree_node *node,
+                uintmax_t index,
+                void *context),
+        void *const context) {
     if (!object) {
         return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
     }
-    if (!node) {
-        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    if (ROCK_RED_BLACK_TREE_LAYOUT_BREADTH_FIRST != layout
+        && ROCK_RED_BLACK_TREE_LAYOUT_VAN_EMDE_BOAS != layout) {
+        return ROCK_RED_BLACK_TREE_ERROR_LAYOUT_IS_INVALID;
     }
-    /* remove */
-    bool color;
-    struct rock_red_black_tree_node *left, *right, *parent, *double_black = NULL;
-    while (!double_black) {
-        seagrass_required_true(!rock_red_black_tree_node_get_color(
-                node, &color));
-        seagrass_required_true(!rock_red_black_tree_node_get_left(
-                node, &left));
-        seagrass_required_true(!rock_red_black_tree_node_get_right(
-                node, &right));
-        seagrass_required_true(!rock_red_black_tree_node_get_parent(
-                node, &parent));
-        switch ((NULL == left) << 1 | (NULL == right)) {
-            case 3: { /* node with no children */
-                if (parent) {
-                    int (*const set_N)(struct rock_red_black_tree_node *,
-                                       struct rock_red_black_tree_node *)
-                    = rock_red_black_tree_node_is_on_left(parent, node)
-                      ? rock_red_black_tree_node_set_left
-                      : rock_red_black_tree_node_set_right;
-                    seagrass_required_true(!set_N(parent, NULL));
-                }
-                seagrass_required_true(!seagrass_uintmax_t_subtract(
-                        object->count, 1, &object->count));
-                if (node == object->root) {
-                    object->root = NULL;
-                } else if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
-                    double_black = node;
-                    continue;
-                }
-                return 0;
-            }
-            case 2:
-            case 1: { /* node with single child */
-                void *child = left ? left : right;
-                /* 'child' to replace 'node' */
-                bool color_;
-                seagrass_required_true(!rock_red_black_tree_node_get_color(
-                        child, &color_));
-                if (parent) {
-                    int (*const set_N)(struct rock_red_black_tree_node *,
-                                       struct rock_red_black_tree_node *)
-                    = rock_red_black_tree_node_is_on_left(parent, node)
-                      ? rock_red_black_tree_node_set_left
-                      : rock_red_black_tree_node_set_right;
-                    seagrass_required_true(!set_N(parent, child));
-                }
-                seagrass_required_true(!rock_red_black_tree_node_set_parent(
-                        child, parent));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        child, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-                if (node == object->root) {
-                    object->root = child;
-                }
-                seagrass_required_true(!seagrass_uintmax_t_subtract(
-                        object->count, 1, &object->count));
-                if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color
-                    && ROCK_RED_BLACK_TREE_COLOR_BLACK == color_) {
-                    double_black = child;
-                    continue;
-                }
-                return 0;
-            }
-            case 0: { /* node with two children */
-                struct rock_red_black_tree_node *next;
-                seagrass_required_true(!rock_red_black_tree_next(
-                        node, &next));
-                /* swap 'next' with 'node' */
-                bool color_;
-                seagrass_required_true(!rock_red_black_tree_node_get_color(
-                        next, &color_));
-                struct rock_red_black_tree_node *parent_, *left_, *right_;
-                seagrass_required_true(!rock_red_black_tree_node_get_parent(
-                        next, &parent_));
-                seagrass_required_true(!rock_red_black_tree_node_get_left(
-                        next, &left_));
-                seagrass_required_true(!rock_red_black_tree_node_get_right(
-                        next, &right_));
+    if (!move) {
+        return ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL;
+    }
+    if (!object->root) {
+        return 0;
+    }
+    struct rock_red_black_tree_relocate relocate = {
+            .move = move,
+            .context = context
+    };
+    const uintmax_t height = rock_red_black_tree_height(object->root);
+    if (ROCK_RED_BLACK_TREE_LAYOUT_VAN_EMDE_BOAS == layout) {
+        rock_red_black_tree_relocate_subtree(&relocate, object->root, height);
+    } else {
+        for (uintmax_t depth = 0; depth < height; depth++) {
+            rock_red_black_tree_relocate_level(&relocate, object->root,
+                                               depth, 1);
+        }
+    }
+    seagrass_required_true(object->count == relocate.index);
+    /* the former locations still hold the child links to walk down */
+    rock_red_black_tree_relocate_link(object->root, NULL);
+    object->root = rock_red_black_tree_relocated(object->root);
+    rock_red_black_tree_extremes(object);
+    return 0;
+}
 
-                seagrass_required_true(!rock_red_black_tree_node_set_parent(
-                        node, node == parent_ ? next : parent_));
-                seagrass_required_true(!rock_red_black_tree_node_set_parent(
-                        next, next == parent ? node : parent));
-                seagrass_required_true(!rock_red_black_tree_node_set_left(
-                        node, node == left_ ? next : left_));
-                seagrass_required_true(!rock_red_black_tree_node_set_left(
-                        next, next == left ? node : left));
-                seagrass_required_true(!rock_red_black_tree_node_set_right(
-                        node, node == right_ ? next : right_));
-                seagrass_required_true(!rock_red_black_tree_node_set_right(
-                        next, next == right ? node : right));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        node, color_));
-                seagrass_required_true(!rock_red_black_tree_node_set_color(
-                        next, color));
+struct rock_red_black_tree_teardown {
+    void (*on_destroy)(struct rock_red_black_tree_node *);
+    void (*on_destroy_batch)(struct rock_red_black_tree_node **, uintmax_t);
+    struct rock_thread_pool *pool;
+    /* size nodes for every thread of the budget */
+    struct rock_red_black_tree_node **nodes;
+    uintmax_t size;
+    uintmax_t count;
+    uintmax_t grain;
+};
 
-                if (parent_ && node != parent_) {
-                    int (*const set_N)(struct rock_red_black_tree_node *,
+struct rock_red_black_tree_teardown_batch {
+    const struct rock_red_black_tree_teardown *teardown;
+    struct rock_red_black_tree_node **nodes;
+    uintmax_t count;
+};
+
+static void rock_red_black_tree_teardown_destroy(
+        struct rock_red_black_tree_node *const node,
+        void *const context) {
+    const struct rock_red_black_tree_teardown_batch *const batch = context;
+    batch->teardown->on_destroy(node);
+}
+
+static void rock_red_black_tree_teardown_flush(
+        struct rock_red_black_tree_teardown_batch *const batch) {
+    if (batch->count) {
+        batch->teardown->on_destroy_batch(batch->nodes, batch->count);
+        batch->count = 0;
+    }
+}
+
+static void rock_red_black_tree_teardown_add(
+        struct rock_red_black_tree_node *const node,
+        void *const context) {
+    struct rock_red_black_tree_teardown_batch *const batch = context;
+    batch->nodes[batch->count++] = node;
+    if (batch->count == batch->teardown->size) {
+        rock_red_black_tree_teardown_flush(batch);
+    }
+}
+
+struct rock_red_black_tree_teardown_fork {
+    const struct rock_red_black_tree_teardown *teardown;
+    struct rock_red_black_tree_node *node;
+    uintmax_t offset;
+    uintmax_t threads;
+    uintmax_t depth;
+    atomic_uintmax_t remaining;
+};
+
+static void rock_red_black_tree_teardown_apply(
+        const struct rock_red_black_tree_teardown *teardown,
+        struct rock_red_black_tree_node *node,
+        uintmax_t offset,
+        uintmax_t threads,
+        uintmax_t depth);
+
+static void rock_red_black_tree_teardown_run(void *const context,
+                                             const uintmax_t begin,
+                                             const uintmax_t end) {
+    struct rock_red_black_tree_teardown_fork *const fork = context;
+    rock_red_black_tree_teardown_apply(fork->teardown, fork->node,
+                                       fork->offset, fork->threads,
+                                       fork->depth);
+    rock_thread_pool_complete(fork->teardown->pool, &fork->remaining, 1);
+}
+
+static void rock_red_black_tree_teardown_apply(
+        const struct rock_red_black_tree_teardown *const teardown,
+        struct rock_red_black_tree_node *const node,
+        const uintmax_t offset,
+        const uintmax_t threads,
+        const uintmax_t depth) {
+    if (!node) {
+        return;
+    }
+    /* every thread of the budget owns its own batch */
+    struct rock_red_black_tree_teardown_batch batch = {
+            .teardown = teardown,
+            .nodes = teardown->nodes
+                     ? teardown->nodes + offset * teardown->size
+                     : NULL
+    };
+    void (*const function)(struct rock_red_black_tree_node *, void *)
+    = teardown->on_destroy_batch
+      ? rock_red_black_tree_teardown_add
+      : rock_red_black_tree_teardown_destroy;
+    /* the nodes are assumed to halve with every level */
+    if (threads < 2 || (teardown->count >> depth) <= teardown->grain) {
+        rock_red_black_tree_post_order_subtree(node, function, &batch);
+        rock_red_black_tree_teardown_flush(&batch);
+        return;
+    }
+    struct rock_red_black_tree_node *left, *right;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(node, &right));
+    struct rock_red_black_tree_teardown_fork fork = {
+            .teardown = teardown,
+            .node = left,
+            .offset = offset,
+            .threads = threads / 2,
+            .depth = 1 + depth
+    };
+    atomic_init(&fork.remaining, 1);
+    const struct rock_thread_pool_task task = {
+            .function = rock_red_black_tree_teardown_run,
+            .context = &fork
+    };
+    if (rock_thread_pool_spawn(teardown->pool, &task)) {
+        rock_red_black_tree_teardown_run(&fork, 0, 0);
+    }
+    rock_red_black_tree_teardown_apply(teardown, right, offset + threads / 2,
+                                       threads - threads / 2, 1 + depth);
+    rock_thread_pool_wait(teardown->pool, &fork.remaining);
+    /* the batch of the left subtree has been flushed and may be reused */
+    function(node, &batch);
+    rock_red_black_tree_teardown_flush(&batch);
+}
+
+static void rock_red_black_tree_teardown_execute(
+        struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_teardown *const teardown,
+        const uintmax_t threads) {
+    seagrass_required(object);
+    seagrass_required(teardown);
+    rock_red_black_tree_teardown_apply(teardown, object->root, 0, threads, 0);
+    *object = (struct rock_red_black_tree) {0};
+}
+
+int rock_red_black_tree_invalidate_parallel(
+        struct rock_red_black_tree *const object,
+        void (*const on_destroy)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *const pool,
+        const uintmax_t grain,
+        const uintmax_t threads) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!pool) {
+        return ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!threads) {
+        return ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO;
+    }
+    if (!on_destroy) { /* nodes are left unmodified, nothing to be done */
+        *object = (struct rock_red_black_tree) {0};
+        return 0;
+    }
+    const struct rock_red_black_tree_teardown teardown = {
+            .on_destroy = on_destroy,
+            .pool = pool,
+            .count = object->count,
+            .grain = grain
+    };
+    rock_red_black_tree_teardown_execute(object, &teardown, threads);
+    return 0;
+}
+
+int rock_red_black_tree_invalidate_batch(
+        struct rock_red_black_tree *const object,
+        void (*const on_destroy)(struct rock_red_black_tree_node **nodes,
+                                 uintmax_t count),
+        const uintmax_t size,
+        struct rock_thread_pool *const pool,
+        const uintmax_t grain,
+        uintmax_t threads) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!on_destroy) {
+        return ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL;
+    }
+    if (!size) {
+        return ROCK_RED_BLACK_TREE_ERROR_SIZE_IS_ZERO;
+    }
+    if (!pool) {
+        return ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!threads) {
+        return ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO;
+    }
+    if (!object->root) {
+        *object = (struct rock_red_black_tree) {0};
+        return 0;
+    }
+    /* a budget beyond the count of nodes would never be spent */
+    if (threads > object->count) {
+        threads = object->count;
+    }
+    int error;
+    uintmax_t count;
+    if ((error = seagrass_uintmax_t_multiply(threads, size, &count))) {
+        seagrass_required_true(
+                SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT == error);
+        return ROCK_RED_BLACK_TREE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    struct rock_red_black_tree_node **const nodes
+            = calloc(count, sizeof(*nodes));
+    if (!nodes) {
+        return ROCK_RED_BLACK_TREE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    const struct rock_red_black_tree_teardown teardown = {
+            .on_destroy_batch = on_destroy,
+            .pool = pool,
+            .nodes = nodes,
+            .size = size,
+            .count = object->count,
+            .grain = grain
+    };
+    rock_red_black_tree_teardown_execute(object, &teardown, threads);
+    free(nodes);
+    return 0;
+}
+
+int rock_red_black_tree_count(const struct rock_red_black_tree *const object,
+                              uintmax_t *const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    *out = object->count;
+    return 0;
+}
+
+int rock_red_black_tree_first(const struct rock_red_black_tree *const object,
+                              struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    if (!object->root) {
+        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY;
+    }
+    if (object->is_cached) {
+        *out = object->leftmost;
+        return 0;
+    }
+    rock_red_black_tree_minimum(object->root, out);
+    return 0;
+}
+
+int rock_red_black_tree_last(const struct rock_red_black_tree *const object,
+                             struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    if (!object->root) {
+        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY;
+    }
+    if (object->is_cached) {
+        *out = object->rightmost;
+        return 0;
+    }
+    rock_red_black_tree_maximum(object->root, out);
+    return 0;
+}
+
+int rock_red_black_tree_pop_first(struct rock_red_black_tree *const object,
+                                  struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    struct rock_red_black_tree_node *node;
+    int error;
+    if ((error = rock_red_black_tree_first(object, &node))) {
+        seagrass_required_true(ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY
+                               == error);
+        return error;
+    }
+    seagrass_required_true(!rock_red_black_tree_remove(object, node));
+    *out = node;
+    return 0;
+}
+
+int rock_red_black_tree_pop_last(struct rock_red_black_tree *const object,
+                                 struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    struct rock_red_black_tree_node *node;
+    int error;
+    if ((error = rock_red_black_tree_last(object, &node))) {
+        seagrass_required_true(ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY
+                               == error);
+        return error;
+    }
+    seagrass_required_true(!rock_red_black_tree_remove(object, node));
+    *out = node;
+    return 0;
+}
+
+void rock_red_black_tree_minimum(const struct rock_red_black_tree_node *root,
+                                 struct rock_red_black_tree_node **const out) {
+    seagrass_required(root);
+    seagrass_required(out);
+    struct rock_red_black_tree_node *left;
+    while (true) {
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                root, &left));
+        if (!left) {
+            *out = (struct rock_red_black_tree_node *) root;
+            return;
+        }
+        root = left;
+    }
+}
+
+void rock_red_black_tree_maximum(const struct rock_red_black_tree_node *root,
+                                 struct rock_red_black_tree_node **const out) {
+    seagrass_required(root);
+    seagrass_required(out);
+    struct rock_red_black_tree_node *right;
+    while (true) {
+        seagrass_required_true(!rock_red_black_tree_node_get_right(
+                root, &right));
+        if (!right) {
+            *out = (struct rock_red_black_tree_node *) root;
+            return;
+        }
+        root = right;
+    }
+}
+
+int rock_red_black_tree_find(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const root,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!needle) {
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    *out = NULL;
+    for (struct rock_red_black_tree_node *node
+            = (struct rock_red_black_tree_node *)
+                    (root ? root : object->root); node;) {
+        *out = node;
+        const int result = rock_red_black_tree_compare(object, needle, node);
+        if (!result) {
+            return 0;
+        } else if (result < 0) {
+            seagrass_required_true(!rock_red_black_tree_node_get_left(
+                    node, &node));
+        } else {
+            seagrass_required_true(!rock_red_black_tree_node_get_right(
+                    node, &node));
+        }
+    }
+    return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;
+}
+
+static int rock_red_black_tree_bound(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        const bool is_above,
+        const bool is_inclusive,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!needle) {
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    struct rock_red_black_tree_node *bound = NULL;
+    for (struct rock_red_black_tree_node *node = object->root; node;) {
+        const int result = rock_red_black_tree_compare(object, needle, node);
+        if (!result && is_inclusive) { /* keys are unique */
+            bound = node;
+            break;
+        }
+        /* node is on the wanted side of needle, look for a closer one */
+        const bool is_candidate = is_above
+                                  ? result < 0
+                                  : result > 0;
+        if (is_candidate) {
+            bound = node;
+        }
+        seagrass_required_true(!(is_above == is_candidate
+                                 ? rock_red_black_tree_node_get_left
+                                 : rock_red_black_tree_node_get_right)(
+                node, &node));
+    }
+    if (!bound) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;
+    }
+    *out = bound;
+    return 0;
+}
+
+static int rock_red_black_tree_near(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const hint,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out,
+        bool *const is_N_left) {
+    seagrass_required(object);
+    seagrass_required(needle);
+    seagrass_required(out);
+    seagrass_required(is_N_left);
+    /* nearest node known to be on the same side of needle as hint */
+    struct rock_red_black_tree_node *from = NULL;
+    struct rock_red_black_tree_node *node = object->root;
+    bool is_greater = false;
+    if (hint) {
+        from = (struct rock_red_black_tree_node *) hint;
+        int result = rock_red_black_tree_compare(object, needle, from);
+        if (!result) {
+            *out = from;
+            return 0;
+        }
+        is_greater = result > 0;
+        /* a cached extreme has nothing beyond it, so that needle belongs
+         * below it without climbing to the root to find that out */
+        const bool is_extreme = object->is_cached
+                                && from == (is_greater
+                                            ? object->rightmost
+                                            : object->leftmost);
+        /* climb until an ancestor lies beyond needle, only ancestors which
+         * are on the far side of the path towards hint are compared */
+        struct rock_red_black_tree_node *parent;
+        for (struct rock_red_black_tree_node *child = from;
+             !is_extreme; child = parent) {
+            seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                    child, &parent));
+            if (!parent) {
+                break;
+            }
+            if (rock_red_black_tree_node_is_on_left(parent, child)
+                != is_greater) {
+                continue;
+            }
+            result = rock_red_black_tree_compare(object, needle, parent);
+            if (!result) {
+                *out = parent;
+                return 0;
+            }
+            if ((result > 0) != is_greater) {
+                break;
+            }
+            from = parent;
+        }
+        /* needle lies between from and the ancestor at which we stopped,
+         * which is the subtree on the side of from facing needle */
+        seagrass_required_true(!(is_greater
+                                 ? rock_red_black_tree_node_get_right
+                                 : rock_red_black_tree_node_get_left)(
+                from, &node));
+    }
+    *out = from;
+    *is_N_left = !is_greater;
+    while (node) {
+        *out = node;
+        const int result = rock_red_black_tree_compare(object, needle, node);
+        if (!result) {
+            return 0;
+        }
+        *is_N_left = result < 0;
+        seagrass_required_true(!(*is_N_left
+                                 ? rock_red_black_tree_node_get_left
+                                 : rock_red_black_tree_node_get_right)(
+                node, &node));
+    }
+    return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;
+}
+
+int rock_red_black_tree_find_near(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const hint,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!needle) {
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    bool is_N_left;
+    return rock_red_black_tree_near(object, hint, needle, out, &is_N_left);
+}
+
+#define ROCK_RED_BLACK_TREE_BATCH               16
+
+int rock_red_black_tree_find_batch(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const *const needles,
+        const uintmax_t count,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!needles && count) {
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLES_IS_NULL;
+    }
+    if (!out && count) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    /* each lane holds an ongoing search and the needle it is for */
+    struct rock_red_black_tree_node *nodes[ROCK_RED_BLACK_TREE_BATCH];
+    uintmax_t indexes[ROCK_RED_BLACK_TREE_BATCH];
+    uintmax_t lanes = 0;
+    uintmax_t next = 0;
+    for (; lanes < ROCK_RED_BLACK_TREE_BATCH && next < count; lanes++) {
+        seagrass_required(needles[next]);
+        out[next] = NULL;
+        nodes[lanes] = object->root;
+        indexes[lanes] = next++;
+    }
+    while (lanes) {
+        for (uintmax_t i = 0; i < lanes;) {
+            struct rock_red_black_tree_node *node = nodes[i];
+            if (node) {
+                const int result = rock_red_black_tree_compare(
+                        object, needles[indexes[i]], node);
+                if (result) {
+                    seagrass_required_true(!(result < 0
+                            ? rock_red_black_tree_node_get_left(node, &node)
+                            : rock_red_black_tree_node_get_right(node, &node)));
+                    if (node) {
+                        /* in flight while the other lanes are advanced */
+                        __builtin_prefetch(node);
+                        nodes[i++] = node;
+                        continue;
+                    }
+                } else {
+                    out[indexes[i]] = node;
+                }
+            }
+            /* lane is done, so it either takes on the next needle or it is
+             * replaced by the last lane */
+            if (next < count) {
+                seagrass_required(needles[next]);
+                out[next] = NULL;
+                nodes[i] = object->root;
+                indexes[i++] = next++;
+            } else {
+                lanes--;
+                nodes[i] = nodes[lanes];
+                indexes[i] = indexes[lanes];
+            }
+        }
+    }
+    return 0;
+}
+
+int rock_red_black_tree_lower_bound(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_bound(object, needle, true, true, out);
+}
+
+int rock_red_black_tree_upper_bound(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_bound(object, needle, true, false, out);
+}
+
+int rock_red_black_tree_floor(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_bound(object, needle, false, true, out);
+}
+
+int rock_red_black_tree_ceiling(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_bound(object, needle, true, true, out);
+}
+
+int rock_red_black_tree_select(const struct rock_red_black_tree *const object,
+                               uintmax_t index,
+                               struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    seagrass_required_true(&rock_red_black_tree_size_augment
+                           == object->augment);
+    if (index >= object->count) {
+        return ROCK_RED_BLACK_TREE_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+    }
+    struct rock_red_black_tree_node *node = object->root;
+    while (true) {
+        struct rock_red_black_tree_node *left;
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                node, &left));
+        const uintmax_t size = rock_red_black_tree_size(left);
+        if (index == size) {
+            break;
+        }
+        if (index < size) {
+            node = left;
+        } else {
+            index -= 1 + size;
+            seagrass_required_true(!rock_red_black_tree_node_get_right(
+                    node, &node));
+        }
+    }
+    *out = node;
+    return 0;
+}
+
+int rock_red_black_tree_rank(const struct rock_red_black_tree *const object,
+                             const struct rock_red_black_tree_node *node,
+                             uintmax_t *const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    seagrass_required_true(&rock_red_black_tree_size_augment
+                           == object->augment);
+    struct rock_red_black_tree_node *left, *parent;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(node, &left));
+    uintmax_t rank = rock_red_black_tree_size(left);
+    /* every ancestor to the left adds itself and its left subtree */
+    for (;; node = parent) {
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &parent));
+        if (!parent) {
+            break;
+        }
+        if (!rock_red_black_tree_node_is_on_left(parent, node)) {
+            seagrass_required_true(!rock_red_black_tree_node_get_left(
+                    parent, &left));
+            rank += 1 + rock_red_black_tree_size(left);
+        }
+    }
+    *out = rank;
+    return 0;
+}
+
+static uintmax_t rock_red_black_tree_count_below(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        const bool is_inclusive) {
+    uintmax_t count = 0;
+    for (struct rock_red_black_tree_node *node = object->root; node;) {
+        struct rock_red_black_tree_node *left;
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                node, &left));
+        const int result = rock_red_black_tree_compare(object, needle, node);
+        if (!result) { /* keys are unique */
+            count += rock_red_black_tree_size(left) + is_inclusive;
+            break;
+        }
+        if (result < 0) {
+            node = left;
+        } else {
+            count += 1 + rock_red_black_tree_size(left);
+            seagrass_required_true(!rock_red_black_tree_node_get_right(
+                    node, &node));
+        }
+    }
+    return count;
+}
+
+int rock_red_black_tree_count_range(
+        const struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const low,
+        const struct rock_red_black_tree_node *const high,
+        uintmax_t *const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!low) {
+        return ROCK_RED_BLACK_TREE_ERROR_LOW_IS_NULL;
+    }
+    if (!high) {
+        return ROCK_RED_BLACK_TREE_ERROR_HIGH_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    seagrass_required_true(&rock_red_black_tree_size_augment
+                           == object->augment);
+    const uintmax_t below = rock_red_black_tree_count_below(
+            object, low, false);
+    const uintmax_t until = rock_red_black_tree_count_below(
+            object, high, true);
+    *out = until > below ? until - below : 0;
+    return 0;
+}
+
+int rock_red_black_tree_insert(struct rock_red_black_tree *const object,
+                               struct rock_red_black_tree_node *parent,
+                               struct rock_red_black_tree_node *child) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!child) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (!parent && object->root) {
+        return ROCK_RED_BLACK_TREE_ERROR_INSERTION_POINT_IS_NULL;
+    }
+    /* reset child node */
+    seagrass_required_true(!rock_red_black_tree_node_init(
+            child));
+    struct rock_red_black_tree_node *const inserted = child;
+    bool color;
+    /* insert */
+    if (!parent) {
+        parent = object->root;
+    }
+    if (!parent) {
+        rock_red_black_tree_cache_linked(object, NULL, child, false);
+        object->root = child;
+    } else {
+        const int result = rock_red_black_tree_compare(object, child, parent);
+        if (!result) { /* duplicates are not allowed */
+            return ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS;
+        }
+        const bool is_N_left = result < 0;
+        rock_red_black_tree_cache_linked(object, parent, child, is_N_left);
+        int (*const get_N)(const struct rock_red_black_tree_node *,
+                           struct rock_red_black_tree_node **)
+        = is_N_left
+          ? rock_red_black_tree_node_get_left
+          : rock_red_black_tree_node_get_right;
+        int (*const set_N)(struct rock_red_black_tree_node *,
+                            struct rock_red_black_tree_node *)
+        = is_N_left
+          ? rock_red_black_tree_node_set_left
+          : rock_red_black_tree_node_set_right;
+        struct rock_red_black_tree_node *node;
+        seagrass_required_true(!get_N(parent, &node));
+        if (node) { /* replace existing node in parent */
+            seagrass_required_true(!rock_red_black_tree_node_get_color(
+                    node, &color));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    node, ROCK_RED_BLACK_TREE_COLOR_RED));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    child, color));
+            seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                    child, parent));
+            seagrass_required_true(!set_N(parent, child));
+            parent = child;
+            child = node;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                child, parent));
+        seagrass_required_true(!set_N(parent, child));
+    }
+    rock_red_black_tree_linked(object->augment, inserted);
+    seagrass_required_true(!seagrass_uintmax_t_add(
+            1, object->count, &object->count));
+    rock_red_black_tree_insert_repair(object->augment, &object->root,
+                                      parent, child);
+    return 0;
+}
+
+bool rock_red_black_tree_insert_repair(
+        const struct rock_red_black_tree_augment *const augment,
+        struct rock_red_black_tree_node **const root,
+        struct rock_red_black_tree_node *parent,
+        struct rock_red_black_tree_node *child) {
+    seagrass_required(root);
+    seagrass_required(child);
+    bool color;
+    while (true) {
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                child, &color));
+        seagrass_required_true(ROCK_RED_BLACK_TREE_COLOR_RED == color);
+        if (!parent) {
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    child, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+            return true;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                parent, &color));
+        /* case 1: parent is BLACK */
+        if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
+            return false;
+        }
+        struct rock_red_black_tree_node *grandparent, *sibling;
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                parent, &grandparent));
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                grandparent, &sibling));
+        if (sibling == parent) {
+            seagrass_required_true(!rock_red_black_tree_node_get_right(
+                    grandparent, &sibling));
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                sibling, &color));
+        /* Legend: C - child            B - BLACK
+         *         P - parent           R - RED
+         *         G - grandparent
+         *         S - sibling
+         */
+        /* case 2a: parent's sibling is RED */
+        if (ROCK_RED_BLACK_TREE_COLOR_RED == color) {
+            /*         G(B)                      G(R)
+             *         /  \                      /  \
+             *      P(R)  S(R)       =>       P(B)  S(B)
+             *      /                         /
+             *   C(R)                       C(R)
+             * --------------------- or ---------------------
+             *         G(B)                      G(R)
+             *         /  \                      /  \
+             *      S(R)  P(R)       =>       S(B)  P(B)
+             *              \                         \
+             *              C(R)                      C(R)
+             */
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    parent, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    sibling, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    grandparent, ROCK_RED_BLACK_TREE_COLOR_RED));
+            /* Changing grandparent to RED may have introduced two consecutive
+             * REDs - grandparent and possibly great-grandparent. We will
+             * iterate to correct this violation.
+             */
+            child = grandparent;
+            seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                    child, &parent));
+            continue;
+        }
+        /* case 2b: parent's sibling is BLACK */
+        const bool is_parent_left = rock_red_black_tree_node_is_on_left(
+                grandparent, parent);
+        const bool is_child_left = rock_red_black_tree_node_is_on_left(
+                parent, child);
+        switch (is_parent_left << 1 | is_child_left) {
+            /*         G(B)                      P(B)
+             *         /  \                      /  \
+             *     S(B)    P(R)      =>       G(R)   C(R)
+             *                \                /
+             *                C(R)           S(B)
+             * --------------------- or ---------------------
+             *         G(B)                      P(B)
+             *         /  \                      /  \
+             *     P(R)    S(B)      =>      C(R)    G(R)
+             *     /                                    \
+             *  C(R)                                    S(B)
+             */
+            case 0:
+            case 3: {
+                seagrass_required_true(!rock_red_black_tree_rotate_N(
+                        parent, !is_parent_left));
+                rock_red_black_tree_rotated(augment, grandparent, parent);
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        parent, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        grandparent, ROCK_RED_BLACK_TREE_COLOR_RED));
+                if (*root == grandparent) {
+                    *root = parent;
+                }
+                return false;
+            }
+                /*         G(B)                      C(B)
+                 *         /  \                      /  \
+                 *     S(B)    P(R)      =>       G(R)   P(R)
+                 *             /                   /
+                 *           C(R)                S(B)
+                 * --------------------- or ---------------------
+                 *         G(B)                      C(B)
+                 *         /  \                      /  \
+                 *     P(R)    S(B)      =>      P(R)    G(R)
+                 *        \                                 \
+                 *        C(R)                              S(B)
+                 */
+            case 1:
+            case 2: {
+                seagrass_required_true(!rock_red_black_tree_rotate_N_O(
+                        child, !is_child_left));
+                rock_red_black_tree_rotated(augment, parent, child);
+                rock_red_black_tree_rotated(augment, grandparent, child);
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        child, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        grandparent, ROCK_RED_BLACK_TREE_COLOR_RED));
+                if (*root == grandparent) {
+                    *root = child;
+                }
+                return false;
+            }
+        }
+    }
+}
+
+int rock_red_black_tree_link(struct rock_red_black_tree *const object,
+                             struct rock_red_black_tree_node *const parent,
+                             struct rock_red_black_tree_node *const node,
+                             const bool is_left) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    seagrass_required_true(parent || !object->root);
+    seagrass_required_true(!parent || !(is_left
+                                        ? parent->left
+                                        : parent->right));
+    seagrass_required_true(!rock_red_black_tree_node_init(node));
+    rock_red_black_tree_cache_linked(object, parent, node, is_left);
+    if (!parent) {
+        object->root = node;
+    } else {
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                node, parent));
+        seagrass_required_true(!(is_left
+                                 ? rock_red_black_tree_node_set_left
+                                 : rock_red_black_tree_node_set_right)(
+                parent, node));
+    }
+    rock_red_black_tree_linked(object->augment, node);
+    seagrass_required_true(!seagrass_uintmax_t_add(
+            1, object->count, &object->count));
+    rock_red_black_tree_insert_repair(object->augment, &object->root,
+                                      parent, node);
+    return 0;
+}
+
+int rock_red_black_tree_find_or_insert(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    struct rock_red_black_tree_node *parent = NULL;
+    bool is_N_left = false;
+    for (struct rock_red_black_tree_node *next = object->root; next;) {
+        parent = next;
+        const int result = rock_red_black_tree_compare(object, node, parent);
+        if (!result) {
+            *out = parent;
+            return 0;
+        }
+        is_N_left = result < 0;
+        seagrass_required_true(!(is_N_left
+                                 ? rock_red_black_tree_node_get_left
+                                 : rock_red_black_tree_node_get_right)(
+                parent, &next));
+    }
+    /* link node at the NIL position the descent stopped at */
+    seagrass_required_true(!rock_red_black_tree_link(object, parent, node,
+                                                     is_N_left));
+    *out = node;
+    return 0;
+}
+
+int rock_red_black_tree_insert_near(
+        struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const hint,
+        struct rock_red_black_tree_node *const node) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    struct rock_red_black_tree_node *parent;
+    bool is_N_left;
+    if (!rock_red_black_tree_near(object, hint, node, &parent, &is_N_left)) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS;
+    }
+    seagrass_required_true(!rock_red_black_tree_link(object, parent, node,
+                                                     is_N_left));
+    return 0;
+}
+
+int rock_red_black_tree_append(struct rock_red_black_tree *const object,
+                               struct rock_red_black_tree_node *const node) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    struct rock_red_black_tree_node *last = NULL;
+    if (object->root) {
+        seagrass_required_true(!rock_red_black_tree_last(object, &last));
+        if (rock_red_black_tree_compare(object, node, last) <= 0) {
+            return rock_red_black_tree_insert_near(object, last, node);
+        }
+    }
+    /* the last node has no right child, link node there directly */
+    seagrass_required_true(!rock_red_black_tree_link(object, last, node,
+                                                     false));
+    return 0;
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_build(
+        const struct rock_red_black_tree *const object,
+        struct rock_red_black_tree_node *const *const nodes,
+        const uintmax_t count,
+        const uintmax_t depth,
+        const uintmax_t red_depth,
+        struct rock_red_black_tree_node *const parent) {
+    if (!count) {
+        return NULL;
+    }
+    const uintmax_t middle = count / 2;
+    struct rock_red_black_tree_node *const node = nodes[middle];
+    seagrass_required(node);
+    seagrass_required_true(!rock_red_black_tree_node_init(node));
+    seagrass_required_true(!rock_red_black_tree_node_set_color(
+            node, depth == red_depth
+                  ? ROCK_RED_BLACK_TREE_COLOR_RED
+                  : ROCK_RED_BLACK_TREE_COLOR_BLACK));
+    if (parent) {
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                node, parent));
+    }
+    /* both halves differ in size by at most one, so every NIL is on one of
+     * the two deepest levels */
+    struct rock_red_black_tree_node *const left = rock_red_black_tree_build(
+            object, nodes, middle, 1 + depth, red_depth, node);
+    struct rock_red_black_tree_node *const right = rock_red_black_tree_build(
+            object, nodes + middle + 1, count - middle - 1, 1 + depth,
+            red_depth, node);
+    seagrass_required_true(!rock_red_black_tree_node_set_left(node, left));
+    seagrass_required_true(!rock_red_black_tree_node_set_right(node, right));
+    rock_red_black_tree_update(object->augment, node);
+    return node;
+}
+
+int rock_red_black_tree_build_sorted(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree_node *const *const nodes,
+        const uintmax_t count) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!nodes && count) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODES_IS_NULL;
+    }
+    if (object->root) {
+        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY;
+    }
+    uintmax_t depth = 0;
+    for (uintmax_t i = count; i > 1; i >>= 1) {
+        depth++;
+    }
+    /* the root is always BLACK */
+    object->root = rock_red_black_tree_build(object, nodes, count, 0,
+                                             depth ? depth : UINTMAX_MAX,
+                                             NULL);
+    object->count = count;
+    rock_red_black_tree_extremes(object);
+    return 0;
+}
+
+bool rock_red_black_tree_unlink(
+        const struct rock_red_black_tree_augment *const augment,
+        struct rock_red_black_tree_node **const root,
+        struct rock_red_black_tree_node *const node) {
+    seagrass_required(root);
+    seagrass_required(node);
+    bool color;
+    struct rock_red_black_tree_node *left, *right, *parent, *double_black = NULL;
+    /* took the place of node if it had two children */
+    struct rock_red_black_tree_node *successor = NULL;
+    while (!double_black) {
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                node, &color));
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                node, &left));
+        seagrass_required_true(!rock_red_black_tree_node_get_right(
+                node, &right));
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &parent));
+        switch ((NULL == left) << 1 | (NULL == right)) {
+            case 3: { /* node with no children */
+                if (parent) {
+                    int (*const set_N)(struct rock_red_black_tree_node *,
+                                       struct rock_red_black_tree_node *)
+                    = rock_red_black_tree_node_is_on_left(parent, node)
+                      ? rock_red_black_tree_node_set_left
+                      : rock_red_black_tree_node_set_right;
+                    seagrass_required_true(!set_N(parent, NULL));
+                }
+                rock_red_black_tree_propagate(augment, parent, successor);
+                rock_red_black_tree_propagate(augment, successor, NULL);
+                if (node == *root) {
+                    *root = NULL;
+                    return ROCK_RED_BLACK_TREE_COLOR_BLACK == color;
+                }
+                if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
+                    double_black = node;
+                    continue;
+                }
+                return false;
+            }
+            case 2:
+            case 1: { /* node with single child */
+                void *child = left ? left : right;
+                /* 'child' to replace 'node' */
+                bool color_;
+                seagrass_required_true(!rock_red_black_tree_node_get_color(
+                        child, &color_));
+                if (parent) {
+                    int (*const set_N)(struct rock_red_black_tree_node *,
+                                       struct rock_red_black_tree_node *)
+                    = rock_red_black_tree_node_is_on_left(parent, node)
+                      ? rock_red_black_tree_node_set_left
+                      : rock_red_black_tree_node_set_right;
+                    seagrass_required_true(!set_N(parent, child));
+                }
+                seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                        child, parent));
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        child, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+                rock_red_black_tree_propagate(augment, parent, successor);
+                rock_red_black_tree_propagate(augment, successor, NULL);
+                if (node == *root) {
+                    *root = child;
+                }
+                if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color
+                    && ROCK_RED_BLACK_TREE_COLOR_BLACK == color_) {
+                    double_black = child;
+                    continue;
+                }
+                return false;
+            }
+            case 0: { /* node with two children */
+                struct rock_red_black_tree_node *next;
+                seagrass_required_true(!rock_red_black_tree_next(
+                        node, &next));
+                /* swap 'next' with 'node' */
+                bool color_;
+                seagrass_required_true(!rock_red_black_tree_node_get_color(
+                        next, &color_));
+                struct rock_red_black_tree_node *parent_, *left_, *right_;
+                seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                        next, &parent_));
+                seagrass_required_true(!rock_red_black_tree_node_get_left(
+                        next, &left_));
+                seagrass_required_true(!rock_red_black_tree_node_get_right(
+                        next, &right_));
+
+                seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                        node, node == parent_ ? next : parent_));
+                seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                        next, next == parent ? node : parent));
+                seagrass_required_true(!rock_red_black_tree_node_set_left(
+                        node, node == left_ ? next : left_));
+                seagrass_required_true(!rock_red_black_tree_node_set_left(
+                        next, next == left ? node : left));
+                seagrass_required_true(!rock_red_black_tree_node_set_right(
+                        node, node == right_ ? next : right_));
+                seagrass_required_true(!rock_red_black_tree_node_set_right(
+                        next, next == right ? node : right));
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        node, color_));
+                seagrass_required_true(!rock_red_black_tree_node_set_color(
+                        next, color));
+
+                if (parent_ && node != parent_) {
+                    int (*const set_N)(struct rock_red_black_tree_node *,
                                        struct rock_red_black_tree_node *)
                     = rock_red_black_tree_node_is_on_left(parent_, next)
                       ? rock_red_black_tree_node_set_left
@@ -816,9 +2130,13 @@ int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
                     seagrass_required_true(!rock_red_black_tree_node_set_parent(
                             right, next));
                 }
-                if (node == object->root) {
-                    object->root = next;
+                if (node == *root) {
+                    *root = next;
+                }
+                if (augment) {
+                    augment->copy(node, next);
                 }
+                successor = next;
                 continue;
             }
         }
@@ -837,8 +2155,8 @@ int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
          *           N(B)
          * [done]
          */
-        if (double_black == object->root) {
-            break;
+        if (double_black == *root) {
+            return true;
         }
         /* is 'double black' on left or right */
         bool is_left;
@@ -879,6 +2197,7 @@ int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
             && ROCK_RED_BLACK_TREE_COLOR_RED == color) {
             seagrass_required_true(!rock_red_black_tree_rotate_N(
                     sibling, is_left));
+            rock_red_black_tree_rotated(augment, parent, sibling);
             bool colors[2];
             seagrass_required_true(!rock_red_black_tree_node_get_color(
                     parent, &colors[0]));
@@ -888,8 +2207,8 @@ int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
                     parent, colors[1]));
             seagrass_required_true(!rock_red_black_tree_node_set_color(
                     sibling, colors[0]));
-            if (parent == object->root) {
-                object->root = sibling;
+            if (parent == *root) {
+                *root = sibling;
             }
             continue;
         }
@@ -959,85 +2278,1048 @@ int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
                     sibling, ROCK_RED_BLACK_TREE_COLOR_RED));
             break;
         }
-        /* closest C from N */
-        struct rock_red_black_tree_node *closest = is_left ? left : right;
-        /* farthest C from N */
-        struct rock_red_black_tree_node *farthest = is_left ? right : left;
-        /* case 5: sibling is BLACK and closest child is RED while farthest
-         * child is BLACK.
-         *           P(?)              |             P(?)
-         *          /    \             |            /    \
-         *      N((B))   S(B)          |          S(B)   N((B))
-         *        / \     / \          |          / \      / \
-         *      ... ... C(R) C(B)      |       C(B) C(R) ... ...
-         *              / \  / \       |       / \  / \
-         *            ... .... ...     |     ... .... ...
-         *                   rotate C(R) through S
-         *              change S to RED and C(R) to BLACK
-         *           P(?)              |             P(?)
-         *          /    \             |            /    \
-         *      N((B))   C(B)          |          C(B)   N((B))
-         *        / \     / \          |          / \      / \
-         *      ... ... ...  S(R)      |       S(R) ...  ... ...
-         *                   / \       |       / \
-         *                 ... C(B)    |    C(B) ...
-         *                     / \     |    / \
-         *                   ... ...   |  ... ...
-         */
-        if (!rock_red_black_tree_node_get_color(sibling, &color)
-            && ROCK_RED_BLACK_TREE_COLOR_BLACK == color
-            && !rock_red_black_tree_node_get_color(closest, &color)
-            && ROCK_RED_BLACK_TREE_COLOR_RED == color
-            && !rock_red_black_tree_node_get_color(farthest, &color)
-            && ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
-            seagrass_required_true(!rock_red_black_tree_rotate_N(
-                    closest, !is_left));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    sibling, ROCK_RED_BLACK_TREE_COLOR_RED));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    closest, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-            continue;
+        /* closest C from N */
+        struct rock_red_black_tree_node *closest = is_left ? left : right;
+        /* farthest C from N */
+        struct rock_red_black_tree_node *farthest = is_left ? right : left;
+        /* case 5: sibling is BLACK and closest child is RED while farthest
+         * child is BLACK.
+         *           P(?)              |             P(?)
+         *          /    \             |            /    \
+         *      N((B))   S(B)          |          S(B)   N((B))
+         *        / \     / \          |          / \      / \
+         *      ... ... C(R) C(B)      |       C(B) C(R) ... ...
+         *              / \  / \       |       / \  / \
+         *            ... .... ...     |     ... .... ...
+         *                   rotate C(R) through S
+         *              change S to RED and C(R) to BLACK
+         *           P(?)              |             P(?)
+         *          /    \             |            /    \
+         *      N((B))   C(B)          |          C(B)   N((B))
+         *        / \     / \          |          / \      / \
+         *      ... ... ...  S(R)      |       S(R) ...  ... ...
+         *                   / \       |       / \
+         *                 ... C(B)    |    C(B) ...
+         *                     / \     |    / \
+         *                   ... ...   |  ... ...
+         */
+        if (!rock_red_black_tree_node_get_color(sibling, &color)
+            && ROCK_RED_BLACK_TREE_COLOR_BLACK == color
+            && !rock_red_black_tree_node_get_color(closest, &color)
+            && ROCK_RED_BLACK_TREE_COLOR_RED == color
+            && !rock_red_black_tree_node_get_color(farthest, &color)
+            && ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
+            seagrass_required_true(!rock_red_black_tree_rotate_N(
+                    closest, !is_left));
+            rock_red_black_tree_rotated(augment, sibling, closest);
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    sibling, ROCK_RED_BLACK_TREE_COLOR_RED));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    closest, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+            continue;
+        }
+        /* case 6: sibling is BLACK and farthest child is RED.
+         *           P(?)              |             P(?)
+         *          /    \             |            /    \
+         *      N((B))   S(B)          |          S(B)   N((B))
+         *        / \     / \          |          / \     / \
+         *      ... ... ...  C(R)      |       C(R) ... ... ...
+         *                  / \        |       / \
+         *                ... ...      |     ... ...
+         *                     rotate S through P
+         *                      set S to P color
+         *                    set P and C to BLACK
+         *           S(?)              |             S(?)
+         *          /    \             |            /    \
+         *        P(B)   C(B)          |          P(B)   C(B)
+         *        / \     / \          |          / \     / \
+         *     N(B) ... ... ...        |        ... ... ... N(B)
+         *     / \                     |                     / \
+         *   ... ...                   |                   ... ...
+         *  [done]
+         */
+        if (!rock_red_black_tree_node_get_color(sibling, &color)
+            && ROCK_RED_BLACK_TREE_COLOR_BLACK == color
+            && !rock_red_black_tree_node_get_color(farthest, &color)
+            && ROCK_RED_BLACK_TREE_COLOR_RED == color) {
+            seagrass_required_true(!rock_red_black_tree_rotate_N(
+                    sibling, is_left));
+            rock_red_black_tree_rotated(augment, parent, sibling);
+            seagrass_required_true(!rock_red_black_tree_node_get_color(
+                    parent, &color));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    sibling, color));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    parent, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+            seagrass_required_true(!rock_red_black_tree_node_set_color(
+                    farthest, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+            if (parent == *root) {
+                *root = sibling;
+            }
+            break;
+        }
+        seagrass_required_true(false);
+    }
+    return false;
+}
+
+int rock_red_black_tree_remove(struct rock_red_black_tree *const object,
+                               struct rock_red_black_tree_node *const node) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    rock_red_black_tree_cache_unlinked(object, node);
+    seagrass_required_true(!seagrass_uintmax_t_subtract(
+            object->count, 1, &object->count));
+    rock_red_black_tree_unlink(object->augment, &object->root, node);
+    return 0;
+}
+
+void rock_red_black_tree_destroy(
+        struct rock_red_black_tree_node *node,
+        void (*const on_destroy)(struct rock_red_black_tree_node *node)) {
+    if (node) { /* do not climb out of the subtree */
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                node, NULL));
+    }
+    while (node) {
+        struct rock_red_black_tree_node *next;
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                node, &next));
+        if (next) {
+            seagrass_required_true(!rock_red_black_tree_node_set_left(
+                    node, NULL));
+            node = next;
+            continue;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_right(
+                node, &next));
+        if (next) {
+            seagrass_required_true(!rock_red_black_tree_node_set_right(
+                    node, NULL));
+            node = next;
+            continue;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_parent(
+                node, &next));
+        if (on_destroy) {
+            on_destroy(node);
+        }
+        node = next;
+    }
+}
+
+uintmax_t rock_red_black_tree_black_height(
+        const struct rock_red_black_tree_node *node) {
+    uintmax_t height = 0;
+    bool color;
+    struct rock_red_black_tree_node *left;
+    for (; node; node = left) {
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                node, &color));
+        if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
+            height++;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_get_left(
+                node, &left));
+    }
+    return height;
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_detach(
+        struct rock_red_black_tree_node *const root,
+        uintmax_t *const height) {
+    seagrass_required(height);
+    if (root) {
+        bool color;
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                root, &color));
+        /* a RED root turned BLACK adds to the black height */
+        if (ROCK_RED_BLACK_TREE_COLOR_RED == color) {
+            (*height)++;
+        }
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                root, NULL));
+        seagrass_required_true(!rock_red_black_tree_node_set_color(
+                root, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+    }
+    return root;
+}
+
+static uintmax_t rock_red_black_tree_child_height(
+        const struct rock_red_black_tree_node *const node,
+        const uintmax_t height) {
+    bool color;
+    seagrass_required_true(!rock_red_black_tree_node_get_color(
+            node, &color));
+    return ROCK_RED_BLACK_TREE_COLOR_BLACK == color ? height - 1 : height;
+}
+
+struct rock_red_black_tree_node *rock_red_black_tree_join_subtrees(
+        const struct rock_red_black_tree *const object,
+        struct rock_red_black_tree_node *left,
+        uintmax_t left_height,
+        struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *right,
+        uintmax_t right_height,
+        uintmax_t *const height) {
+    seagrass_required(object);
+    seagrass_required(node);
+    seagrass_required(height);
+    left = rock_red_black_tree_detach(left, &left_height);
+    right = rock_red_black_tree_detach(right, &right_height);
+    seagrass_required_true(!rock_red_black_tree_node_init(node));
+    if (left_height == right_height) {
+        seagrass_required_true(!rock_red_black_tree_node_set_color(
+                node, ROCK_RED_BLACK_TREE_COLOR_BLACK));
+        seagrass_required_true(!rock_red_black_tree_node_set_left(
+                node, left));
+        seagrass_required_true(!rock_red_black_tree_node_set_right(
+                node, right));
+        if (left) {
+            seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                    left, node));
+        }
+        if (right) {
+            seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                    right, node));
+        }
+        rock_red_black_tree_update(object->augment, node);
+        *height = 1 + left_height;
+        return node;
+    }
+    /* descend the inner spine of the taller tree to the first BLACK node
+     * whose black height matches the shorter tree */
+    const bool is_N_left = left_height < right_height;
+    int (*const get_N)(const struct rock_red_black_tree_node *,
+                       struct rock_red_black_tree_node **)
+    = is_N_left
+      ? rock_red_black_tree_node_get_left
+      : rock_red_black_tree_node_get_right;
+    int (*const set_N)(struct rock_red_black_tree_node *,
+                       struct rock_red_black_tree_node *)
+    = is_N_left
+      ? rock_red_black_tree_node_set_left
+      : rock_red_black_tree_node_set_right;
+    struct rock_red_black_tree_node *const taller = is_N_left ? right : left;
+    struct rock_red_black_tree_node *const shorter = is_N_left ? left : right;
+    const uintmax_t target = is_N_left ? left_height : right_height;
+    *height = is_N_left ? right_height : left_height;
+    uintmax_t current = *height;
+    struct rock_red_black_tree_node *parent = NULL, *child = taller;
+    bool color;
+    while (true) {
+        seagrass_required_true(!rock_red_black_tree_node_get_color(
+                child, &color));
+        if (ROCK_RED_BLACK_TREE_COLOR_BLACK == color) {
+            if (current == target) {
+                break;
+            }
+            current--;
+        }
+        parent = child;
+        seagrass_required_true(!get_N(child, &child));
+    }
+    /* node takes the place of child, as RED it keeps the black height */
+    seagrass_required_true(!rock_red_black_tree_node_set_left(
+            node, is_N_left ? shorter : child));
+    seagrass_required_true(!rock_red_black_tree_node_set_right(
+            node, is_N_left ? child : shorter));
+    if (child) {
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                child, node));
+    }
+    if (shorter) {
+        seagrass_required_true(!rock_red_black_tree_node_set_parent(
+                shorter, node));
+    }
+    seagrass_required_true(!rock_red_black_tree_node_set_parent(
+            node, parent));
+    seagrass_required_true(!set_N(parent, node));
+    struct rock_red_black_tree_node *root = taller;
+    rock_red_black_tree_linked(object->augment, node);
+    if (rock_red_black_tree_insert_repair(object->augment, &root, parent,
+                                          node)) {
+        (*height)++;
+    }
+    return root;
+}
+
+struct rock_red_black_tree_node *rock_red_black_tree_concatenate(
+        const struct rock_red_black_tree *const object,
+        struct rock_red_black_tree_node *const left,
+        uintmax_t left_height,
+        struct rock_red_black_tree_node *const right,
+        const uintmax_t right_height,
+        uintmax_t *const height) {
+    seagrass_required(object);
+    seagrass_required(height);
+    if (!left) {
+        *height = right_height;
+        return rock_red_black_tree_detach(right, height);
+    }
+    if (!right) {
+        *height = left_height;
+        return rock_red_black_tree_detach(left, height);
+    }
+    struct rock_red_black_tree_node *root = rock_red_black_tree_detach(
+            left, &left_height);
+    struct rock_red_black_tree_node *last;
+    rock_red_black_tree_maximum(root, &last);
+    if (rock_red_black_tree_unlink(object->augment, &root, last)) {
+        left_height--;
+    }
+    return rock_red_black_tree_join_subtrees(object, root, left_height, last,
+                                             right, right_height, height);
+}
+
+struct rock_red_black_tree_node *rock_red_black_tree_split_subtree(
+        const struct rock_red_black_tree *const object,
+        struct rock_red_black_tree_node *const root,
+        const uintmax_t height,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const left,
+        uintmax_t *const left_height,
+        struct rock_red_black_tree_node **const right,
+        uintmax_t *const right_height) {
+    seagrass_required(object);
+    seagrass_required(needle);
+    seagrass_required(left);
+    seagrass_required(left_height);
+    seagrass_required(right);
+    seagrass_required(right_height);
+    if (!root) {
+        *left = *right = NULL;
+        *left_height = *right_height = 0;
+        return NULL;
+    }
+    struct rock_red_black_tree_node *root_left, *root_right, *middle, *node;
+    seagrass_required_true(!rock_red_black_tree_node_get_left(
+            root, &root_left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(
+            root, &root_right));
+    const uintmax_t child_height = rock_red_black_tree_child_height(
+            root, height);
+    uintmax_t middle_height;
+    const int result = rock_red_black_tree_compare(object, needle, root);
+    if (!result) {
+        *left_height = *right_height = child_height;
+        *left = rock_red_black_tree_detach(root_left, left_height);
+        *right = rock_red_black_tree_detach(root_right, right_height);
+        seagrass_required_true(!rock_red_black_tree_node_init(root));
+        return root;
+    }
+    if (result < 0) {
+        node = rock_red_black_tree_split_subtree(
+                object, root_left, child_height, needle, left, left_height,
+                &middle, &middle_height);
+        *right = rock_red_black_tree_join_subtrees(
+                object, middle, middle_height, root, root_right,
+                child_height, right_height);
+    } else {
+        node = rock_red_black_tree_split_subtree(
+                object, root_right, child_height, needle, &middle,
+                &middle_height, right, right_height);
+        *left = rock_red_black_tree_join_subtrees(
+                object, root_left, child_height, root, middle,
+                middle_height, left_height);
+    }
+    return node;
+}
+
+#define ROCK_RED_BLACK_TREE_SET_UNION           0
+#define ROCK_RED_BLACK_TREE_SET_INTERSECTION    1
+#define ROCK_RED_BLACK_TREE_SET_DIFFERENCE      2
+
+struct rock_red_black_tree_set {
+    const struct rock_red_black_tree *object;
+    void (*on_remove)(struct rock_red_black_tree_node *);
+    uintmax_t found;
+    int operation;
+    /* parallel execution */
+    struct rock_thread_pool *pool;
+    uintmax_t count;
+    uintmax_t grain;
+};
+
+static void rock_red_black_tree_set_remove(
+        struct rock_red_black_tree_set *const set,
+        struct rock_red_black_tree_node *const node) {
+    seagrass_required_true(!rock_red_black_tree_node_init(node));
+    if (set->on_remove) {
+        set->on_remove(node);
+    }
+}
+
+static void rock_red_black_tree_set_on_drop(
+        struct rock_red_black_tree_node *const node,
+        void *const context) {
+    rock_red_black_tree_set_remove(context, node);
+}
+
+static void rock_red_black_tree_set_drop(
+        struct rock_red_black_tree_set *const set,
+        struct rock_red_black_tree_node *const root) {
+    /* dropped nodes are handed out in the same state as removed ones */
+    if (set->on_remove) {
+        rock_red_black_tree_post_order_subtree(
+                root, rock_red_black_tree_set_on_drop, set);
+    }
+}
+
+static bool rock_red_black_tree_set_is_trivial(
+        struct rock_red_black_tree_set *const set,
+        struct rock_red_black_tree_node *const a,
+        const uintmax_t a_height,
+        struct rock_red_black_tree_node *const b,
+        const uintmax_t b_height,
+        struct rock_red_black_tree_node **const out,
+        uintmax_t *const height) {
+    if (a && b) {
+        return false;
+    }
+    switch (set->operation) {
+        case ROCK_RED_BLACK_TREE_SET_UNION: {
+            *height = a ? a_height : b_height;
+            *out = rock_red_black_tree_detach(a ? a : b, height);
+            break;
+        }
+        case ROCK_RED_BLACK_TREE_SET_INTERSECTION: {
+            rock_red_black_tree_set_drop(set, a);
+            rock_red_black_tree_set_drop(set, b);
+            *height = 0;
+            *out = NULL;
+            break;
+        }
+        case ROCK_RED_BLACK_TREE_SET_DIFFERENCE: {
+            rock_red_black_tree_set_drop(set, b);
+            *height = a_height;
+            *out = rock_red_black_tree_detach(a, height);
+            break;
+        }
+        default: {
+            seagrass_required_true(false);
+        }
+    }
+    return true;
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_set_merge(
+        struct rock_red_black_tree_set *const set,
+        struct rock_red_black_tree_node *const b,
+        struct rock_red_black_tree_node *const node,
+        struct rock_red_black_tree_node *const left,
+        const uintmax_t left_height,
+        struct rock_red_black_tree_node *const right,
+        const uintmax_t right_height,
+        uintmax_t *const height) {
+    if (node) {
+        set->found++;
+    }
+    switch (set->operation) {
+        case ROCK_RED_BLACK_TREE_SET_UNION: {
+            if (!node) {
+                return rock_red_black_tree_join_subtrees(
+                        set->object, left, left_height, b, right,
+                        right_height, height);
+            }
+            /* the node already present in a is kept */
+            rock_red_black_tree_set_remove(set, b);
+            return rock_red_black_tree_join_subtrees(
+                    set->object, left, left_height, node, right,
+                    right_height, height);
+        }
+        case ROCK_RED_BLACK_TREE_SET_INTERSECTION: {
+            rock_red_black_tree_set_remove(set, b);
+            if (!node) {
+                return rock_red_black_tree_concatenate(
+                        set->object, left, left_height, right, right_height,
+                        height);
+            }
+            return rock_red_black_tree_join_subtrees(
+                    set->object, left, left_height, node, right,
+                    right_height, height);
+        }
+        case ROCK_RED_BLACK_TREE_SET_DIFFERENCE: {
+            rock_red_black_tree_set_remove(set, b);
+            if (node) {
+                rock_red_black_tree_set_remove(set, node);
+            }
+            return rock_red_black_tree_concatenate(
+                    set->object, left, left_height, right, right_height,
+                    height);
+        }
+        default: {
+            seagrass_required_true(false);
+            return NULL;
+        }
+    }
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_set_apply(
+        struct rock_red_black_tree_set *const set,
+        struct rock_red_black_tree_node *const a,
+        const uintmax_t a_height,
+        struct rock_red_black_tree_node *const b,
+        const uintmax_t b_height,
+        uintmax_t *const height) {
+    struct rock_red_black_tree_node *b_left, *b_right, *left, *right, *node;
+    if (rock_red_black_tree_set_is_trivial(set, a, a_height, b, b_height,
+                                           &node, height)) {
+        return node;
+    }
+    seagrass_required_true(!rock_red_black_tree_node_get_left(b, &b_left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(b, &b_right));
+    const uintmax_t b_child_height = rock_red_black_tree_child_height(
+            b, b_height);
+    uintmax_t left_height, right_height;
+    node = rock_red_black_tree_split_subtree(set->object, a, a_height, b,
+                                             &left, &left_height,
+                                             &right, &right_height);
+    left = rock_red_black_tree_set_apply(set, left, left_height, b_left,
+                                         b_child_height, &left_height);
+    right = rock_red_black_tree_set_apply(set, right, right_height, b_right,
+                                          b_child_height, &right_height);
+    return rock_red_black_tree_set_merge(set, b, node, left, left_height,
+                                         right, right_height, height);
+}
+
+struct rock_red_black_tree_set_fork {
+    struct rock_red_black_tree_set set;
+    struct rock_red_black_tree_node *a;
+    struct rock_red_black_tree_node *b;
+    struct rock_red_black_tree_node *result;
+    uintmax_t a_height;
+    uintmax_t b_height;
+    uintmax_t height;
+    uintmax_t threads;
+    uintmax_t depth;
+    atomic_uintmax_t remaining;
+};
+
+static struct rock_red_black_tree_node *rock_red_black_tree_set_fork_apply(
+        struct rock_red_black_tree_set *set,
+        struct rock_red_black_tree_node *a,
+        uintmax_t a_height,
+        struct rock_red_black_tree_node *b,
+        uintmax_t b_height,
+        uintmax_t threads,
+        uintmax_t depth,
+        uintmax_t *height);
+
+static void rock_red_black_tree_set_fork_run(void *const context,
+                                             const uintmax_t begin,
+                                             const uintmax_t end) {
+    struct rock_red_black_tree_set_fork *const fork = context;
+    fork->result = rock_red_black_tree_set_fork_apply(
+            &fork->set, fork->a, fork->a_height, fork->b, fork->b_height,
+            fork->threads, fork->depth, &fork->height);
+    rock_thread_pool_complete(fork->set.pool, &fork->remaining, 1);
+}
+
+static struct rock_red_black_tree_node *rock_red_black_tree_set_fork_apply(
+        struct rock_red_black_tree_set *const set,
+        struct rock_red_black_tree_node *const a,
+        const uintmax_t a_height,
+        struct rock_red_black_tree_node *const b,
+        const uintmax_t b_height,
+        const uintmax_t threads,
+        const uintmax_t depth,
+        uintmax_t *const height) {
+    /* the nodes of other are assumed to halve with every level */
+    if (threads < 2 || (set->count >> depth) <= set->grain) {
+        return rock_red_black_tree_set_apply(set, a, a_height, b, b_height,
+                                             height);
+    }
+    struct rock_red_black_tree_node *b_left, *b_right, *left, *right, *node;
+    if (rock_red_black_tree_set_is_trivial(set, a, a_height, b, b_height,
+                                           &node, height)) {
+        return node;
+    }
+    seagrass_required_true(!rock_red_black_tree_node_get_left(b, &b_left));
+    seagrass_required_true(!rock_red_black_tree_node_get_right(b, &b_right));
+    const uintmax_t b_child_height = rock_red_black_tree_child_height(
+            b, b_height);
+    uintmax_t left_height, right_height;
+    node = rock_red_black_tree_split_subtree(set->object, a, a_height, b,
+                                             &left, &left_height,
+                                             &right, &right_height);
+    /* both halves are disjoint and can be combined independently */
+    struct rock_red_black_tree_set_fork fork = {
+            .set = *set,
+            .a = left,
+            .b = b_left,
+            .a_height = left_height,
+            .b_height = b_child_height,
+            .threads = threads / 2,
+            .depth = 1 + depth
+    };
+    fork.set.found = 0;
+    atomic_init(&fork.remaining, 1);
+    const struct rock_thread_pool_task task = {
+            .function = rock_red_black_tree_set_fork_run,
+            .context = &fork
+    };
+    if (rock_thread_pool_spawn(set->pool, &task)) {
+        rock_red_black_tree_set_fork_run(&fork, 0, 0);
+    }
+    right = rock_red_black_tree_set_fork_apply(set, right, right_height,
+                                               b_right, b_child_height,
+                                               threads - threads / 2,
+                                               1 + depth, &right_height);
+    rock_thread_pool_wait(set->pool, &fork.remaining);
+    set->found += fork.set.found;
+    return rock_red_black_tree_set_merge(set, b, node, fork.result,
+                                         fork.height, right, right_height,
+                                         height);
+}
+
+static int rock_red_black_tree_set_execute(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *),
+        const int operation,
+        struct rock_thread_pool *const pool,
+        const uintmax_t grain,
+        const uintmax_t threads) {
+    seagrass_required(object);
+    seagrass_required(other);
+    seagrass_required_true(object != other);
+    seagrass_required_true(object->augment == other->augment);
+    struct rock_red_black_tree_set set = {
+            .object = object,
+            .on_remove = on_remove,
+            .operation = operation,
+            .pool = pool,
+            .count = other->count,
+            .grain = grain
+    };
+    /* black heights are found once and then passed down */
+    const uintmax_t a_height = rock_red_black_tree_black_height(object->root);
+    const uintmax_t b_height = rock_red_black_tree_black_height(other->root);
+    uintmax_t height;
+    object->root = pool
+                   ? rock_red_black_tree_set_fork_apply(
+                    &set, object->root, a_height, other->root, b_height,
+                    threads, 0, &height)
+                   : rock_red_black_tree_set_apply(
+                    &set, object->root, a_height, other->root, b_height,
+                    &height);
+    switch (operation) {
+        case ROCK_RED_BLACK_TREE_SET_UNION: {
+            object->count += other->count - set.found;
+            break;
+        }
+        case ROCK_RED_BLACK_TREE_SET_INTERSECTION: {
+            object->count = set.found;
+            break;
         }
-        /* case 6: sibling is BLACK and farthest child is RED.
-         *           P(?)              |             P(?)
-         *          /    \             |            /    \
-         *      N((B))   S(B)          |          S(B)   N((B))
-         *        / \     / \          |          / \     / \
-         *      ... ... ...  C(R)      |       C(R) ... ... ...
-         *                  / \        |       / \
-         *                ... ...      |     ... ...
-         *                     rotate S through P
-         *                      set S to P color
-         *                    set P and C to BLACK
-         *           S(?)              |             S(?)
-         *          /    \             |            /    \
-         *        P(B)   C(B)          |          P(B)   C(B)
-         *        / \     / \          |          / \     / \
-         *     N(B) ... ... ...        |        ... ... ... N(B)
-         *     / \                     |                     / \
-         *   ... ...                   |                   ... ...
-         *  [done]
-         */
-        if (!rock_red_black_tree_node_get_color(sibling, &color)
-            && ROCK_RED_BLACK_TREE_COLOR_BLACK == color
-            && !rock_red_black_tree_node_get_color(farthest, &color)
-            && ROCK_RED_BLACK_TREE_COLOR_RED == color) {
-            seagrass_required_true(!rock_red_black_tree_rotate_N(
-                    sibling, is_left));
-            seagrass_required_true(!rock_red_black_tree_node_get_color(
-                    parent, &color));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    sibling, color));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    parent, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-            seagrass_required_true(!rock_red_black_tree_node_set_color(
-                    farthest, ROCK_RED_BLACK_TREE_COLOR_BLACK));
-            if (parent == object->root) {
-                object->root = sibling;
+        default: {
+            object->count -= set.found;
+        }
+    }
+    rock_red_black_tree_extremes(object);
+    other->root = NULL;
+    other->count = 0;
+    rock_red_black_tree_extremes(other);
+    return 0;
+}
+
+int rock_red_black_tree_join(struct rock_red_black_tree *const object,
+                             struct rock_red_black_tree_node *const node,
+                             struct rock_red_black_tree *const other) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!node) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    seagrass_required_true(object != other);
+    seagrass_required_true(object->augment == other->augment);
+    struct rock_red_black_tree_node *edge;
+    if (object->root) {
+        rock_red_black_tree_maximum(object->root, &edge);
+        seagrass_required_true(
+                rock_red_black_tree_compare(object, edge, node) < 0);
+    }
+    if (other->root) {
+        rock_red_black_tree_minimum(other->root, &edge);
+        seagrass_required_true(
+                rock_red_black_tree_compare(object, node, edge) < 0);
+    }
+    uintmax_t height;
+    object->root = rock_red_black_tree_join_subtrees(
+            object, object->root,
+            rock_red_black_tree_black_height(object->root), node,
+            other->root, rock_red_black_tree_black_height(other->root),
+            &height);
+    seagrass_required_true(!seagrass_uintmax_t_add(
+            1 + object->count, other->count, &object->count));
+    rock_red_black_tree_extremes(object);
+    other->root = NULL;
+    other->count = 0;
+    rock_red_black_tree_extremes(other);
+    return 0;
+}
+
+int rock_red_black_tree_split(
+        struct rock_red_black_tree *const object,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree *const other,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!needle) {
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    if (other->root) {
+        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY;
+    }
+    seagrass_required_true(object != other);
+    struct rock_red_black_tree_node *left, *right;
+    uintmax_t left_height, right_height;
+    *out = rock_red_black_tree_split_subtree(
+            object, object->root,
+            rock_red_black_tree_black_height(object->root), needle,
+            &left, &left_height, &right, &right_height);
+    const uintmax_t count = object->count - (*out ? 1 : 0);
+    other->root = right;
+    other->compare = object->compare;
+    other->key_offset = object->key_offset;
+    other->key_kind = object->key_kind;
+    other->is_prefixed = object->is_prefixed;
+    other->augment = object->augment;
+    other->is_cached = object->is_cached;
+    object->root = left;
+    rock_red_black_tree_extremes(object);
+    rock_red_black_tree_extremes(other);
+    if (&rock_red_black_tree_size_augment == object->augment) {
+        object->count = rock_red_black_tree_size(left);
+        other->count = count - object->count;
+        return 0;
+    }
+    /* without subtree sizes both parts are walked in step until the smaller
+     * one is exhausted, which is O(n) in the worst case */
+    struct rock_red_black_tree_node *a = NULL, *b = NULL;
+    if (left) {
+        rock_red_black_tree_minimum(left, &a);
+    }
+    if (right) {
+        rock_red_black_tree_minimum(right, &b);
+    }
+    uintmax_t smaller = 0;
+    for (; a && b; smaller++) {
+        if (rock_red_black_tree_next(a, &a)) {
+            a = NULL;
+        }
+        if (rock_red_black_tree_next(b, &b)) {
+            b = NULL;
+        }
+    }
+    object->count = a ? count - smaller : smaller;
+    other->count = count - object->count;
+    return 0;
+}
+
+int rock_red_black_tree_union(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *node)) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    return rock_red_black_tree_set_execute(
+            object, other, on_remove, ROCK_RED_BLACK_TREE_SET_UNION,
+            NULL, 0, 1);
+}
+
+int rock_red_black_tree_parallel_union(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *const pool,
+        const uintmax_t grain,
+        const uintmax_t threads) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    if (!pool) {
+        return ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!threads) {
+        return ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO;
+    }
+    return rock_red_black_tree_set_execute(
+            object, other, on_remove, ROCK_RED_BLACK_TREE_SET_UNION,
+            pool, grain, threads);
+}
+
+int rock_red_black_tree_intersection(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *node)) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    return rock_red_black_tree_set_execute(
+            object, other, on_remove, ROCK_RED_BLACK_TREE_SET_INTERSECTION,
+            NULL, 0, 1);
+}
+
+int rock_red_black_tree_parallel_intersection(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *const pool,
+        const uintmax_t grain,
+        const uintmax_t threads) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    if (!pool) {
+        return ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!threads) {
+        return ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO;
+    }
+    return rock_red_black_tree_set_execute(
+            object, other, on_remove, ROCK_RED_BLACK_TREE_SET_INTERSECTION,
+            pool, grain, threads);
+}
+
+int rock_red_black_tree_difference(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *node)) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    return rock_red_black_tree_set_execute(
+            object, other, on_remove, ROCK_RED_BLACK_TREE_SET_DIFFERENCE,
+            NULL, 0, 1);
+}
+
+int rock_red_black_tree_parallel_difference(
+        struct rock_red_black_tree *const object,
+        struct rock_red_black_tree *const other,
+        void (*const on_remove)(struct rock_red_black_tree_node *node),
+        struct rock_thread_pool *const pool,
+        const uintmax_t grain,
+        const uintmax_t threads) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!other) {
+        return ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL;
+    }
+    if (!pool) {
+        return ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!threads) {
+        return ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO;
+    }
+    return rock_red_black_tree_set_execute(
+            object, other, on_remove, ROCK_RED_BLACK_TREE_SET_DIFFERENCE,
+            pool, grain, threads);
+}
+
+int rock_red_black_tree_cursor_init(
+        struct rock_red_black_tree_cursor *const object,
+        const struct rock_red_black_tree *const tree) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!tree) {
+        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NULL;
+    }
+    object->tree = tree;
+    object->depth = 0;
+    return 0;
+}
+
+static void rock_red_black_tree_cursor_push(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node *const node,
+        const bool is_left) {
+    seagrass_required_true(object->depth < ROCK_RED_BLACK_TREE_CURSOR_DEPTH);
+    object->is_left[object->depth] = is_left;
+    object->path[object->depth++] = node;
+}
+
+static inline struct rock_red_black_tree_node *
+rock_red_black_tree_cursor_descend(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node *node,
+        bool is_left,
+        const bool is_N_left) {
+    seagrass_required(node);
+    while (node) {
+        rock_red_black_tree_cursor_push(object, node, is_left);
+        is_left = is_N_left;
+        seagrass_required_true(!(is_N_left
+                                 ? rock_red_black_tree_node_get_left
+                                 : rock_red_black_tree_node_get_right)(
+                node, &node));
+    }
+    return object->path[object->depth - 1];
+}
+
+static int rock_red_black_tree_cursor_extreme(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node **const out,
+        const bool is_N_left) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    object->depth = 0;
+    if (!object->tree->root) {
+        return ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY;
+    }
+    *out = rock_red_black_tree_cursor_descend(object, object->tree->root,
+                                              false, is_N_left);
+    return 0;
+}
+
+int rock_red_black_tree_cursor_first(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_cursor_extreme(object, out, true);
+}
+
+int rock_red_black_tree_cursor_last(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_cursor_extreme(object, out, false);
+}
+
+int rock_red_black_tree_cursor_seek(
+        struct rock_red_black_tree_cursor *const object,
+        const struct rock_red_black_tree_node *const needle,
+        struct rock_red_black_tree_node **const out) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!needle) {
+        return ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    object->depth = 0;
+    /* depth of the deepest node on the path not less than needle */
+    uintmax_t depth = 0;
+    struct rock_red_black_tree_node *node = object->tree->root;
+    bool is_left = false;
+    while (node) {
+        rock_red_black_tree_cursor_push(object, node, is_left);
+        const int result = rock_red_black_tree_compare(object->tree, needle,
+                                                       node);
+        if (result <= 0) {
+            depth = object->depth;
+            if (!result) {
+                break;
             }
-            break;
         }
-        seagrass_required_true(false);
+        is_left = result < 0;
+        seagrass_required_true(!(is_left
+                                 ? rock_red_black_tree_node_get_left
+                                 : rock_red_black_tree_node_get_right)(
+                node, &node));
+    }
+    /* the path is cut back to end at the node that was found */
+    object->depth = depth;
+    if (!depth) {
+        return ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND;
     }
+    *out = object->path[depth - 1];
     return 0;
 }
+
+static inline __attribute__((always_inline)) int
+rock_red_black_tree_cursor_step(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node **const out,
+        const bool is_next) {
+    if (!object) {
+        return ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL;
+    }
+    if (!object->depth) {
+        return ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE;
+    }
+    int (*const get_O)(const struct rock_red_black_tree_node *,
+                       struct rock_red_black_tree_node **)
+    = is_next
+      ? rock_red_black_tree_node_get_right
+      : rock_red_black_tree_node_get_left;
+    struct rock_red_black_tree_node *child;
+    seagrass_required_true(!get_O(object->path[object->depth - 1], &child));
+    if (child) {
+        *out = rock_red_black_tree_cursor_descend(object, child, !is_next,
+                                                  is_next);
+        return 0;
+    }
+    /* the ancestor which we reach from its near side is the one we want */
+    for (uintmax_t depth = object->depth - 1; depth; depth--) {
+        if (is_next == object->is_left[depth]) {
+            object->depth = depth;
+            *out = object->path[depth - 1];
+            return 0;
+        }
+    }
+    return ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE;
+}
+
+int rock_red_black_tree_cursor_next(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_cursor_step(object, out, true);
+}
+
+int rock_red_black_tree_cursor_prev(
+        struct rock_red_black_tree_cursor *const object,
+        struct rock_red_black_tree_node **const out) {
+    return rock_red_black_tree_cursor_step(object, out, false);
+}
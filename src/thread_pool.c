@@ -0,0 +1,484 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/thread_pool.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+#define ROCK_THREAD_POOL_DEQUE_CAPACITY     64
+#define ROCK_THREAD_POOL_CACHE_LINE         64
+
+static _Thread_local struct rock_thread_pool_worker *current;
+
+struct rock_thread_pool_worker *rock_thread_pool_worker_current(
+        const struct rock_thread_pool *const object) {
+    seagrass_required(object);
+    return current && current->pool == object ? current : NULL;
+}
+
+int rock_thread_pool_spawn(struct rock_thread_pool *const object,
+                           const struct rock_thread_pool_task *const task) {
+    seagrass_required(object);
+    seagrass_required(task);
+    struct rock_thread_pool_worker *const worker
+            = rock_thread_pool_worker_current(object);
+    atomic_fetch_add(&object->pending, 1);
+    int error;
+    if (worker) {
+        if ((error = rock_ws_deque_push(&worker->deque, task))) {
+            seagrass_required_true(
+                    ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED
+                    == error);
+        }
+    } else {
+        seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+        if ((error = rock_array_add(&object->queue, task))) {
+            seagrass_required_true(
+                    ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                    == error);
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    }
+    if (error) {
+        atomic_fetch_sub(&object->pending, 1);
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if (atomic_load(&object->sleeping)) {
+        seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+        seagrass_required_true(!pthread_cond_signal(&object->available));
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    }
+    return 0;
+}
+
+bool rock_thread_pool_execute(struct rock_thread_pool *const object,
+                              struct rock_thread_pool_worker *const worker) {
+    seagrass_required(object);
+    struct rock_thread_pool_task task;
+    bool found = worker && !rock_ws_deque_pop(&worker->deque, &task);
+    /* steal from the other workers starting with our neighbour */
+    const uintmax_t id = worker ? worker->id : 0;
+    for (uintmax_t i = 1; !found && i <= object->count; i++) {
+        struct rock_thread_pool_worker *const victim
+                = &object->workers[(id + i) % object->count];
+        found = victim != worker
+                && !rock_ws_deque_steal(&victim->deque, &task);
+    }
+    if (!found && atomic_load(&object->pending)) {
+        seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+        /* shared queue is drained in submission order */
+        void *item;
+        if (!rock_array_get(&object->queue, object->head, &item)) {
+            memcpy(&task, item, sizeof(task));
+            uintmax_t length;
+            seagrass_required_true(!rock_array_get_length(&object->queue,
+                                                          &length));
+            /* drop the consumed prefix once it makes up most of the
+             * queue, so that it does not grow while submissions keep
+             * arriving and each item is moved O(1) times on average */
+            if (++object->head > length / 2) {
+                seagrass_required_true(!rock_array_remove_all(
+                        &object->queue, 0, object->head));
+                object->head = 0;
+            }
+            found = true;
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    }
+    if (!found) {
+        return false;
+    }
+    atomic_fetch_sub(&object->pending, 1);
+    task.function(task.context, task.begin, task.end);
+    return true;
+}
+
+void rock_thread_pool_wait(struct rock_thread_pool *const object,
+                           atomic_uintmax_t *const remaining) {
+    seagrass_required(object);
+    seagrass_required(remaining);
+    struct rock_thread_pool_worker *const worker
+            = rock_thread_pool_worker_current(object);
+    if (worker) {
+        while (atomic_load_explicit(remaining, memory_order_acquire)) {
+            if (!rock_thread_pool_execute(object, worker)) {
+                sched_yield();
+            }
+        }
+        return;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    while (atomic_load_explicit(remaining, memory_order_acquire)) {
+        seagrass_required_true(!pthread_cond_wait(&object->completed,
+                                                  &object->mutex));
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+}
+
+void rock_thread_pool_complete(struct rock_thread_pool *const object,
+                               atomic_uintmax_t *const remaining,
+                               const uintmax_t amount) {
+    seagrass_required(object);
+    seagrass_required(remaining);
+    if (amount != atomic_fetch_sub_explicit(remaining, amount,
+                                            memory_order_acq_rel)) {
+        return;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    seagrass_required_true(!pthread_cond_broadcast(&object->completed));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+}
+
+static void *rock_thread_pool_run(void *const arg) {
+    struct rock_thread_pool_worker *const worker = arg;
+    struct rock_thread_pool *const object = worker->pool;
+    current = worker;
+    while (true) {
+        if (rock_thread_pool_execute(object, worker)) {
+            continue;
+        }
+        seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+        atomic_fetch_add(&object->sleeping, 1);
+        while (!atomic_load(&object->pending)
+               && !atomic_load(&object->is_shutdown)) {
+            seagrass_required_true(!pthread_cond_wait(&object->available,
+                                                      &object->mutex));
+        }
+        atomic_fetch_sub(&object->sleeping, 1);
+        const bool is_shutdown = atomic_load(&object->is_shutdown);
+        seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+        if (is_shutdown) {
+            break;
+        }
+    }
+    current = NULL;
+    return NULL;
+}
+
+static void rock_thread_pool_destroy(struct rock_thread_pool *const object,
+                                     const uintmax_t started) {
+    seagrass_required(object);
+    seagrass_required_true(!pthread_mutex_lock(&object->mutex));
+    atomic_store(&object->is_shutdown, true);
+    seagrass_required_true(!pthread_cond_broadcast(&object->available));
+    seagrass_required_true(!pthread_mutex_unlock(&object->mutex));
+    for (uintmax_t i = 0; i < started; i++) {
+        seagrass_required_true(!pthread_join(object->workers[i].thread,
+                                             NULL));
+    }
+    for (uintmax_t i = 0; i < object->count; i++) {
+        seagrass_required_true(!rock_ws_deque_invalidate(
+                &object->workers[i].deque, NULL));
+    }
+    free(object->workers);
+    seagrass_required_true(!rock_array_invalidate(&object->queue, NULL));
+    seagrass_required_true(!pthread_cond_destroy(&object->completed));
+    seagrass_required_true(!pthread_cond_destroy(&object->available));
+    seagrass_required_true(!pthread_mutex_destroy(&object->mutex));
+    object->workers = NULL;
+    object->count = 0;
+}
+
+int rock_thread_pool_init(struct rock_thread_pool *const object,
+                          const uintmax_t count) {
+    if (!object) {
+        return ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL;
+    }
+    if (!count) {
+        return ROCK_THREAD_POOL_ERROR_COUNT_IS_ZERO;
+    }
+    if (count > SIZE_MAX / sizeof(struct rock_thread_pool_worker)) {
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    struct rock_thread_pool_worker *const workers
+            = calloc(count, sizeof(*workers));
+    if (!workers) {
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    int error;
+    if ((error = rock_array_init(&object->queue,
+                                 sizeof(struct rock_thread_pool_task),
+                                 0))) {
+        seagrass_required_true(ROCK_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        free(workers);
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        if ((error = rock_ws_deque_init(
+                &workers[i].deque,
+                sizeof(struct rock_thread_pool_task),
+                ROCK_THREAD_POOL_DEQUE_CAPACITY))) {
+            seagrass_required_true(
+                    ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED
+                    == error);
+            for (uintmax_t o = 0; o < i; o++) {
+                seagrass_required_true(!rock_ws_deque_invalidate(
+                        &workers[o].deque, NULL));
+            }
+            seagrass_required_true(!rock_array_invalidate(
+                    &object->queue, NULL));
+            free(workers);
+            return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+        workers[i].pool = object;
+        workers[i].id = i;
+    }
+    object->workers = workers;
+    object->count = count;
+    object->head = 0;
+    atomic_init(&object->pending, 0);
+    atomic_init(&object->sleeping, 0);
+    atomic_init(&object->is_shutdown, false);
+    seagrass_required_true(!pthread_mutex_init(&object->mutex, NULL));
+    seagrass_required_true(!pthread_cond_init(&object->available, NULL));
+    seagrass_required_true(!pthread_cond_init(&object->completed, NULL));
+    for (uintmax_t i = 0; i < count; i++) {
+        if (pthread_create(&workers[i].thread, NULL, rock_thread_pool_run,
+                           &workers[i])) {
+            rock_thread_pool_destroy(object, i);
+            return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+    }
+    return 0;
+}
+
+int rock_thread_pool_invalidate(struct rock_thread_pool *const object) {
+    if (!object) {
+        return ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL;
+    }
+    seagrass_required_true(!rock_thread_pool_worker_current(object));
+    rock_thread_pool_destroy(object, object->count);
+    return 0;
+}
+
+int rock_thread_pool_count(const struct rock_thread_pool *const object,
+                           uintmax_t *const out) {
+    if (!object) {
+        return ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_THREAD_POOL_ERROR_OUT_IS_NULL;
+    }
+    *out = object->count;
+    return 0;
+}
+
+struct rock_thread_pool_for {
+    struct rock_thread_pool *pool;
+    const struct rock_array *array;
+    uintmax_t grain;
+    void (*function)(const struct rock_array *,
+                     uintmax_t,
+                     uintmax_t,
+                     void *);
+    void (*fold)(void *,
+                 const struct rock_array *,
+                 uintmax_t,
+                 uintmax_t,
+                 void *);
+    void *context;
+    unsigned char *accumulators;
+    size_t stride;
+    atomic_uintmax_t remaining;
+};
+
+static void rock_thread_pool_for_run(void *const context,
+                                     const uintmax_t begin,
+                                     uintmax_t end) {
+    struct rock_thread_pool_for *const job = context;
+    /* make the upper halves available to thieves */
+    while (end - begin > job->grain) {
+        const uintmax_t middle = begin + (end - begin) / 2;
+        const struct rock_thread_pool_task task = {
+                .function = rock_thread_pool_for_run,
+                .context = job,
+                .begin = middle,
+                .end = end
+        };
+        if (rock_thread_pool_spawn(job->pool, &task)) {
+            break; /* process the whole range ourselves */
+        }
+        end = middle;
+    }
+    void *accumulator = NULL;
+    if (job->fold) {
+        struct rock_thread_pool_worker *const worker
+                = rock_thread_pool_worker_current(job->pool);
+        seagrass_required(worker);
+        accumulator = job->accumulators + (job->stride * worker->id);
+    }
+    for (uintmax_t at = begin; at < end;) {
+        const uintmax_t next = end - at > job->grain
+                               ? at + job->grain
+                               : end;
+        if (job->fold) {
+            job->fold(accumulator, job->array, at, next, job->context);
+        } else {
+            job->function(job->array, at, next, job->context);
+        }
+        at = next;
+    }
+    rock_thread_pool_complete(job->pool, &job->remaining, end - begin);
+}
+
+static int rock_thread_pool_for_execute(struct rock_thread_pool *const object,
+                                        struct rock_thread_pool_for *const job,
+                                        const uintmax_t length) {
+    seagrass_required(object);
+    seagrass_required(job);
+    atomic_init(&job->remaining, length);
+    if (rock_thread_pool_worker_current(object)) {
+        rock_thread_pool_for_run(job, 0, length);
+    } else {
+        const struct rock_thread_pool_task task = {
+                .function = rock_thread_pool_for_run,
+                .context = job,
+                .begin = 0,
+                .end = length
+        };
+        int error;
+        if ((error = rock_thread_pool_spawn(object, &task))) {
+            seagrass_required_true(
+                    ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED
+                    == error);
+            return error;
+        }
+    }
+    rock_thread_pool_wait(object, &job->remaining);
+    return 0;
+}
+
+int rock_thread_pool_parallel_for(
+        struct rock_thread_pool *const object,
+        const struct rock_array *const array,
+        const uintmax_t grain,
+        void (*const function)(const struct rock_array *array,
+                               uintmax_t begin,
+                               uintmax_t end,
+                               void *context),
+        void *const context) {
+    if (!object) {
+        return ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL;
+    }
+    if (!array) {
+        return ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!function) {
+        return ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL;
+    }
+    uintmax_t length;
+    seagrass_required_true(!rock_array_get_length(array, &length));
+    if (!length) {
+        return 0;
+    }
+    if (length <= grain) {
+        function(array, 0, length, context);
+        return 0;
+    }
+    struct rock_thread_pool_for job = {
+            .pool = object,
+            .array = array,
+            .grain = grain,
+            .function = function,
+            .context = context
+    };
+    return rock_thread_pool_for_execute(object, &job, length);
+}
+
+int rock_thread_pool_parallel_reduce(
+        struct rock_thread_pool *const object,
+        const struct rock_array *const array,
+        const uintmax_t grain,
+        const size_t size,
+        const void *const identity,
+        void (*const fold)(void *accumulator,
+                           const struct rock_array *array,
+                           uintmax_t begin,
+                           uintmax_t end,
+                           void *context),
+        void (*const combine)(void *accumulator,
+                              const void *other,
+                              void *context),
+        void *const context,
+        void *const out) {
+    if (!object) {
+        return ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL;
+    }
+    if (!array) {
+        return ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL;
+    }
+    if (!grain) {
+        return ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO;
+    }
+    if (!size) {
+        return ROCK_THREAD_POOL_ERROR_SIZE_IS_ZERO;
+    }
+    if (!identity) {
+        return ROCK_THREAD_POOL_ERROR_IDENTITY_IS_NULL;
+    }
+    if (!fold || !combine) {
+        return ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_THREAD_POOL_ERROR_OUT_IS_NULL;
+    }
+    memcpy(out, identity, size);
+    uintmax_t length;
+    seagrass_required_true(!rock_array_get_length(array, &length));
+    if (!length) {
+        return 0;
+    }
+    if (length <= grain) {
+        fold(out, array, 0, length, context);
+        return 0;
+    }
+    /* give each worker's accumulator cache lines of its own */
+    if (size > SIZE_MAX - (ROCK_THREAD_POOL_CACHE_LINE - 1)) {
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    const size_t stride = (size + (ROCK_THREAD_POOL_CACHE_LINE - 1))
+                          & ~(size_t) (ROCK_THREAD_POOL_CACHE_LINE - 1);
+    if (object->count > SIZE_MAX / stride) {
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    void *memory;
+    if (posix_memalign(&memory, ROCK_THREAD_POOL_CACHE_LINE,
+                       object->count * stride)) {
+        return ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    unsigned char *const accumulators = memory;
+    for (uintmax_t i = 0; i < object->count; i++) {
+        memcpy(accumulators + (stride * i), identity, size);
+    }
+    struct rock_thread_pool_for job = {
+            .pool = object,
+            .array = array,
+            .grain = grain,
+            .fold = fold,
+            .context = context,
+            .accumulators = accumulators,
+            .stride = stride
+    };
+    int error;
+    if ((error = rock_thread_pool_for_execute(object, &job, length))) {
+        seagrass_required_true(
+                ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED
+                == error);
+        free(accumulators);
+        return error;
+    }
+    for (uintmax_t i = 0; i < object->count; i++) {
+        combine(out, accumulators + (stride * i), context);
+    }
+    free(accumulators);
+    return 0;
+}
@@ -0,0 +1,318 @@
+#include <stdlib.h>
+#include <string.h>
+#include <seagrass.h>
+#include <rock.h>
+
+#include "private/ws_deque.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+int rock_ws_deque_buffer_of(const size_t size,
+                            const uintmax_t capacity,
+                            struct rock_ws_deque_buffer **const out) {
+    seagrass_required(out);
+    seagrass_required_true(size > 0);
+    seagrass_required_true(capacity > 0 && !(capacity & (capacity - 1)));
+    int error;
+    uintmax_t length;
+    if ((error = seagrass_uintmax_t_multiply(
+            sizeof(atomic_uintptr_t), rock_ws_deque_buffer_words(size),
+            &length))
+        || (error = seagrass_uintmax_t_multiply(length, capacity, &length))
+        || (error = seagrass_uintmax_t_add(
+            sizeof(struct rock_ws_deque_buffer), length, &length))
+        || length > SIZE_MAX) {
+        seagrass_required_true(
+                !error
+                || SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT
+                   == error);
+        return ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    struct rock_ws_deque_buffer *const buffer = malloc(length);
+    if (!buffer) {
+        return ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    buffer->retired = NULL;
+    buffer->capacity = capacity;
+    *out = buffer;
+    return 0;
+}
+
+size_t rock_ws_deque_buffer_words(const size_t size) {
+    return size / sizeof(atomic_uintptr_t)
+           + (0 != size % sizeof(atomic_uintptr_t));
+}
+
+void *rock_ws_deque_buffer_address(
+        const struct rock_ws_deque_buffer *const buffer,
+        const size_t size,
+        const intmax_t at) {
+    seagrass_required(buffer);
+    const uintmax_t index = (uintmax_t) at & (buffer->capacity - 1);
+    return (atomic_uintptr_t *) buffer->data
+           + (rock_ws_deque_buffer_words(size) * index);
+}
+
+void rock_ws_deque_buffer_store(struct rock_ws_deque_buffer *const buffer,
+                                const size_t size,
+                                const intmax_t at,
+                                const void *const item) {
+    seagrass_required(item);
+    atomic_uintptr_t *const slot = rock_ws_deque_buffer_address(
+            buffer, size, at);
+    const unsigned char *const bytes = item;
+    for (size_t i = 0, offset = 0; offset < size; i++) {
+        const size_t length = size - offset < sizeof(uintptr_t)
+                              ? size - offset
+                              : sizeof(uintptr_t);
+        uintptr_t word = 0;
+        memcpy(&word, bytes + offset, length);
+        atomic_store_explicit(&slot[i], word, memory_order_relaxed);
+        offset += length;
+    }
+}
+
+void rock_ws_deque_buffer_load(const struct rock_ws_deque_buffer *const buffer,
+                               const size_t size,
+                               const intmax_t at,
+                               void *const out) {
+    seagrass_required(out);
+    atomic_uintptr_t *const slot = rock_ws_deque_buffer_address(
+            buffer, size, at);
+    unsigned char *const bytes = out;
+    for (size_t i = 0, offset = 0; offset < size; i++) {
+        const size_t length = size - offset < sizeof(uintptr_t)
+                              ? size - offset
+                              : sizeof(uintptr_t);
+        const uintptr_t word = atomic_load_explicit(&slot[i],
+                                                    memory_order_relaxed);
+        memcpy(bytes + offset, &word, length);
+        offset += length;
+    }
+}
+
+int rock_ws_deque_init(struct rock_ws_deque *const object,
+                       const size_t size,
+                       const uintmax_t capacity) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!size) {
+        return ROCK_WS_DEQUE_ERROR_SIZE_IS_ZERO;
+    }
+    int error;
+    uintmax_t capacity_ = 1;
+    while (capacity_ < capacity) {
+        if ((error = seagrass_uintmax_t_multiply(2, capacity_, &capacity_))) {
+            seagrass_required_true(
+                    SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT
+                    == error);
+            return ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+    }
+    struct rock_ws_deque_buffer *buffer;
+    if ((error = rock_ws_deque_buffer_of(size, capacity_, &buffer))) {
+        seagrass_required_true(ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return error;
+    }
+    atomic_init(&object->top, 0);
+    atomic_init(&object->bottom, 0);
+    atomic_init(&object->buffer, buffer);
+    object->retired = NULL;
+    object->size = size;
+    return 0;
+}
+
+int rock_ws_deque_invalidate(struct rock_ws_deque *const object,
+                             void (*const on_destroy)(void *)) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    struct rock_ws_deque_buffer *buffer = atomic_load(&object->buffer);
+    if (on_destroy) {
+        const intmax_t bottom = atomic_load(&object->bottom);
+        for (intmax_t i = atomic_load(&object->top); i < bottom; i++) {
+            on_destroy(rock_ws_deque_buffer_address(
+                    buffer, object->size, i));
+        }
+    }
+    free(buffer);
+    for (buffer = object->retired; buffer;) {
+        struct rock_ws_deque_buffer *const retired = buffer->retired;
+        free(buffer);
+        buffer = retired;
+    }
+    atomic_init(&object->top, 0);
+    atomic_init(&object->bottom, 0);
+    atomic_init(&object->buffer, NULL);
+    object->retired = NULL;
+    object->size = 0;
+    return 0;
+}
+
+int rock_ws_deque_size(const struct rock_ws_deque *const object,
+                       size_t *const out) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_WS_DEQUE_ERROR_OUT_IS_NULL;
+    }
+    *out = object->size;
+    return 0;
+}
+
+int rock_ws_deque_count(const struct rock_ws_deque *const object,
+                        uintmax_t *const out) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_WS_DEQUE_ERROR_OUT_IS_NULL;
+    }
+    struct rock_ws_deque *const deque = (struct rock_ws_deque *) object;
+    const intmax_t top = atomic_load_explicit(&deque->top,
+                                              memory_order_acquire);
+    const intmax_t bottom = atomic_load_explicit(&deque->bottom,
+                                                 memory_order_acquire);
+    *out = bottom > top ? (uintmax_t) (bottom - top) : 0;
+    return 0;
+}
+
+int rock_ws_deque_grow(struct rock_ws_deque *const object,
+                       const intmax_t top,
+                       const intmax_t bottom) {
+    seagrass_required(object);
+    struct rock_ws_deque_buffer *const buffer = atomic_load_explicit(
+            &object->buffer, memory_order_relaxed);
+    int error;
+    uintmax_t capacity;
+    if ((error = seagrass_uintmax_t_multiply(2, buffer->capacity,
+                                             &capacity))) {
+        seagrass_required_true(
+                SEAGRASS_UINTMAX_T_ERROR_RESULT_IS_INCONSISTENT
+                == error);
+        return ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    struct rock_ws_deque_buffer *grown;
+    if ((error = rock_ws_deque_buffer_of(object->size, capacity, &grown))) {
+        seagrass_required_true(ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED
+                               == error);
+        return error;
+    }
+    const size_t words = rock_ws_deque_buffer_words(object->size);
+    for (intmax_t i = top; i < bottom; i++) {
+        atomic_uintptr_t *const to = rock_ws_deque_buffer_address(
+                grown, object->size, i);
+        atomic_uintptr_t *const from = rock_ws_deque_buffer_address(
+                buffer, object->size, i);
+        for (size_t j = 0; j < words; j++) {
+            atomic_init(&to[j], atomic_load_explicit(
+                    &from[j], memory_order_relaxed));
+        }
+    }
+    /* thieves may still be copying out of the previous buffer */
+    buffer->retired = object->retired;
+    object->retired = buffer;
+    atomic_store_explicit(&object->buffer, grown, memory_order_release);
+    return 0;
+}
+
+int rock_ws_deque_push(struct rock_ws_deque *const object,
+                       const void *const item) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!item) {
+        return ROCK_WS_DEQUE_ERROR_ITEM_IS_NULL;
+    }
+    const intmax_t bottom = atomic_load_explicit(&object->bottom,
+                                                 memory_order_relaxed);
+    const intmax_t top = atomic_load_explicit(&object->top,
+                                              memory_order_acquire);
+    struct rock_ws_deque_buffer *buffer = atomic_load_explicit(
+            &object->buffer, memory_order_relaxed);
+    if (bottom - top > (intmax_t) (buffer->capacity - 1)) {
+        int error;
+        if ((error = rock_ws_deque_grow(object, top, bottom))) {
+            seagrass_required_true(
+                    ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED
+                    == error);
+            return error;
+        }
+        buffer = atomic_load_explicit(&object->buffer, memory_order_relaxed);
+    }
+    rock_ws_deque_buffer_store(buffer, object->size, bottom, item);
+    /* item must be visible before thieves observe the new bottom */
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&object->bottom, 1 + bottom, memory_order_relaxed);
+    return 0;
+}
+
+int rock_ws_deque_pop(struct rock_ws_deque *const object,
+                      void *const out) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_WS_DEQUE_ERROR_OUT_IS_NULL;
+    }
+    const intmax_t bottom = atomic_load_explicit(&object->bottom,
+                                                 memory_order_relaxed) - 1;
+    struct rock_ws_deque_buffer *const buffer = atomic_load_explicit(
+            &object->buffer, memory_order_relaxed);
+    atomic_store_explicit(&object->bottom, bottom, memory_order_relaxed);
+    /* reserve the bottom item before looking at what thieves have taken */
+    atomic_thread_fence(memory_order_seq_cst);
+    intmax_t top = atomic_load_explicit(&object->top, memory_order_relaxed);
+    if (top > bottom) { /* empty */
+        atomic_store_explicit(&object->bottom, 1 + bottom,
+                              memory_order_relaxed);
+        return ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY;
+    }
+    if (top == bottom) { /* last item, race thieves for it */
+        const bool won = atomic_compare_exchange_strong_explicit(
+                &object->top, &top, 1 + top,
+                memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&object->bottom, 1 + bottom,
+                              memory_order_relaxed);
+        if (!won) {
+            return ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY;
+        }
+    }
+    rock_ws_deque_buffer_load(buffer, object->size, bottom, out);
+    return 0;
+}
+
+int rock_ws_deque_steal(struct rock_ws_deque *const object,
+                        void *const out) {
+    if (!object) {
+        return ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL;
+    }
+    if (!out) {
+        return ROCK_WS_DEQUE_ERROR_OUT_IS_NULL;
+    }
+    while (true) {
+        intmax_t top = atomic_load_explicit(&object->top,
+                                            memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        const intmax_t bottom = atomic_load_explicit(&object->bottom,
+                                                     memory_order_acquire);
+        if (top >= bottom) {
+            return ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY;
+        }
+        /* buffer must be loaded after bottom so that it holds the item */
+        struct rock_ws_deque_buffer *const buffer = atomic_load_explicit(
+                &object->buffer, memory_order_acquire);
+        /* the owner may be overwriting the slot, so read it atomically */
+        rock_ws_deque_buffer_load(buffer, object->size, top, out);
+        if (atomic_compare_exchange_strong_explicit(
+                &object->top, &top, 1 + top,
+                memory_order_seq_cst, memory_order_relaxed)) {
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,351 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <rock.h>
+
+#include "private/concurrent_array.h"
+#include <test/cmocka.h>
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_init(NULL, sizeof(uintmax_t), 0),
+            ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_init((void *) 1, 0, 0),
+            ROCK_CONCURRENT_ARRAY_ERROR_SIZE_IS_ZERO);
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(
+            rock_concurrent_array_init(&object, sizeof(uintmax_t),
+                                       UINTMAX_MAX),
+            ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_concurrent_array_init(&object, sizeof(uintmax_t), 10),
+            ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+}
+
+static void check_init(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 0), 0);
+    assert_int_equal(sizeof(uintmax_t), object.size);
+    assert_int_equal(1, object.first);
+    assert_int_equal(0, object.claimed);
+    assert_int_equal(0, object.published);
+    assert_non_null(object.segments[0]);
+    assert_int_equal(1, object.segments[0]->capacity);
+    for (uintmax_t i = 1; i < ROCK_CONCURRENT_ARRAY_SEGMENTS; i++) {
+        assert_null(object.segments[i]);
+    }
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 5), 0);
+    assert_int_equal(8, object.first);
+    assert_int_equal(8, object.segments[0]->capacity);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_invalidate(NULL, NULL),
+            ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void on_destroy(void *item) {
+    function_called();
+}
+
+static void check_invalidate(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 0), 0);
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_int_equal(rock_concurrent_array_add(&object, &i), 0);
+    }
+    expect_function_calls(on_destroy, 10);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, on_destroy),
+                     0);
+}
+
+static void check_size_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_size(NULL, (void *) 1),
+            ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_size_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_size((void *) 1, NULL),
+            ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL);
+}
+
+static void check_size(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(&object, 13, 0), 0);
+    size_t size;
+    assert_int_equal(rock_concurrent_array_size(&object, &size), 0);
+    assert_int_equal(13, size);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+static void check_get_length_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_get_length(NULL, (void *) 1),
+            ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_get_length_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_get_length((void *) 1, NULL),
+            ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL);
+}
+
+static void check_get_length(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 0), 0);
+    uintmax_t length;
+    assert_int_equal(rock_concurrent_array_get_length(&object, &length), 0);
+    assert_int_equal(0, length);
+    for (uintmax_t i = 0; i < 5; i++) {
+        assert_int_equal(rock_concurrent_array_add(&object, &i), 0);
+    }
+    assert_int_equal(rock_concurrent_array_get_length(&object, &length), 0);
+    assert_int_equal(5, length);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_add(NULL, (void *) 1),
+            ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_add_error_on_item_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_add((void *) 1, NULL),
+            ROCK_CONCURRENT_ARRAY_ERROR_ITEM_IS_NULL);
+}
+
+static void check_add_error_on_memory_allocation_failed(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 0), 0);
+    uintmax_t item = 0;
+    assert_int_equal(rock_concurrent_array_add(&object, &item), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_concurrent_array_add(&object, &item),
+            ROCK_CONCURRENT_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    /* nothing was claimed, hence publishing carries on */
+    assert_int_equal(1, object.claimed);
+    assert_int_equal(rock_concurrent_array_add(&object, &item), 0);
+    assert_int_equal(2, object.published);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+static void check_add(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 2), 0);
+    const void *addresses[100];
+    for (uintmax_t i = 0; i < 100; i++) {
+        assert_int_equal(rock_concurrent_array_add(&object, &i), 0);
+        assert_int_equal(rock_concurrent_array_get(
+                &object, i, &addresses[i]), 0);
+    }
+    /* 2 + 4 + 8 + 16 + 32 + 64 */
+    for (uintmax_t i = 0; i < 6; i++) {
+        assert_non_null(object.segments[i]);
+        assert_int_equal(2 << i, object.segments[i]->capacity);
+    }
+    assert_null(object.segments[6]);
+    for (uintmax_t i = 0; i < 100; i++) {
+        const void *item;
+        assert_int_equal(rock_concurrent_array_get(&object, i, &item), 0);
+        assert_ptr_equal(addresses[i], item);
+        assert_int_equal(i, *(const uintmax_t *) item);
+    }
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+static void check_get_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_get(NULL, 0, (void *) 1),
+            ROCK_CONCURRENT_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_get_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_concurrent_array_get((void *) 1, 0, NULL),
+            ROCK_CONCURRENT_ARRAY_ERROR_OUT_IS_NULL);
+}
+
+static void check_get_error_on_index_is_out_of_bounds(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 0), 0);
+    const void *item;
+    assert_int_equal(
+            rock_concurrent_array_get(&object, 0, &item),
+            ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS);
+    assert_int_equal(rock_concurrent_array_add(&object, &object), 0);
+    assert_int_equal(
+            rock_concurrent_array_get(&object, 1, &item),
+            ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS);
+    assert_int_equal(
+            rock_concurrent_array_get(&object, UINTMAX_MAX, &item),
+            ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+static void check_get_unpublished(void **state) {
+    struct rock_concurrent_array object;
+    assert_int_equal(rock_concurrent_array_init(
+            &object, sizeof(uintmax_t), 4), 0);
+    /* claim slot 0 without filling it, as a stalled writer would */
+    atomic_store(&object.claimed, 1);
+    uintmax_t item = 1;
+    assert_int_equal(rock_concurrent_array_add(&object, &item), 0);
+    assert_int_equal(2, object.claimed);
+    assert_int_equal(0, object.published);
+    const void *out;
+    assert_int_equal(
+            rock_concurrent_array_get(&object, 1, &out),
+            ROCK_CONCURRENT_ARRAY_ERROR_INDEX_IS_OUT_OF_BOUNDS);
+    /* the stalled writer completes and publishes both */
+    item = 0;
+    memcpy(object.segments[0]->data, &item, sizeof(item));
+    atomic_store(rock_concurrent_array_segment_ready(
+            object.segments[0], object.size, 0), true);
+    rock_concurrent_array_publish(&object);
+    assert_int_equal(2, object.published);
+    assert_int_equal(rock_concurrent_array_get(&object, 1, &out), 0);
+    assert_int_equal(1, *(const uintmax_t *) out);
+    assert_int_equal(rock_concurrent_array_invalidate(&object, NULL), 0);
+}
+
+#define STRESS_WRITERS          4
+#define STRESS_ITEMS            50000
+
+struct stress {
+    struct rock_concurrent_array array;
+    atomic_bool is_done;
+    atomic_bool is_failed;
+};
+
+static void *writer(void *arg) {
+    struct stress *const stress = arg;
+    for (uintmax_t i = 0; i < STRESS_ITEMS; i++) {
+        if (rock_concurrent_array_add(&stress->array, &i)) {
+            atomic_store(&stress->is_failed, true);
+        }
+    }
+    return NULL;
+}
+
+static void *reader(void *arg) {
+    struct stress *const stress = arg;
+    uintmax_t checked = 0;
+    while (!atomic_load(&stress->is_done)) {
+        uintmax_t length;
+        if (rock_concurrent_array_get_length(&stress->array, &length)) {
+            atomic_store(&stress->is_failed, true);
+        }
+        for (; checked < length; checked++) {
+            const void *item;
+            if (rock_concurrent_array_get(&stress->array, checked, &item)
+                || *(const uintmax_t *) item >= STRESS_ITEMS) {
+                atomic_store(&stress->is_failed, true);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void check_stress(void **state) {
+    struct stress stress = {};
+    assert_int_equal(rock_concurrent_array_init(
+            &stress.array, sizeof(uintmax_t), 0), 0);
+    pthread_t readers[2];
+    pthread_t writers[STRESS_WRITERS];
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_int_equal(pthread_create(&readers[i], NULL, reader, &stress),
+                         0);
+    }
+    for (uintmax_t i = 0; i < STRESS_WRITERS; i++) {
+        assert_int_equal(pthread_create(&writers[i], NULL, writer, &stress),
+                         0);
+    }
+    for (uintmax_t i = 0; i < STRESS_WRITERS; i++) {
+        assert_int_equal(pthread_join(writers[i], NULL), 0);
+    }
+    atomic_store(&stress.is_done, true);
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_int_equal(pthread_join(readers[i], NULL), 0);
+    }
+    assert_false(stress.is_failed);
+    uintmax_t length;
+    assert_int_equal(rock_concurrent_array_get_length(&stress.array,
+                                                      &length), 0);
+    assert_int_equal(STRESS_WRITERS * STRESS_ITEMS, length);
+    uintmax_t *const seen = calloc(STRESS_ITEMS, sizeof(uintmax_t));
+    assert_non_null(seen);
+    for (uintmax_t i = 0; i < length; i++) {
+        const void *item;
+        assert_int_equal(rock_concurrent_array_get(&stress.array, i, &item),
+                         0);
+        seen[*(const uintmax_t *) item]++;
+    }
+    for (uintmax_t i = 0; i < STRESS_ITEMS; i++) {
+        assert_int_equal(STRESS_WRITERS, seen[i]);
+    }
+    free(seen);
+    assert_int_equal(rock_concurrent_array_invalidate(&stress.array, NULL),
+                     0);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_size_error_on_object_is_null),
+            cmocka_unit_test(check_size_error_on_out_is_null),
+            cmocka_unit_test(check_size),
+            cmocka_unit_test(check_get_length_error_on_object_is_null),
+            cmocka_unit_test(check_get_length_error_on_out_is_null),
+            cmocka_unit_test(check_get_length),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add_error_on_item_is_null),
+            cmocka_unit_test(check_add_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_add),
+            cmocka_unit_test(check_get_error_on_object_is_null),
+            cmocka_unit_test(check_get_error_on_out_is_null),
+            cmocka_unit_test(check_get_error_on_index_is_out_of_bounds),
+            cmocka_unit_test(check_get_unpublished),
+            cmocka_unit_test(check_stress),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
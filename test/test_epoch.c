@@ -0,0 +1,427 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <rock.h>
+
+#include "private/epoch.h"
+#include <test/cmocka.h>
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_init(NULL, 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_error_on_threshold_is_zero(void **state) {
+    assert_int_equal(
+            rock_epoch_init((void *) 1, 0),
+            ROCK_EPOCH_ERROR_THRESHOLD_IS_ZERO);
+}
+
+static void check_init(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    assert_int_equal(16, object.threshold);
+    assert_int_equal(0, object.epoch);
+    assert_int_equal(0, object.orphans.length);
+    assert_ptr_equal(&object.threads, object.threads.next);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_invalidate(NULL),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void on_destroy(void *item) {
+    function_called();
+}
+
+static void check_invalidate(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread thread;
+    assert_int_equal(rock_epoch_register(&object, &thread), 0);
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    assert_int_equal(rock_epoch_retire(&object, &thread, &object,
+                                       on_destroy), 0);
+    assert_int_equal(rock_epoch_retire(&object, &thread, &thread,
+                                       on_destroy), 0);
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    assert_int_equal(rock_epoch_unregister(&object, &thread), 0);
+    assert_int_equal(2, object.orphans.length);
+    expect_function_calls(on_destroy, 2);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_register_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_register(NULL, (void *) 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_register_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_register((void *) 1, NULL),
+            ROCK_EPOCH_ERROR_THREAD_IS_NULL);
+}
+
+static void check_register(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread a, b;
+    assert_int_equal(rock_epoch_register(&object, &a), 0);
+    assert_int_equal(rock_epoch_register(&object, &b), 0);
+    assert_false(a.is_active);
+    assert_int_equal(0, a.nesting);
+    for (uintmax_t i = 0; i < ROCK_EPOCH_LIMBO; i++) {
+        assert_int_equal(0, a.limbo[i].length);
+    }
+    assert_ptr_equal(&a.node, object.threads.next);
+    assert_ptr_equal(&b.node, a.node.next);
+    assert_int_equal(rock_epoch_unregister(&object, &a), 0);
+    assert_int_equal(rock_epoch_unregister(&object, &b), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_unregister_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_unregister(NULL, (void *) 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_unregister_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_unregister((void *) 1, NULL),
+            ROCK_EPOCH_ERROR_THREAD_IS_NULL);
+}
+
+static void check_unregister_error_on_memory_allocation_failed(
+        void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread thread;
+    assert_int_equal(rock_epoch_register(&object, &thread), 0);
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    assert_int_equal(rock_epoch_retire(&object, &thread, &object,
+                                       on_destroy), 0);
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_epoch_unregister(&object, &thread),
+            ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_ptr_equal(&thread.node, object.threads.next);
+    assert_int_equal(rock_epoch_unregister(&object, &thread), 0);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_unregister(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread a, b;
+    assert_int_equal(rock_epoch_register(&object, &a), 0);
+    assert_int_equal(rock_epoch_register(&object, &b), 0);
+    assert_int_equal(rock_epoch_enter(&object, &a), 0);
+    assert_int_equal(rock_epoch_enter(&object, &b), 0);
+    assert_int_equal(rock_epoch_retire(&object, &b, &object, on_destroy), 0);
+    assert_int_equal(rock_epoch_exit(&object, &b), 0);
+    assert_int_equal(rock_epoch_unregister(&object, &b), 0);
+    assert_int_equal(1, object.orphans.length);
+    /* a may still reference the orphan until it exits */
+    assert_true(rock_epoch_advance(&object));
+    assert_false(rock_epoch_advance(&object));
+    assert_int_equal(1, object.orphans.length);
+    assert_int_equal(rock_epoch_exit(&object, &a), 0);
+    expect_function_call(on_destroy);
+    assert_true(rock_epoch_advance(&object));
+    assert_int_equal(0, object.orphans.length);
+    assert_int_equal(rock_epoch_unregister(&object, &a), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_enter_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_enter(NULL, (void *) 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_enter_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_enter((void *) 1, NULL),
+            ROCK_EPOCH_ERROR_THREAD_IS_NULL);
+}
+
+static void check_enter(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread thread;
+    assert_int_equal(rock_epoch_register(&object, &thread), 0);
+    assert_true(rock_epoch_advance(&object));
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    assert_true(thread.is_active);
+    assert_int_equal(1, thread.nesting);
+    assert_int_equal(1, thread.epoch);
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    assert_int_equal(2, thread.nesting);
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    assert_int_equal(rock_epoch_unregister(&object, &thread), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_exit_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_exit(NULL, (void *) 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_exit_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_exit((void *) 1, NULL),
+            ROCK_EPOCH_ERROR_THREAD_IS_NULL);
+}
+
+static void check_exit(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread thread;
+    assert_int_equal(rock_epoch_register(&object, &thread), 0);
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    assert_true(thread.is_active);
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    assert_false(thread.is_active);
+    assert_int_equal(0, thread.nesting);
+    assert_int_equal(rock_epoch_unregister(&object, &thread), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_retire_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_retire(NULL, (void *) 1, (void *) 1, (void *) 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_retire_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_retire((void *) 1, NULL, (void *) 1, (void *) 1),
+            ROCK_EPOCH_ERROR_THREAD_IS_NULL);
+}
+
+static void check_retire_error_on_item_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_retire((void *) 1, (void *) 1, NULL, (void *) 1),
+            ROCK_EPOCH_ERROR_ITEM_IS_NULL);
+}
+
+static void check_retire_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_retire((void *) 1, (void *) 1, (void *) 1, NULL),
+            ROCK_EPOCH_ERROR_FUNCTION_IS_NULL);
+}
+
+static void check_retire_error_on_memory_allocation_failed(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 16), 0);
+    struct rock_epoch_thread thread;
+    assert_int_equal(rock_epoch_register(&object, &thread), 0);
+    assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_epoch_retire(&object, &thread, &object, on_destroy),
+            ROCK_EPOCH_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+    assert_int_equal(rock_epoch_unregister(&object, &thread), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_retire(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 1000), 0);
+    struct rock_epoch_thread a, b;
+    assert_int_equal(rock_epoch_register(&object, &a), 0);
+    assert_int_equal(rock_epoch_register(&object, &b), 0);
+    assert_int_equal(rock_epoch_enter(&object, &b), 0);
+    assert_int_equal(rock_epoch_enter(&object, &a), 0);
+    assert_int_equal(rock_epoch_retire(&object, &a, &object, on_destroy), 0);
+    assert_int_equal(1, a.limbo[0].length);
+    assert_int_equal(rock_epoch_exit(&object, &a), 0);
+    /* b entered before the item was retired and holds it back */
+    assert_int_equal(rock_epoch_reclaim(&object, &a), 0);
+    assert_int_equal(rock_epoch_reclaim(&object, &a), 0);
+    assert_int_equal(1, object.epoch);
+    assert_int_equal(1, a.limbo[0].length);
+    assert_int_equal(rock_epoch_exit(&object, &b), 0);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_epoch_reclaim(&object, &a), 0);
+    assert_int_equal(2, object.epoch);
+    assert_int_equal(0, a.limbo[0].length);
+    assert_int_equal(rock_epoch_unregister(&object, &a), 0);
+    assert_int_equal(rock_epoch_unregister(&object, &b), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_retire_on_threshold(void **state) {
+    struct rock_epoch object;
+    assert_int_equal(rock_epoch_init(&object, 4), 0);
+    struct rock_epoch_thread thread;
+    assert_int_equal(rock_epoch_register(&object, &thread), 0);
+    uintmax_t items[12];
+    /* each batch expires once the epoch has advanced twice since */
+    expect_function_calls(on_destroy, 8);
+    for (uintmax_t i = 0; i < 12; i++) {
+        assert_int_equal(rock_epoch_enter(&object, &thread), 0);
+        assert_int_equal(rock_epoch_retire(&object, &thread, &items[i],
+                                           on_destroy), 0);
+        assert_int_equal(rock_epoch_exit(&object, &thread), 0);
+        if (!((i + 1) % 4)) {
+            assert_int_equal((i + 1) / 4, object.epoch);
+        }
+    }
+    assert_int_equal(4, thread.limbo[0].length + thread.limbo[1].length
+                        + thread.limbo[2].length);
+    expect_function_calls(on_destroy, 4);
+    assert_int_equal(rock_epoch_reclaim(&object, &thread), 0);
+    assert_int_equal(0, thread.limbo[0].length + thread.limbo[1].length
+                        + thread.limbo[2].length);
+    assert_int_equal(rock_epoch_unregister(&object, &thread), 0);
+    assert_int_equal(rock_epoch_invalidate(&object), 0);
+}
+
+static void check_reclaim_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_reclaim(NULL, (void *) 1),
+            ROCK_EPOCH_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_reclaim_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_epoch_reclaim((void *) 1, NULL),
+            ROCK_EPOCH_ERROR_THREAD_IS_NULL);
+}
+
+#define STRESS_THREADS          4
+#define STRESS_ITERATIONS       20000
+#define STRESS_CANARY           0x5ca1ab1e
+
+struct value {
+    uintmax_t canary;
+};
+
+struct stress {
+    struct rock_epoch epoch;
+    struct value *_Atomic current;
+    atomic_bool is_failed;
+};
+
+static void on_destroy_value(void *item) {
+    struct value *const value = item;
+    value->canary = 0;
+    free(value);
+}
+
+static void *worker(void *arg) {
+    struct stress *const stress = arg;
+    struct rock_epoch_thread thread;
+    if (rock_epoch_register(&stress->epoch, &thread)) {
+        atomic_store(&stress->is_failed, true);
+        return NULL;
+    }
+    for (uintmax_t i = 0; i < STRESS_ITERATIONS; i++) {
+        rock_epoch_enter(&stress->epoch, &thread);
+        if (i % 8) {
+            const struct value *const value = atomic_load(&stress->current);
+            if (STRESS_CANARY != value->canary) {
+                atomic_store(&stress->is_failed, true);
+            }
+        } else {
+            struct value *const value = malloc(sizeof(*value));
+            if (!value) {
+                atomic_store(&stress->is_failed, true);
+            } else {
+                value->canary = STRESS_CANARY;
+                struct value *const previous
+                        = atomic_exchange(&stress->current, value);
+                if (rock_epoch_retire(&stress->epoch, &thread, previous,
+                                      on_destroy_value)) {
+                    atomic_store(&stress->is_failed, true);
+                }
+            }
+        }
+        rock_epoch_exit(&stress->epoch, &thread);
+    }
+    if (rock_epoch_unregister(&stress->epoch, &thread)) {
+        atomic_store(&stress->is_failed, true);
+    }
+    return NULL;
+}
+
+static void check_stress(void **state) {
+    struct stress stress = {};
+    assert_int_equal(rock_epoch_init(&stress.epoch, 32), 0);
+    struct value *const value = malloc(sizeof(*value));
+    assert_non_null(value);
+    value->canary = STRESS_CANARY;
+    atomic_init(&stress.current, value);
+    pthread_t threads[STRESS_THREADS];
+    for (uintmax_t i = 0; i < STRESS_THREADS; i++) {
+        assert_int_equal(pthread_create(&threads[i], NULL, worker, &stress),
+                         0);
+    }
+    for (uintmax_t i = 0; i < STRESS_THREADS; i++) {
+        assert_int_equal(pthread_join(threads[i], NULL), 0);
+    }
+    assert_false(stress.is_failed);
+    assert_int_equal(rock_epoch_invalidate(&stress.epoch), 0);
+    on_destroy_value(atomic_load(&stress.current));
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_threshold_is_zero),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_register_error_on_object_is_null),
+            cmocka_unit_test(check_register_error_on_thread_is_null),
+            cmocka_unit_test(check_register),
+            cmocka_unit_test(check_unregister_error_on_object_is_null),
+            cmocka_unit_test(check_unregister_error_on_thread_is_null),
+            cmocka_unit_test(
+                    check_unregister_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_unregister),
+            cmocka_unit_test(check_enter_error_on_object_is_null),
+            cmocka_unit_test(check_enter_error_on_thread_is_null),
+            cmocka_unit_test(check_enter),
+            cmocka_unit_test(check_exit_error_on_object_is_null),
+            cmocka_unit_test(check_exit_error_on_thread_is_null),
+            cmocka_unit_test(check_exit),
+            cmocka_unit_test(check_retire_error_on_object_is_null),
+            cmocka_unit_test(check_retire_error_on_thread_is_null),
+            cmocka_unit_test(check_retire_error_on_item_is_null),
+            cmocka_unit_test(check_retire_error_on_function_is_null),
+            cmocka_unit_test(check_retire_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_retire),
+            cmocka_unit_test(check_retire_on_threshold),
+            cmocka_unit_test(check_reclaim_error_on_object_is_null),
+            cmocka_unit_test(check_reclaim_error_on_thread_is_null),
+            cmocka_unit_test(check_stress),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,553 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <rock.h>
+
+#include "private/hazard.h"
+#include <test/cmocka.h>
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_init(NULL, 1),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_error_on_threshold_is_zero(void **state) {
+    assert_int_equal(
+            rock_hazard_init((void *) 1, 0),
+            ROCK_HAZARD_ERROR_THRESHOLD_IS_ZERO);
+}
+
+static void check_init(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    assert_int_equal(16, object.threshold);
+    assert_int_equal(0, object.orphans.length);
+    assert_ptr_equal(&object.threads, object.threads.next);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_invalidate(NULL),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void on_destroy(void *item) {
+    function_called();
+}
+
+static void check_invalidate(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    const struct rock_hazard_item item = {
+            .item = &object,
+            .on_destroy = on_destroy
+    };
+    assert_int_equal(rock_array_add(&object.orphans, &item), 0);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_register_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_register(NULL, (void *) 1),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_register_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_register((void *) 1, NULL),
+            ROCK_HAZARD_ERROR_THREAD_IS_NULL);
+}
+
+static void check_register(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread a, b;
+    assert_int_equal(rock_hazard_register(&object, &a), 0);
+    assert_int_equal(rock_hazard_register(&object, &b), 0);
+    for (uintmax_t i = 0; i < ROCK_HAZARD_SLOTS; i++) {
+        assert_null(a.slots[i]);
+    }
+    assert_int_equal(0, a.retired.length);
+    assert_ptr_equal(&a.node, object.threads.next);
+    assert_ptr_equal(&b.node, a.node.next);
+    assert_int_equal(rock_hazard_unregister(&object, &a), 0);
+    assert_int_equal(rock_hazard_unregister(&object, &b), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_unregister_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_unregister(NULL, (void *) 1),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_unregister_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_unregister((void *) 1, NULL),
+            ROCK_HAZARD_ERROR_THREAD_IS_NULL);
+}
+
+static void check_unregister_error_on_memory_allocation_failed(
+        void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    assert_int_equal(rock_hazard_retire(&object, &thread, &object,
+                                        on_destroy), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_hazard_unregister(&object, &thread),
+            ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_ptr_equal(&thread.node, object.threads.next);
+    assert_int_equal(1, thread.retired.length);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(0, object.orphans.length);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_unregister(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread a, b;
+    assert_int_equal(rock_hazard_register(&object, &a), 0);
+    assert_int_equal(rock_hazard_register(&object, &b), 0);
+    void *_Atomic source = &object;
+    void *out;
+    assert_int_equal(rock_hazard_protect(&object, &a, 1, &source, &out), 0);
+    atomic_store(&source, NULL);
+    assert_int_equal(rock_hazard_retire(&object, &b, out, on_destroy), 0);
+    assert_int_equal(rock_hazard_retire(&object, &b, &b, on_destroy), 0);
+    /* only the item protected by a is handed over */
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_hazard_unregister(&object, &b), 0);
+    assert_int_equal(1, object.orphans.length);
+    assert_int_equal(rock_hazard_clear(&object, &a, 1), 0);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_hazard_reclaim(&object, &a), 0);
+    assert_int_equal(0, object.orphans.length);
+    assert_int_equal(rock_hazard_unregister(&object, &a), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_protect_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_protect(NULL, (void *) 1, 0, (void *) 1,
+                                (void *) 1),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_protect_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_protect((void *) 1, NULL, 0, (void *) 1,
+                                (void *) 1),
+            ROCK_HAZARD_ERROR_THREAD_IS_NULL);
+}
+
+static void check_protect_error_on_slot_is_out_of_bounds(void **state) {
+    assert_int_equal(
+            rock_hazard_protect((void *) 1, (void *) 1, ROCK_HAZARD_SLOTS,
+                                (void *) 1, (void *) 1),
+            ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS);
+}
+
+static void check_protect_error_on_source_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_protect((void *) 1, (void *) 1, 0, NULL,
+                                (void *) 1),
+            ROCK_HAZARD_ERROR_SOURCE_IS_NULL);
+}
+
+static void check_protect_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_protect((void *) 1, (void *) 1, 0, (void *) 1,
+                                NULL),
+            ROCK_HAZARD_ERROR_OUT_IS_NULL);
+}
+
+static void check_protect(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    void *_Atomic source = &object;
+    void *out;
+    assert_int_equal(rock_hazard_protect(&object, &thread, 2, &source, &out),
+                     0);
+    assert_ptr_equal(&object, out);
+    assert_ptr_equal(&object, thread.slots[2]);
+    atomic_store(&source, NULL);
+    assert_int_equal(rock_hazard_protect(&object, &thread, 3, &source, &out),
+                     0);
+    assert_null(out);
+    assert_null(thread.slots[3]);
+    assert_int_equal(rock_hazard_clear(&object, &thread, 2), 0);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_clear_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_clear(NULL, (void *) 1, 0),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_clear_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_clear((void *) 1, NULL, 0),
+            ROCK_HAZARD_ERROR_THREAD_IS_NULL);
+}
+
+static void check_clear_error_on_slot_is_out_of_bounds(void **state) {
+    assert_int_equal(
+            rock_hazard_clear((void *) 1, (void *) 1, ROCK_HAZARD_SLOTS),
+            ROCK_HAZARD_ERROR_SLOT_IS_OUT_OF_BOUNDS);
+}
+
+static void check_clear(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    void *_Atomic source = &object;
+    void *out;
+    assert_int_equal(rock_hazard_protect(&object, &thread, 0, &source, &out),
+                     0);
+    assert_int_equal(rock_hazard_clear(&object, &thread, 0), 0);
+    assert_null(thread.slots[0]);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_retire_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_retire(NULL, (void *) 1, (void *) 1, (void *) 1),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_retire_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_retire((void *) 1, NULL, (void *) 1, (void *) 1),
+            ROCK_HAZARD_ERROR_THREAD_IS_NULL);
+}
+
+static void check_retire_error_on_item_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_retire((void *) 1, (void *) 1, NULL, (void *) 1),
+            ROCK_HAZARD_ERROR_ITEM_IS_NULL);
+}
+
+static void check_retire_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_retire((void *) 1, (void *) 1, (void *) 1, NULL),
+            ROCK_HAZARD_ERROR_FUNCTION_IS_NULL);
+}
+
+static void check_retire_error_on_memory_allocation_failed(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_hazard_retire(&object, &thread, &object, on_destroy),
+            ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(0, thread.retired.length);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_retire(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 1000), 0);
+    struct rock_hazard_thread a, b;
+    assert_int_equal(rock_hazard_register(&object, &a), 0);
+    assert_int_equal(rock_hazard_register(&object, &b), 0);
+    void *_Atomic source = &object;
+    void *out;
+    assert_int_equal(rock_hazard_protect(&object, &b, 0, &source, &out), 0);
+    atomic_store(&source, NULL);
+    assert_int_equal(rock_hazard_retire(&object, &a, out, on_destroy), 0);
+    assert_int_equal(1, a.retired.length);
+    /* b protects the item and holds it back */
+    assert_int_equal(rock_hazard_reclaim(&object, &a), 0);
+    assert_int_equal(1, a.retired.length);
+    assert_int_equal(rock_hazard_clear(&object, &b, 0), 0);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_hazard_reclaim(&object, &a), 0);
+    assert_int_equal(0, a.retired.length);
+    assert_int_equal(rock_hazard_unregister(&object, &a), 0);
+    assert_int_equal(rock_hazard_unregister(&object, &b), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_retire_on_threshold(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 4), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    uintmax_t items[10];
+    void *_Atomic source = &items[0];
+    void *out;
+    assert_int_equal(rock_hazard_protect(&object, &thread, 0, &source, &out),
+                     0);
+    /* every scan destroys all but the protected item which then does not
+     * count towards the next scan */
+    expect_function_calls(on_destroy, 7);
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_int_equal(rock_hazard_retire(&object, &thread, &items[i],
+                                            on_destroy), 0);
+    }
+    assert_int_equal(3, thread.retired.length);
+    assert_int_equal(5, thread.watermark);
+    assert_int_equal(rock_hazard_clear(&object, &thread, 0), 0);
+    expect_function_calls(on_destroy, 3);
+    assert_int_equal(rock_hazard_reclaim(&object, &thread), 0);
+    assert_int_equal(0, thread.retired.length);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_retire_on_threshold_with_pinned_items(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 2), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    uintmax_t items[4];
+    void *out;
+    for (uintmax_t i = 0; i < 2; i++) {
+        void *_Atomic source = &items[i];
+        assert_int_equal(rock_hazard_protect(&object, &thread, i, &source,
+                                             &out), 0);
+    }
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_int_equal(rock_hazard_retire(&object, &thread, &items[i],
+                                            on_destroy), 0);
+    }
+    /* pinned items do not cause a scan upon the next retire */
+    assert_int_equal(2, thread.retired.length);
+    assert_int_equal(4, thread.watermark);
+    assert_int_equal(rock_hazard_retire(&object, &thread, &items[2],
+                                        on_destroy), 0);
+    assert_int_equal(3, thread.retired.length);
+    expect_function_calls(on_destroy, 2);
+    assert_int_equal(rock_hazard_retire(&object, &thread, &items[3],
+                                        on_destroy), 0);
+    assert_int_equal(2, thread.retired.length);
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_int_equal(rock_hazard_clear(&object, &thread, i), 0);
+    }
+    expect_function_calls(on_destroy, 2);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+static void check_reclaim_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_reclaim(NULL, (void *) 1),
+            ROCK_HAZARD_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_reclaim_error_on_thread_is_null(void **state) {
+    assert_int_equal(
+            rock_hazard_reclaim((void *) 1, NULL),
+            ROCK_HAZARD_ERROR_THREAD_IS_NULL);
+}
+
+static void check_reclaim_error_on_memory_allocation_failed(void **state) {
+    struct rock_hazard object;
+    assert_int_equal(rock_hazard_init(&object, 16), 0);
+    struct rock_hazard_thread thread;
+    assert_int_equal(rock_hazard_register(&object, &thread), 0);
+    assert_int_equal(rock_hazard_retire(&object, &thread, &object,
+                                        on_destroy), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_hazard_reclaim(&object, &thread),
+            ROCK_HAZARD_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(1, thread.retired.length);
+    expect_function_call(on_destroy);
+    assert_int_equal(rock_hazard_unregister(&object, &thread), 0);
+    assert_int_equal(rock_hazard_invalidate(&object), 0);
+}
+
+#define STRESS_THREADS          4
+#define STRESS_ITERATIONS       20000
+#define STRESS_CANARY           0x5ca1ab1e
+
+struct value {
+    struct rock_forward_list_node node;
+    uintmax_t canary;
+};
+
+struct stress {
+    struct rock_hazard hazard;
+    struct rock_forward_list_node *_Atomic head;
+    atomic_uintmax_t pushed;
+    atomic_uintmax_t popped;
+    atomic_bool is_failed;
+};
+
+static void on_destroy_value(void *item) {
+    struct value *const value = item;
+    value->canary = 0;
+    free(value);
+}
+
+static void push(struct stress *const stress, struct value *const value) {
+    struct rock_forward_list_node *head = atomic_load(&stress->head);
+    do {
+        value->node.next = head;
+    } while (!atomic_compare_exchange_weak(&stress->head, &head,
+                                           &value->node));
+}
+
+static struct value *pop(struct stress *const stress,
+                         struct rock_hazard_thread *const thread) {
+    void *_Atomic const *const source = (void *_Atomic const *) &stress->head;
+    void *out;
+    while (true) {
+        if (rock_hazard_protect(&stress->hazard, thread, 0, source, &out)) {
+            atomic_store(&stress->is_failed, true);
+            return NULL;
+        }
+        struct rock_forward_list_node *node = out;
+        if (!node) {
+            return NULL;
+        }
+        /* node cannot be destroyed, and hence reused, while it is protected
+         * which rules out ABA on the head */
+        struct value *const value
+                = rock_container_of(node, struct value, node);
+        if (STRESS_CANARY != value->canary) {
+            atomic_store(&stress->is_failed, true);
+        }
+        if (atomic_compare_exchange_strong(&stress->head, &node,
+                                           node->next)) {
+            rock_hazard_clear(&stress->hazard, thread, 0);
+            return value;
+        }
+    }
+}
+
+static void *worker(void *arg) {
+    struct stress *const stress = arg;
+    struct rock_hazard_thread thread;
+    if (rock_hazard_register(&stress->hazard, &thread)) {
+        atomic_store(&stress->is_failed, true);
+        return NULL;
+    }
+    for (uintmax_t i = 0; i < STRESS_ITERATIONS; i++) {
+        if (i % 3 != 2) {
+            struct value *const value = malloc(sizeof(*value));
+            if (!value) {
+                atomic_store(&stress->is_failed, true);
+                continue;
+            }
+            value->canary = STRESS_CANARY;
+            push(stress, value);
+            atomic_fetch_add(&stress->pushed, 1);
+            continue;
+        }
+        for (uintmax_t o = 0; o < 2; o++) {
+            struct value *const value = pop(stress, &thread);
+            if (!value) {
+                continue;
+            }
+            atomic_fetch_add(&stress->popped, 1);
+            if (rock_hazard_retire(&stress->hazard, &thread, value,
+                                   on_destroy_value)) {
+                atomic_store(&stress->is_failed, true);
+            }
+        }
+    }
+    if (rock_hazard_unregister(&stress->hazard, &thread)) {
+        atomic_store(&stress->is_failed, true);
+    }
+    return NULL;
+}
+
+static void check_stress(void **state) {
+    struct stress stress = {};
+    assert_int_equal(rock_hazard_init(&stress.hazard, 32), 0);
+    atomic_init(&stress.head, NULL);
+    pthread_t threads[STRESS_THREADS];
+    for (uintmax_t i = 0; i < STRESS_THREADS; i++) {
+        assert_int_equal(pthread_create(&threads[i], NULL, worker, &stress),
+                         0);
+    }
+    for (uintmax_t i = 0; i < STRESS_THREADS; i++) {
+        assert_int_equal(pthread_join(threads[i], NULL), 0);
+    }
+    assert_false(stress.is_failed);
+    assert_int_equal(rock_hazard_invalidate(&stress.hazard), 0);
+    uintmax_t count = 0;
+    struct rock_forward_list_node *node = atomic_load(&stress.head);
+    while (node) {
+        struct rock_forward_list_node *const next = node->next;
+        on_destroy_value(rock_container_of(node, struct value, node));
+        node = next;
+        count++;
+    }
+    assert_int_equal(stress.pushed, stress.popped + count);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_threshold_is_zero),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_register_error_on_object_is_null),
+            cmocka_unit_test(check_register_error_on_thread_is_null),
+            cmocka_unit_test(check_register),
+            cmocka_unit_test(check_unregister_error_on_object_is_null),
+            cmocka_unit_test(check_unregister_error_on_thread_is_null),
+            cmocka_unit_test(
+                    check_unregister_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_unregister),
+            cmocka_unit_test(check_protect_error_on_object_is_null),
+            cmocka_unit_test(check_protect_error_on_thread_is_null),
+            cmocka_unit_test(check_protect_error_on_slot_is_out_of_bounds),
+            cmocka_unit_test(check_protect_error_on_source_is_null),
+            cmocka_unit_test(check_protect_error_on_out_is_null),
+            cmocka_unit_test(check_protect),
+            cmocka_unit_test(check_clear_error_on_object_is_null),
+            cmocka_unit_test(check_clear_error_on_thread_is_null),
+            cmocka_unit_test(check_clear_error_on_slot_is_out_of_bounds),
+            cmocka_unit_test(check_clear),
+            cmocka_unit_test(check_retire_error_on_object_is_null),
+            cmocka_unit_test(check_retire_error_on_thread_is_null),
+            cmocka_unit_test(check_retire_error_on_item_is_null),
+            cmocka_unit_test(check_retire_error_on_function_is_null),
+            cmocka_unit_test(check_retire_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_retire),
+            cmocka_unit_test(check_retire_on_threshold),
+            cmocka_unit_test(check_retire_on_threshold_with_pinned_items),
+            cmocka_unit_test(check_reclaim_error_on_object_is_null),
+            cmocka_unit_test(check_reclaim_error_on_thread_is_null),
+            cmocka_unit_test(check_reclaim_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_stress),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
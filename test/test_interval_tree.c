@@ -0,0 +1,382 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <time.h>
+#include <rock.h>
+
+#include "private/red_black_tree.h"
+#include <test/cmocka.h>
+
+#define COUNT   512
+#define RANGE   1024
+
+static void check_node_init_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_node_init(NULL, 0, 0),
+            ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_node_init_error_on_interval_is_invalid(void **state) {
+    struct rock_interval_tree_node node;
+    assert_int_equal(
+            rock_interval_tree_node_init(&node, 2, 1),
+            ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID);
+}
+
+static void check_node_init(void **state) {
+    struct rock_interval_tree_node node;
+    assert_int_equal(rock_interval_tree_node_init(&node, 1, 2), 0);
+    assert_int_equal(1, node.low);
+    assert_int_equal(2, node.high);
+    assert_int_equal(2, node.max);
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_init(NULL),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init(void **state) {
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    assert_null(object.tree.root);
+    assert_int_equal(0, object.tree.count);
+    assert_int_equal(rock_interval_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_invalidate(NULL, NULL),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void on_destroy(struct rock_interval_tree_node *node) {
+    function_called();
+    assert_non_null(node);
+}
+
+static void check_invalidate(void **state) {
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    struct rock_interval_tree_node nodes[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(rock_interval_tree_node_init(&nodes[i], i, 2 * i),
+                         0);
+        assert_int_equal(rock_interval_tree_insert(&object, &nodes[i]), 0);
+    }
+    expect_function_calls(on_destroy, 3);
+    assert_int_equal(rock_interval_tree_invalidate(&object, on_destroy), 0);
+    assert_null(object.tree.root);
+}
+
+static void check_count_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_count(NULL, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_count_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_count((void *) 1, NULL),
+            ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_insert_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_insert(NULL, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_insert_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_insert((void *) 1, NULL),
+            ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_insert(void **state) {
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    struct rock_interval_tree_node a, b;
+    assert_int_equal(rock_interval_tree_node_init(&a, 5, 10), 0);
+    assert_int_equal(rock_interval_tree_node_init(&b, 5, 10), 0);
+    assert_int_equal(rock_interval_tree_insert(&object, &a), 0);
+    /* equal intervals are permitted */
+    assert_int_equal(rock_interval_tree_insert(&object, &b), 0);
+    uintmax_t count;
+    assert_int_equal(rock_interval_tree_count(&object, &count), 0);
+    assert_int_equal(2, count);
+    assert_int_equal(rock_interval_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_remove(NULL, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_remove_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_remove((void *) 1, NULL),
+            ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_overlap_first_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_overlap_first(NULL, 0, 0, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_overlap_first_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_overlap_first((void *) 1, 0, 0, NULL),
+            ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_overlap_first_error_on_interval_is_invalid(void **state) {
+    assert_int_equal(
+            rock_interval_tree_overlap_first((void *) 1, 1, 0, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID);
+}
+
+static void check_overlap_first_error_on_node_not_found(void **state) {
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    struct rock_interval_tree_node *out;
+    assert_int_equal(
+            rock_interval_tree_overlap_first(&object, 0, 0, &out),
+            ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND);
+    struct rock_interval_tree_node node;
+    assert_int_equal(rock_interval_tree_node_init(&node, 5, 10), 0);
+    assert_int_equal(rock_interval_tree_insert(&object, &node), 0);
+    assert_int_equal(
+            rock_interval_tree_overlap_first(&object, 0, 4, &out),
+            ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND);
+    assert_int_equal(
+            rock_interval_tree_overlap_first(&object, 11, 20, &out),
+            ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND);
+    assert_int_equal(rock_interval_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_overlap_next_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_overlap_next(NULL, 0, 0, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_overlap_next_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_overlap_next((void *) 1, 0, 0, NULL),
+            ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_overlap_next_error_on_interval_is_invalid(void **state) {
+    assert_int_equal(
+            rock_interval_tree_overlap_next((void *) 1, 1, 0, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_INTERVAL_IS_INVALID);
+}
+
+static void check_overlap_next_error_on_end_of_sequence(void **state) {
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    struct rock_interval_tree_node a, b;
+    assert_int_equal(rock_interval_tree_node_init(&a, 5, 10), 0);
+    assert_int_equal(rock_interval_tree_node_init(&b, 20, 30), 0);
+    assert_int_equal(rock_interval_tree_insert(&object, &a), 0);
+    assert_int_equal(rock_interval_tree_insert(&object, &b), 0);
+    struct rock_interval_tree_node *out;
+    assert_int_equal(
+            rock_interval_tree_overlap_first(&object, 0, 15, &out), 0);
+    assert_ptr_equal(&a, out);
+    assert_int_equal(
+            rock_interval_tree_overlap_next(out, 0, 15, &out),
+            ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE);
+    assert_int_equal(rock_interval_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_stab_first_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_stab_first(NULL, 0, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_stab_first_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_stab_first((void *) 1, 0, NULL),
+            ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_stab_next_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_stab_next(NULL, 0, (void *) 1),
+            ROCK_INTERVAL_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_stab_next_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_interval_tree_stab_next((void *) 1, 0, NULL),
+            ROCK_INTERVAL_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_stab(void **state) {
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    struct rock_interval_tree_node nodes[4];
+    assert_int_equal(rock_interval_tree_node_init(&nodes[0], 0, 100), 0);
+    assert_int_equal(rock_interval_tree_node_init(&nodes[1], 10, 20), 0);
+    assert_int_equal(rock_interval_tree_node_init(&nodes[2], 15, 15), 0);
+    assert_int_equal(rock_interval_tree_node_init(&nodes[3], 30, 40), 0);
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(rock_interval_tree_insert(&object, &nodes[i]), 0);
+    }
+    struct rock_interval_tree_node *out;
+    assert_int_equal(rock_interval_tree_stab_first(&object, 15, &out), 0);
+    assert_ptr_equal(&nodes[0], out);
+    assert_int_equal(rock_interval_tree_stab_next(out, 15, &out), 0);
+    assert_ptr_equal(&nodes[1], out);
+    assert_int_equal(rock_interval_tree_stab_next(out, 15, &out), 0);
+    assert_ptr_equal(&nodes[2], out);
+    assert_int_equal(
+            rock_interval_tree_stab_next(out, 15, &out),
+            ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE);
+    assert_int_equal(rock_interval_tree_stab_first(&object, 101, &out),
+                     ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND);
+    assert_int_equal(rock_interval_tree_invalidate(&object, NULL), 0);
+}
+
+static uintmax_t assert_max(const struct rock_red_black_tree_node *const node) {
+    if (!node) {
+        return 0;
+    }
+    struct rock_red_black_tree_node *left;
+    struct rock_red_black_tree_node *right;
+    assert_int_equal(rock_red_black_tree_node_get_left(node, &left), 0);
+    assert_int_equal(rock_red_black_tree_node_get_right(node, &right), 0);
+    const struct rock_interval_tree_node *const N = rock_container_of(
+            node, struct rock_interval_tree_node, node);
+    uintmax_t max = N->high;
+    const uintmax_t l = assert_max(left);
+    const uintmax_t r = assert_max(right);
+    if (l > max) {
+        max = l;
+    }
+    if (r > max) {
+        max = r;
+    }
+    assert_int_equal(max, N->max);
+    return max;
+}
+
+static void assert_overlap(const struct rock_interval_tree *const object,
+                           const struct rock_interval_tree_node *const nodes,
+                           const bool *const present,
+                           const uintmax_t low,
+                           const uintmax_t high) {
+    uintmax_t expected = 0;
+    for (uintmax_t i = 0; i < COUNT; i++) {
+        if (present[i] && nodes[i].low <= high && low <= nodes[i].high) {
+            expected++;
+        }
+    }
+    uintmax_t found = 0;
+    struct rock_interval_tree_node *prev = NULL;
+    struct rock_interval_tree_node *out;
+    int error = rock_interval_tree_overlap_first(object, low, high, &out);
+    while (!error) {
+        assert_true(out->low <= high && low <= out->high);
+        assert_true(present[out - nodes]);
+        if (prev) {
+            /* overlapping intervals are retrieved in order */
+            assert_true(prev->low < out->low
+                        || (prev->low == out->low && prev->high < out->high)
+                        || (prev->low == out->low && prev->high == out->high
+                            && prev < out));
+        }
+        prev = out;
+        found++;
+        error = rock_interval_tree_overlap_next(out, low, high, &out);
+    }
+    assert_int_equal(expected, found);
+    assert_int_equal(found
+                     ? ROCK_INTERVAL_TREE_ERROR_END_OF_SEQUENCE
+                     : ROCK_INTERVAL_TREE_ERROR_NODE_NOT_FOUND,
+                     error);
+}
+
+static void check_overlap(void **state) {
+    srand(time(NULL));
+    struct rock_interval_tree object;
+    assert_int_equal(rock_interval_tree_init(&object), 0);
+    struct rock_interval_tree_node *nodes = calloc(COUNT, sizeof(*nodes));
+    assert_non_null(nodes);
+    bool present[COUNT] = {};
+    for (uintmax_t i = 0; i < COUNT; i++) {
+        const uintmax_t low = rand() % RANGE;
+        const uintmax_t high = low + rand() % (RANGE / 16);
+        assert_int_equal(rock_interval_tree_node_init(&nodes[i], low, high),
+                         0);
+        assert_int_equal(rock_interval_tree_insert(&object, &nodes[i]), 0);
+        present[i] = true;
+    }
+    assert_max(object.tree.root);
+    for (uintmax_t i = 0; i < 64; i++) {
+        const uintmax_t low = rand() % (RANGE + RANGE / 8);
+        const uintmax_t high = low + rand() % (RANGE / 8);
+        assert_overlap(&object, nodes, present, low, high);
+        assert_overlap(&object, nodes, present, low, low);
+    }
+    for (uintmax_t i = 0; i < COUNT; i += 2) {
+        assert_int_equal(rock_interval_tree_remove(&object, &nodes[i]), 0);
+        present[i] = false;
+    }
+    uintmax_t count;
+    assert_int_equal(rock_interval_tree_count(&object, &count), 0);
+    assert_int_equal(COUNT / 2, count);
+    assert_max(object.tree.root);
+    for (uintmax_t i = 0; i < 64; i++) {
+        const uintmax_t low = rand() % (RANGE + RANGE / 8);
+        const uintmax_t high = low + rand() % (RANGE / 8);
+        assert_overlap(&object, nodes, present, low, high);
+        assert_overlap(&object, nodes, present, low, low);
+    }
+    assert_int_equal(rock_interval_tree_invalidate(&object, NULL), 0);
+    free(nodes);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_node_init_error_on_node_is_null),
+            cmocka_unit_test(check_node_init_error_on_interval_is_invalid),
+            cmocka_unit_test(check_node_init),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_count_error_on_object_is_null),
+            cmocka_unit_test(check_count_error_on_out_is_null),
+            cmocka_unit_test(check_insert_error_on_object_is_null),
+            cmocka_unit_test(check_insert_error_on_node_is_null),
+            cmocka_unit_test(check_insert),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_node_is_null),
+            cmocka_unit_test(check_overlap_first_error_on_object_is_null),
+            cmocka_unit_test(check_overlap_first_error_on_out_is_null),
+            cmocka_unit_test(check_overlap_first_error_on_interval_is_invalid),
+            cmocka_unit_test(check_overlap_first_error_on_node_not_found),
+            cmocka_unit_test(check_overlap_next_error_on_node_is_null),
+            cmocka_unit_test(check_overlap_next_error_on_out_is_null),
+            cmocka_unit_test(check_overlap_next_error_on_interval_is_invalid),
+            cmocka_unit_test(check_overlap_next_error_on_end_of_sequence),
+            cmocka_unit_test(check_overlap),
+            cmocka_unit_test(check_stab_first_error_on_object_is_null),
+            cmocka_unit_test(check_stab_first_error_on_out_is_null),
+            cmocka_unit_test(check_stab_next_error_on_node_is_null),
+            cmocka_unit_test(check_stab_next_error_on_out_is_null),
+            cmocka_unit_test(check_stab),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,434 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <rock.h>
+
+#include "private/rcu_array.h"
+#include <test/cmocka.h>
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_init(NULL, sizeof(uintmax_t)),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    assert_int_equal(
+            rock_rcu_array_init((void *) 1, 0),
+            ROCK_RCU_ARRAY_ERROR_SIZE_IS_ZERO);
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    struct rock_rcu_array object;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_rcu_array_init(&object, sizeof(uintmax_t)),
+            ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+}
+
+static void check_init(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    assert_int_equal(sizeof(uintmax_t), object.size);
+    assert_non_null(object.current);
+    assert_int_equal(0, object.current->array.length);
+    assert_null(object.retired);
+    assert_ptr_equal(&object.readers, object.readers.next);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_invalidate(NULL, NULL),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void on_destroy(void *item) {
+    function_called();
+}
+
+static void publish(struct rock_rcu_array *const object,
+                    const uintmax_t count) {
+    struct rock_array array;
+    assert_int_equal(rock_array_init(&array, sizeof(uintmax_t), count), 0);
+    for (uintmax_t i = 0; i < count; i++) {
+        assert_int_equal(rock_array_add(&array, &i), 0);
+    }
+    assert_int_equal(rock_rcu_array_publish(object, &array), 0);
+}
+
+static void check_invalidate(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    struct rock_rcu_array_reader reader;
+    assert_int_equal(rock_rcu_array_register(&object, &reader), 0);
+    publish(&object, 2);
+    publish(&object, 3);
+    assert_non_null(object.retired);
+    assert_int_equal(rock_rcu_array_unregister(&object, &reader), 0);
+    expect_function_calls(on_destroy, 3);
+    assert_int_equal(rock_rcu_array_invalidate(&object, on_destroy), 0);
+}
+
+static void check_size_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_size(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_size_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_size((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL);
+}
+
+static void check_size(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, 17), 0);
+    size_t size;
+    assert_int_equal(rock_rcu_array_size(&object, &size), 0);
+    assert_int_equal(17, size);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_register_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_register(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_register_error_on_reader_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_register((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_READER_IS_NULL);
+}
+
+static void check_register(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    publish(&object, 1);
+    struct rock_rcu_array_reader reader;
+    assert_int_equal(rock_rcu_array_register(&object, &reader), 0);
+    assert_int_equal(object.epoch, reader.epoch);
+    assert_ptr_equal(&reader.node, object.readers.next);
+    assert_int_equal(rock_rcu_array_unregister(&object, &reader), 0);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_unregister_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_unregister(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_unregister_error_on_reader_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_unregister((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_READER_IS_NULL);
+}
+
+static void check_unregister(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    struct rock_rcu_array_reader reader;
+    assert_int_equal(rock_rcu_array_register(&object, &reader), 0);
+    publish(&object, 1);
+    assert_non_null(object.retired);
+    /* a departing reader no longer holds back the grace period */
+    assert_int_equal(rock_rcu_array_unregister(&object, &reader), 0);
+    assert_null(object.retired);
+    assert_ptr_equal(&object.readers, object.readers.next);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_acquire_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_acquire(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_acquire_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_acquire((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL);
+}
+
+static void check_acquire(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    const struct rock_array *array;
+    assert_int_equal(rock_rcu_array_acquire(&object, &array), 0);
+    assert_ptr_equal(&object.current->array, array);
+    assert_int_equal(0, array->length);
+    publish(&object, 4);
+    assert_int_equal(rock_rcu_array_acquire(&object, &array), 0);
+    assert_int_equal(4, array->length);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_quiescent_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_quiescent(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_quiescent_error_on_reader_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_quiescent((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_READER_IS_NULL);
+}
+
+static void check_quiescent(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    struct rock_rcu_array_reader a, b;
+    assert_int_equal(rock_rcu_array_register(&object, &a), 0);
+    assert_int_equal(rock_rcu_array_register(&object, &b), 0);
+    const struct rock_array *array;
+    assert_int_equal(rock_rcu_array_acquire(&object, &array), 0);
+    publish(&object, 1);
+    publish(&object, 2);
+    /* both readers may still hold either retired snapshot */
+    assert_non_null(object.retired);
+    assert_non_null(object.retired->retired);
+    assert_int_equal(rock_rcu_array_quiescent(&object, &a), 0);
+    rock_rcu_array_reclaim(&object);
+    assert_non_null(object.retired);
+    assert_int_equal(rock_rcu_array_quiescent(&object, &b), 0);
+    assert_int_equal(rock_rcu_array_synchronize(&object), 0);
+    assert_null(object.retired);
+    /* only snapshots retired before the oldest quiescent state go */
+    publish(&object, 3);
+    assert_int_equal(rock_rcu_array_quiescent(&object, &a), 0);
+    publish(&object, 4);
+    assert_int_equal(rock_rcu_array_quiescent(&object, &b), 0);
+    rock_rcu_array_reclaim(&object);
+    assert_non_null(object.retired);
+    assert_null(object.retired->retired);
+    assert_int_equal(3, object.retired->array.length);
+    assert_int_equal(rock_rcu_array_quiescent(&object, &a), 0);
+    assert_int_equal(rock_rcu_array_synchronize(&object), 0);
+    assert_null(object.retired);
+    assert_int_equal(rock_rcu_array_unregister(&object, &a), 0);
+    assert_int_equal(rock_rcu_array_unregister(&object, &b), 0);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_copy_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_copy(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_copy_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_copy((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_OUT_IS_NULL);
+}
+
+static void check_copy_error_on_memory_allocation_failed(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    publish(&object, 10);
+    struct rock_array array;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_rcu_array_copy(&object, &array),
+            ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_copy(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    struct rock_array array;
+    assert_int_equal(rock_rcu_array_copy(&object, &array), 0);
+    assert_int_equal(0, array.length);
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    publish(&object, 10);
+    assert_int_equal(rock_rcu_array_copy(&object, &array), 0);
+    assert_int_equal(10, array.length);
+    assert_ptr_not_equal(object.current->array.data, array.data);
+    for (uintmax_t i = 0; i < 10; i++) {
+        uintmax_t *item;
+        assert_int_equal(rock_array_get(&array, i, (void **) &item), 0);
+        assert_int_equal(i, *item);
+    }
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_publish_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_publish(NULL, (void *) 1),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_publish_error_on_array_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_publish((void *) 1, NULL),
+            ROCK_RCU_ARRAY_ERROR_ARRAY_IS_NULL);
+}
+
+static void check_publish_error_on_memory_allocation_failed(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    struct rock_array array;
+    assert_int_equal(rock_array_init(&array, sizeof(uintmax_t), 0), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_rcu_array_publish(&object, &array),
+            ROCK_RCU_ARRAY_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(sizeof(uintmax_t), array.size);
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_publish(void **state) {
+    struct rock_rcu_array object;
+    assert_int_equal(rock_rcu_array_init(&object, sizeof(uintmax_t)), 0);
+    struct rock_rcu_array_reader reader;
+    assert_int_equal(rock_rcu_array_register(&object, &reader), 0);
+    const struct rock_array *before;
+    assert_int_equal(rock_rcu_array_acquire(&object, &before), 0);
+    struct rock_array array;
+    assert_int_equal(rock_rcu_array_copy(&object, &array), 0);
+    const uintmax_t item = 42;
+    assert_int_equal(rock_array_add(&array, &item), 0);
+    const void *data = array.data;
+    assert_int_equal(rock_rcu_array_publish(&object, &array), 0);
+    assert_null(array.data);
+    assert_ptr_equal(data, object.current->array.data);
+    /* the snapshot held by the reader is still intact */
+    assert_ptr_equal(&object.retired->array, before);
+    assert_int_equal(0, before->length);
+    assert_int_equal(rock_rcu_array_quiescent(&object, &reader), 0);
+    assert_int_equal(rock_rcu_array_synchronize(&object), 0);
+    assert_null(object.retired);
+    assert_int_equal(rock_rcu_array_unregister(&object, &reader), 0);
+    assert_int_equal(rock_rcu_array_invalidate(&object, NULL), 0);
+}
+
+static void check_synchronize_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_rcu_array_synchronize(NULL),
+            ROCK_RCU_ARRAY_ERROR_OBJECT_IS_NULL);
+}
+
+#define STRESS_READERS          3
+#define STRESS_VERSIONS         2000
+
+struct stress {
+    struct rock_rcu_array array;
+    atomic_bool is_done;
+    atomic_bool is_failed;
+};
+
+static void *reader(void *arg) {
+    struct stress *const stress = arg;
+    struct rock_rcu_array_reader reader;
+    if (rock_rcu_array_register(&stress->array, &reader)) {
+        atomic_store(&stress->is_failed, true);
+        return NULL;
+    }
+    while (!atomic_load(&stress->is_done)) {
+        const struct rock_array *array;
+        if (rock_rcu_array_acquire(&stress->array, &array)) {
+            atomic_store(&stress->is_failed, true);
+        }
+        /* every version holds 0 .. length - 1 */
+        for (uintmax_t i = 0; i < array->length; i++) {
+            if (i != ((const uintmax_t *) array->data)[i]) {
+                atomic_store(&stress->is_failed, true);
+            }
+        }
+        if (rock_rcu_array_quiescent(&stress->array, &reader)) {
+            atomic_store(&stress->is_failed, true);
+        }
+    }
+    if (rock_rcu_array_unregister(&stress->array, &reader)) {
+        atomic_store(&stress->is_failed, true);
+    }
+    return NULL;
+}
+
+static void check_stress(void **state) {
+    struct stress stress = {};
+    assert_int_equal(rock_rcu_array_init(&stress.array, sizeof(uintmax_t)),
+                     0);
+    pthread_t readers[STRESS_READERS];
+    for (uintmax_t i = 0; i < STRESS_READERS; i++) {
+        assert_int_equal(pthread_create(&readers[i], NULL, reader, &stress),
+                         0);
+    }
+    for (uintmax_t i = 0; i < STRESS_VERSIONS; i++) {
+        struct rock_array array;
+        assert_int_equal(rock_rcu_array_copy(&stress.array, &array), 0);
+        if (array.length > 64) {
+            assert_int_equal(rock_array_set_length(&array, 0), 0);
+        }
+        const uintmax_t item = array.length;
+        assert_int_equal(rock_array_add(&array, &item), 0);
+        assert_int_equal(rock_rcu_array_publish(&stress.array, &array), 0);
+    }
+    atomic_store(&stress.is_done, true);
+    for (uintmax_t i = 0; i < STRESS_READERS; i++) {
+        assert_int_equal(pthread_join(readers[i], NULL), 0);
+    }
+    assert_false(stress.is_failed);
+    assert_int_equal(rock_rcu_array_synchronize(&stress.array), 0);
+    assert_null(stress.array.retired);
+    assert_int_equal(rock_rcu_array_invalidate(&stress.array, NULL), 0);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_size_error_on_object_is_null),
+            cmocka_unit_test(check_size_error_on_out_is_null),
+            cmocka_unit_test(check_size),
+            cmocka_unit_test(check_register_error_on_object_is_null),
+            cmocka_unit_test(check_register_error_on_reader_is_null),
+            cmocka_unit_test(check_register),
+            cmocka_unit_test(check_unregister_error_on_object_is_null),
+            cmocka_unit_test(check_unregister_error_on_reader_is_null),
+            cmocka_unit_test(check_unregister),
+            cmocka_unit_test(check_acquire_error_on_object_is_null),
+            cmocka_unit_test(check_acquire_error_on_out_is_null),
+            cmocka_unit_test(check_acquire),
+            cmocka_unit_test(check_quiescent_error_on_object_is_null),
+            cmocka_unit_test(check_quiescent_error_on_reader_is_null),
+            cmocka_unit_test(check_quiescent),
+            cmocka_unit_test(check_copy_error_on_object_is_null),
+            cmocka_unit_test(check_copy_error_on_out_is_null),
+            cmocka_unit_test(check_copy_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_copy),
+            cmocka_unit_test(check_publish_error_on_object_is_null),
+            cmocka_unit_test(check_publish_error_on_array_is_null),
+            cmocka_unit_test(check_publish_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_publish),
+            cmocka_unit_test(check_synchronize_error_on_object_is_null),
+            cmocka_unit_test(check_stress),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -4,6 +4,9 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include <string.h>
 #include <time.h>
 #include <stdio.h>
 #include <seagrass.h>
@@ -1364,6 +1367,459 @@ static void check_init(void **state) {
     assert_int_equal(0, object.count);
 }
 
+static void check_init_order_statistic_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_order_statistic(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_order_statistic_error_on_compare_is_null(
+        void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_order_statistic((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL);
+}
+
+static void check_init_order_statistic(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) UINTPTR_MAX,
+            .count = (-1),
+            .compare = (void *) UINTPTR_MAX,
+    };
+    assert_int_equal(rock_red_black_tree_init_order_statistic(
+            &object,
+            (int (*)(const struct rock_red_black_tree_node *,
+                     const struct rock_red_black_tree_node *))
+                    seagrass_void_ptr_compare), 0);
+    assert_null(object.root);
+    assert_ptr_equal(seagrass_void_ptr_compare, object.compare);
+    assert_int_equal(0, object.count);
+    assert_ptr_equal(&rock_red_black_tree_size_augment, object.augment);
+}
+
+static void check_init_augmented_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_augmented(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_augmented_error_on_compare_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_augmented((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL);
+}
+
+static void check_init_augmented_error_on_augment_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_augmented((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_AUGMENT_IS_NULL);
+}
+
+static void check_init_augmented_error_on_function_is_null(void **state) {
+    struct rock_red_black_tree_augment augment = {
+            .propagate = (void *) 1,
+            .copy = (void *) 1,
+            .rotate = (void *) 1
+    };
+    for (uintmax_t i = 0; i < 3; i++) {
+        struct rock_red_black_tree_augment incomplete = augment;
+        switch (i) {
+            case 0: {
+                incomplete.propagate = NULL;
+                break;
+            }
+            case 1: {
+                incomplete.copy = NULL;
+                break;
+            }
+            default: {
+                incomplete.rotate = NULL;
+            }
+        }
+        assert_int_equal(
+                rock_red_black_tree_init_augmented((void *) 1, (void *) 1,
+                                                   &incomplete),
+                ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL);
+    }
+}
+
+static void check_init_augmented(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) UINTPTR_MAX,
+            .count = (-1),
+            .compare = (void *) UINTPTR_MAX,
+    };
+    const struct rock_red_black_tree_augment augment = {
+            .propagate = (void *) 1,
+            .copy = (void *) 1,
+            .rotate = (void *) 1
+    };
+    assert_int_equal(rock_red_black_tree_init_augmented(
+            &object,
+            (int (*)(const struct rock_red_black_tree_node *,
+                     const struct rock_red_black_tree_node *))
+                    seagrass_void_ptr_compare,
+            &augment), 0);
+    assert_null(object.root);
+    assert_ptr_equal(seagrass_void_ptr_compare, object.compare);
+    assert_int_equal(0, object.count);
+    assert_ptr_equal(&augment, object.augment);
+}
+
+static void check_init_keyed_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_keyed(NULL, 0,
+                                           ROCK_RED_BLACK_TREE_KEY_UINT64),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_keyed_error_on_key_kind_is_invalid(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_keyed(
+                    (void *) 1, 0, ROCK_RED_BLACK_TREE_KEY_CALLBACK),
+            ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID);
+    assert_int_equal(
+            rock_red_black_tree_init_keyed(
+                    (void *) 1, 0, 1 + ROCK_RED_BLACK_TREE_KEY_CHARS),
+            ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID);
+}
+
+static void check_init_keyed(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) UINTPTR_MAX,
+            .count = (-1),
+            .compare = (void *) UINTPTR_MAX,
+    };
+    assert_int_equal(rock_red_black_tree_init_keyed(
+            &object, -8, ROCK_RED_BLACK_TREE_KEY_DOUBLE), 0);
+    assert_null(object.root);
+    assert_null(object.compare);
+    assert_int_equal(0, object.count);
+    assert_int_equal(-8, object.key_offset);
+    assert_int_equal(ROCK_RED_BLACK_TREE_KEY_DOUBLE, object.key_kind);
+}
+
+struct keyed {
+    uint64_t u;
+    int64_t i;
+    double d;
+    const char *s;
+    struct rock_red_black_tree_node node;
+};
+
+static void check_keyed(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 500;
+    struct keyed *const items = calloc(count, sizeof(*items));
+    assert_non_null(items);
+    char (*const strings)[16] = calloc(count, sizeof(*strings));
+    assert_non_null(strings);
+    for (uintmax_t i = 0; i < count; i++) {
+        const int64_t value = (int64_t) (rand() % (2 * count)) - count;
+        items[i].u = (uint64_t) value;
+        items[i].i = value;
+        items[i].d = (double) value / 4;
+        snprintf(strings[i], sizeof(strings[i]), "%+05" PRId64, value);
+        items[i].s = strings[i];
+    }
+    const ptrdiff_t offsets[] = {
+            offsetof(struct keyed, u) - offsetof(struct keyed, node),
+            offsetof(struct keyed, i) - offsetof(struct keyed, node),
+            offsetof(struct keyed, d) - offsetof(struct keyed, node),
+            offsetof(struct keyed, s) - offsetof(struct keyed, node)
+    };
+    for (int kind = ROCK_RED_BLACK_TREE_KEY_UINT64;
+         kind <= ROCK_RED_BLACK_TREE_KEY_STRING; kind++) {
+        struct rock_red_black_tree object;
+        assert_int_equal(rock_red_black_tree_init_keyed(
+                &object, offsets[kind - 1], kind), 0);
+        uintmax_t inserted = 0;
+        for (uintmax_t i = 0; i < count; i++) {
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_find_or_insert(
+                    &object, &items[i].node, &out), 0);
+            if (out == &items[i].node) {
+                inserted++;
+            }
+            assert_int_equal(items[i].i, rock_container_of(
+                    out, struct keyed, node)->i);
+        }
+        assert_int_equal(inserted, object.count);
+        assert_red_black_tree(&object);
+        /* in order for the kind of the key */
+        struct rock_red_black_tree_node *node;
+        assert_int_equal(rock_red_black_tree_first(&object, &node), 0);
+        const struct keyed *prev = rock_container_of(node, struct keyed,
+                                                     node);
+        while (!rock_red_black_tree_next(node, &node)) {
+            const struct keyed *const item = rock_container_of(
+                    node, struct keyed, node);
+            switch (kind) {
+                case ROCK_RED_BLACK_TREE_KEY_UINT64: {
+                    assert_true(prev->u < item->u);
+                    break;
+                }
+                case ROCK_RED_BLACK_TREE_KEY_INT64: {
+                    assert_true(prev->i < item->i);
+                    break;
+                }
+                case ROCK_RED_BLACK_TREE_KEY_DOUBLE: {
+                    assert_true(prev->d < item->d);
+                    break;
+                }
+                default: {
+                    assert_true(strcmp(prev->s, item->s) < 0);
+                }
+            }
+            prev = item;
+        }
+        for (uintmax_t i = 0; i < count; i++) {
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_find(
+                    &object, NULL, &items[i].node, &out), 0);
+            assert_int_equal(items[i].i, rock_container_of(
+                    out, struct keyed, node)->i);
+        }
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    }
+    free(strings);
+    free(items);
+}
+
+static void check_prefixed_node_init_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_prefixed_node_init(NULL, ""),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_prefixed_node_init_error_on_key_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_prefixed_node_init((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_KEY_IS_NULL);
+}
+
+static void check_prefixed_node_init(void **state) {
+    struct rock_red_black_tree_prefixed_node node;
+    assert_int_equal(rock_red_black_tree_prefixed_node_init(&node, ""), 0);
+    assert_int_equal(0, node.prefix);
+    assert_int_equal(rock_red_black_tree_prefixed_node_init(&node, "ab"), 0);
+    assert_int_equal(0x6162000000000000, node.prefix);
+    assert_int_equal(rock_red_black_tree_prefixed_node_init(
+            &node, "abcdefghij"), 0);
+    assert_int_equal(0x6162636465666768, node.prefix);
+    /* characters are compared as unsigned, as strcmp does */
+    assert_int_equal(rock_red_black_tree_prefixed_node_init(
+            &node, "\xff"), 0);
+    assert_int_equal(0xff00000000000000, node.prefix);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(rock_red_black_tree_node_get_parent(&node.node, &out), 0);
+    assert_null(out);
+}
+
+static void check_init_prefixed_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_prefixed(NULL, 0,
+                                              ROCK_RED_BLACK_TREE_KEY_STRING),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_prefixed_error_on_key_kind_is_invalid(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_prefixed(
+                    (void *) 1, 0, ROCK_RED_BLACK_TREE_KEY_UINT64),
+            ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID);
+    assert_int_equal(
+            rock_red_black_tree_init_prefixed(
+                    (void *) 1, 0, ROCK_RED_BLACK_TREE_KEY_CALLBACK),
+            ROCK_RED_BLACK_TREE_ERROR_KEY_KIND_IS_INVALID);
+}
+
+static void check_init_prefixed(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) UINTPTR_MAX,
+            .count = (-1),
+            .compare = (void *) UINTPTR_MAX,
+    };
+    assert_int_equal(rock_red_black_tree_init_prefixed(
+            &object, 16, ROCK_RED_BLACK_TREE_KEY_CHARS), 0);
+    assert_null(object.root);
+    assert_null(object.compare);
+    assert_int_equal(0, object.count);
+    assert_int_equal(16, object.key_offset);
+    assert_int_equal(ROCK_RED_BLACK_TREE_KEY_CHARS, object.key_kind);
+    assert_true(object.is_prefixed);
+}
+
+struct prefixed {
+    const char *s;
+    char chars[24];
+    struct rock_red_black_tree_prefixed_node node;
+};
+
+static void check_prefixed(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 500;
+    struct prefixed *const items = calloc(count, sizeof(*items));
+    assert_non_null(items);
+    for (uintmax_t i = 0; i < count; i++) {
+        const int value = rand() % (2 * (int) count);
+        /* half of the keys share their first 8 characters */
+        snprintf(items[i].chars, sizeof(items[i].chars),
+                 value % 2 ? "%d" : "prefixed%d", value);
+        items[i].s = items[i].chars;
+        assert_int_equal(rock_red_black_tree_prefixed_node_init(
+                &items[i].node, items[i].chars), 0);
+    }
+    const ptrdiff_t offsets[] = {
+            offsetof(struct prefixed, s) - offsetof(struct prefixed, node),
+            offsetof(struct prefixed, chars) - offsetof(struct prefixed, node)
+    };
+    for (int kind = ROCK_RED_BLACK_TREE_KEY_STRING;
+         kind <= ROCK_RED_BLACK_TREE_KEY_CHARS; kind++) {
+        struct rock_red_black_tree object;
+        assert_int_equal(rock_red_black_tree_init_prefixed(
+                &object, offsets[kind - ROCK_RED_BLACK_TREE_KEY_STRING],
+                kind), 0);
+        uintmax_t inserted = 0;
+        for (uintmax_t i = 0; i < count; i++) {
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_find_or_insert(
+                    &object, &items[i].node.node, &out), 0);
+            if (out == &items[i].node.node) {
+                inserted++;
+            }
+            assert_int_equal(0, strcmp(items[i].chars, rock_container_of(
+                    out, struct prefixed, node.node)->chars));
+        }
+        assert_int_equal(inserted, object.count);
+        assert_red_black_tree(&object);
+        struct rock_red_black_tree_node *node;
+        assert_int_equal(rock_red_black_tree_first(&object, &node), 0);
+        const struct prefixed *prev = rock_container_of(
+                node, struct prefixed, node.node);
+        while (!rock_red_black_tree_next(node, &node)) {
+            const struct prefixed *const item = rock_container_of(
+                    node, struct prefixed, node.node);
+            assert_true(strcmp(prev->chars, item->chars) < 0);
+            prev = item;
+        }
+        for (uintmax_t i = 0; i < count; i++) {
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_find(
+                    &object, NULL, &items[i].node.node, &out), 0);
+            assert_int_equal(0, strcmp(items[i].chars, rock_container_of(
+                    out, struct prefixed, node.node)->chars));
+        }
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+        for (uintmax_t i = 0; i < count; i++) {
+            assert_int_equal(rock_red_black_tree_prefixed_node_init(
+                    &items[i].node, items[i].chars), 0);
+        }
+    }
+    free(items);
+}
+
+static void check_init_cached_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_cached(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_cached_error_on_compare_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_init_cached((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_COMPARE_IS_NULL);
+}
+
+static void check_init_cached(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) UINTPTR_MAX,
+            .count = (-1),
+            .compare = (void *) UINTPTR_MAX,
+            .leftmost = (void *) UINTPTR_MAX,
+            .rightmost = (void *) UINTPTR_MAX,
+    };
+    assert_int_equal(rock_red_black_tree_init_cached(
+            &object,
+            (int (*)(const struct rock_red_black_tree_node *,
+                     const struct rock_red_black_tree_node *))
+                    seagrass_void_ptr_compare), 0);
+    assert_null(object.root);
+    assert_ptr_equal(seagrass_void_ptr_compare, object.compare);
+    assert_int_equal(0, object.count);
+    assert_null(object.augment);
+    assert_null(object.leftmost);
+    assert_null(object.rightmost);
+    assert_true(object.is_cached);
+}
+
+static void assert_extremes(const struct rock_red_black_tree *const object) {
+    assert_true(object->is_cached);
+    if (!object->root) {
+        assert_null(object->leftmost);
+        assert_null(object->rightmost);
+        return;
+    }
+    struct rock_red_black_tree_node *out;
+    rock_red_black_tree_minimum(object->root, &out);
+    assert_ptr_equal(out, object->leftmost);
+    rock_red_black_tree_maximum(object->root, &out);
+    assert_ptr_equal(out, object->rightmost);
+}
+
+static void check_set_cached_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_set_cached(NULL, true),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_set_cached(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 200;
+    struct keyed *const items = calloc(count, sizeof(*items));
+    assert_non_null(items);
+    /* deadlines keyed by a timestamp as a scheduler would queue them */
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_keyed(
+            &object, offsetof(struct keyed, u) - offsetof(struct keyed, node),
+            ROCK_RED_BLACK_TREE_KEY_UINT64), 0);
+    assert_int_equal(rock_red_black_tree_set_cached(&object, true), 0);
+    assert_extremes(&object);
+    struct rock_red_black_tree_node *out;
+    for (uintmax_t i = 0; i < count / 2; i++) {
+        items[i].u = ((uint64_t) rand() << 16) ^ i;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &items[i].node, &out), 0);
+        assert_extremes(&object);
+    }
+    /* turning caching off and on again finds the extremes of the nodes */
+    assert_int_equal(rock_red_black_tree_set_cached(&object, false), 0);
+    assert_false(object.is_cached);
+    assert_null(object.leftmost);
+    assert_null(object.rightmost);
+    for (uintmax_t i = count / 2; i < count; i++) {
+        items[i].u = ((uint64_t) rand() << 16) ^ i;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &items[i].node, &out), 0);
+    }
+    assert_int_equal(rock_red_black_tree_set_cached(&object, true), 0);
+    assert_extremes(&object);
+    uint64_t previous = 0;
+    while (object.count) {
+        assert_int_equal(rock_red_black_tree_first(&object, &out), 0);
+        assert_ptr_equal(object.leftmost, out);
+        assert_int_equal(rock_red_black_tree_pop_first(&object, &out), 0);
+        const uint64_t deadline = rock_container_of(
+                out, struct keyed, node)->u;
+        assert_true(previous <= deadline);
+        previous = deadline;
+        assert_extremes(&object);
+        assert_red_black_tree(&object);
+    }
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(items);
+}
+
 static void check_invalidate_on_object_is_null(void **state) {
     assert_int_equal(
             rock_red_black_tree_invalidate(NULL, (void *) 1),
@@ -1470,6 +1926,22 @@ static int compare_entry(const struct rock_red_black_tree_node *a,
     return seagrass_uintmax_t_compare(A->value, B->value);
 }
 
+static int compare_typed_entry(const struct entry *a, const struct entry *b) {
+    return seagrass_uintmax_t_compare(a->value, b->value);
+}
+
+ROCK_RED_BLACK_TREE_DEFINE(typed_entry, struct entry, node,
+                           compare_typed_entry)
+
+struct named {
+    const char *name;
+    struct rock_red_black_tree_node node;
+};
+
+#define compare_named(a, b)     strcmp((a)->name, (b)->name)
+
+ROCK_RED_BLACK_TREE_DEFINE(named, struct named, node, compare_named)
+
 static void check_find_error_on_node_not_found(void **state) {
     struct entry a, b, c, d, e, f, g;
     assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
@@ -1579,155 +2051,668 @@ static void check_find(void **state) {
     assert_int_equal(rock_red_black_tree_invalidate(&tree, NULL), 0);
 }
 
-static void check_insert_error_on_object_is_null(void **state) {
+static void check_find_batch_error_on_object_is_null(void **state) {
     assert_int_equal(
-            rock_red_black_tree_insert(NULL, (void *) 1, (void *) 1),
+            rock_red_black_tree_find_batch(NULL, (void *) 1, 1, (void *) 1),
             ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
 }
 
-static void check_insert_error_on_insertion_point_is_null(void **state) {
-    struct rock_red_black_tree object = {
-            .root = (void *) 1
-    };
+static void check_find_batch_error_on_needles_is_null(void **state) {
     assert_int_equal(
-            rock_red_black_tree_insert(&object, NULL, (void *) 1),
-            ROCK_RED_BLACK_TREE_ERROR_INSERTION_POINT_IS_NULL);
+            rock_red_black_tree_find_batch((void *) 1, NULL, 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLES_IS_NULL);
 }
 
-static void check_insert_error_on_node_is_null(void **state) {
-    struct rock_red_black_tree object = {
-            .root = (void *) 1
-    };
+static void check_find_batch_error_on_out_is_null(void **state) {
     assert_int_equal(
-            rock_red_black_tree_insert(&object, (void *) 1, NULL),
-            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+            rock_red_black_tree_find_batch((void *) 1, (void *) 1, 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
 }
 
-static void check_insert_error_on_node_already_exists(void **state) {
+static void check_find_batch(void **state) {
     srand(time(NULL));
+    const uintmax_t count = 1000;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
     struct rock_red_black_tree object;
     assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a, b;
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    object.root = &a.node;
-    assert_int_equal(rock_red_black_tree_node_set_color(
-            object.root, ROCK_RED_BLACK_TREE_COLOR_BLACK), 0);
-    a.value = b.value = (rand() % UINTMAX_MAX);
-    assert_ptr_not_equal(&a.node, &b.node);
-    assert_int_equal(
-            rock_red_black_tree_insert(&object, object.root, &b.node),
-            ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS);
+    /* nothing to find in an empty tree, nor without needles */
+    assert_int_equal(rock_red_black_tree_find_batch(&object, NULL, 0, NULL),
+                     0);
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = 2 * i;
+        struct rock_red_black_tree_node *out;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node, &out), 0);
+    }
+    /* odd values are absent, duplicated needles are allowed */
+    const uintmax_t limit = 3 * count;
+    struct entry *const needles = calloc(limit, sizeof(*needles));
+    assert_non_null(needles);
+    const struct rock_red_black_tree_node **const nodes
+            = calloc(limit, sizeof(*nodes));
+    assert_non_null(nodes);
+    struct rock_red_black_tree_node **const out = calloc(limit, sizeof(*out));
+    assert_non_null(out);
+    for (uintmax_t i = 0; i < limit; i++) {
+        needles[i].value = rand() % (2 * count + 1);
+        nodes[i] = &needles[i].node;
+    }
+    assert_int_equal(rock_red_black_tree_find_batch(&object, nodes, limit,
+                                                    out), 0);
+    for (uintmax_t i = 0; i < limit; i++) {
+        const uintmax_t value = needles[i].value;
+        if (value & 1 || value >= 2 * count) {
+            assert_null(out[i]);
+        } else {
+            assert_ptr_equal(&entries[value / 2].node, out[i]);
+        }
+    }
+    /* fewer needles than searches advanced in lock-step */
+    assert_int_equal(rock_red_black_tree_find_batch(&object, nodes, 3, out),
+                     0);
+    for (uintmax_t i = 0; i < 3; i++) {
+        struct rock_red_black_tree_node *node;
+        const int error = rock_red_black_tree_find(&object, NULL, nodes[i],
+                                                   &node);
+        assert_ptr_equal(error ? NULL : node, out[i]);
+    }
     assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(out);
+    free(nodes);
+    free(needles);
+    free(entries);
 }
 
-static void check_insert_case_0(void **state) {
-    srand(time(NULL));
-    struct rock_red_black_tree object = {};
-    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a;
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    a.value = (rand() % UINTMAX_MAX);
-    bool color = ROCK_RED_BLACK_TREE_COLOR_BLACK;
-    assert_int_equal(rock_red_black_tree_node_get_color(&a.node, &color), 0);
-    assert_int_equal(ROCK_RED_BLACK_TREE_COLOR_RED, color);
-    struct rock_red_black_tree_node *out;
-    assert_int_equal(rock_red_black_tree_find(&object, NULL, &a.node, &out),
-                     ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
-    assert_null(out);
-    assert_null(object.root);
-    /* insert 'a' into an empty tree */
-    assert_int_equal(rock_red_black_tree_insert(&object, out, &a.node), 0);
-    assert_red_black_tree(&object);
-    assert_red_black_tree_node(&a.node, NULL, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+static void check_lower_bound_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_lower_bound(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
 }
 
-static void check_insert_case_1(void **state) {
-    struct rock_red_black_tree object = {};
-    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry root, a, b;
-    assert_int_equal(rock_red_black_tree_node_init(&root.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    root.value = 199;
-    a.value = 50;
-    b.value = 263;
-    assert_int_equal(rock_red_black_tree_insert(
-            &object, NULL, &root.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(
-            &object, &root.node, &a.node), 0);
-    /*
-     *      root(199B)
-     *        /
-     *     a(50R)
-     */
-    assert_ptr_equal(object.root, &root.node);
-    assert_red_black_tree_node(&root.node, NULL, false, &a.node, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&a.node, &root.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree(&object);
-    assert_int_equal(rock_red_black_tree_insert(
-            &object, &root.node, &b.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *      root(199B)
-     *        /    \
-     *     a(50R)  b(263R)
-     */
-    assert_ptr_equal(object.root, &root.node);
-    assert_red_black_tree_node(&root.node, NULL, false, &a.node, &b.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&a.node, &root.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&b.node, &root.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
+static void check_lower_bound_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_lower_bound((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_lower_bound_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_lower_bound((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_upper_bound_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_upper_bound(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_upper_bound_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_upper_bound((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_upper_bound_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_upper_bound((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_floor_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_floor(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_floor_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_floor((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_floor_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_floor((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_ceiling_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_ceiling(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_ceiling_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_ceiling((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_ceiling_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_ceiling((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void assert_bound(
+        int (*const bound)(const struct rock_red_black_tree *,
+                           const struct rock_red_black_tree_node *,
+                           struct rock_red_black_tree_node **),
+        const struct rock_red_black_tree *const object,
+        const struct entry *const needle,
+        const struct entry *const expected) {
+    struct rock_red_black_tree_node *out;
+    if (!expected) {
+        assert_int_equal(bound(object, &needle->node, &out),
+                         ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+        return;
+    }
+    assert_int_equal(bound(object, &needle->node, &out), 0);
+    assert_ptr_equal(&expected->node, out);
+}
+
+static void check_bounds(void **state) {
+    const uintmax_t LIMIT = 100;
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry entries[LIMIT];
+    struct rock_red_black_tree_node *out;
+    struct entry needle;
+    needle.value = 0;
+    assert_bound(rock_red_black_tree_lower_bound, &object, &needle, NULL);
+    /* values are 2, 4, ..., 2 * LIMIT */
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        entries[i].value = 2 * (1 + i);
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node, &out), 0);
+    }
+    for (uintmax_t i = 0; i <= 2 * LIMIT + 1; i++) {
+        needle.value = i;
+        const struct entry *const above = i < 2 * LIMIT
+                                          ? &entries[i / 2]
+                                          : NULL;
+        const struct entry *const below = i >= 2
+                                          ? &entries[(i / 2) - 1]
+                                          : NULL;
+        const bool is_present = i >= 2 && i <= 2 * LIMIT && !(i % 2);
+        const struct entry *const exact = is_present ? below : NULL;
+        const struct entry *expected = exact ? exact : above;
+        assert_bound(rock_red_black_tree_lower_bound, &object, &needle,
+                     expected);
+        assert_bound(rock_red_black_tree_ceiling, &object, &needle,
+                     expected);
+        expected = exact
+                   ? (i < 2 * LIMIT ? &entries[i / 2] : NULL)
+                   : above;
+        assert_bound(rock_red_black_tree_upper_bound, &object, &needle,
+                     expected);
+        assert_bound(rock_red_black_tree_floor, &object, &needle, below);
+    }
     assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
 }
 
-static void check_insert_case_2b_configuration_3(void **state) {
-    struct rock_red_black_tree object = {};
+static void check_select_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_select(NULL, 0, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_select_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_select((void *) 1, 0, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_select_error_on_index_is_out_of_bounds(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_order_statistic(
+            &object, compare_entry), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_select(&object, 0, &out),
+            ROCK_RED_BLACK_TREE_ERROR_INDEX_IS_OUT_OF_BOUNDS);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_rank_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_rank(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_rank_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_rank((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_rank_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_rank((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_count_range_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_count_range(NULL, (void *) 1, (void *) 1,
+                                            (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_count_range_error_on_low_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_count_range((void *) 1, NULL, (void *) 1,
+                                            (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_LOW_IS_NULL);
+}
+
+static void check_count_range_error_on_high_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_count_range((void *) 1, (void *) 1, NULL,
+                                            (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_HIGH_IS_NULL);
+}
+
+static void check_count_range_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_count_range((void *) 1, (void *) 1,
+                                            (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+struct sized_entry {
+    uintmax_t value;
+    struct rock_red_black_tree_sized_node node;
+};
+
+static int compare_sized_entry(const struct rock_red_black_tree_node *a,
+                               const struct rock_red_black_tree_node *b) {
+    struct sized_entry *A = rock_container_of(a, struct sized_entry,
+                                              node.node);
+    struct sized_entry *B = rock_container_of(b, struct sized_entry,
+                                              node.node);
+    return seagrass_uintmax_t_compare(A->value, B->value);
+}
+
+static uintmax_t assert_sizes(const struct rock_red_black_tree_node *node) {
+    if (!node) {
+        return 0;
+    }
+    struct rock_red_black_tree_node *left, *right;
+    assert_int_equal(rock_red_black_tree_node_get_left(node, &left), 0);
+    assert_int_equal(rock_red_black_tree_node_get_right(node, &right), 0);
+    const uintmax_t size = 1 + assert_sizes(left) + assert_sizes(right);
+    assert_int_equal(size, rock_container_of(
+            node, struct rock_red_black_tree_sized_node, node)->size);
+    return size;
+}
+
+static void assert_order_statistic(
+        const struct rock_red_black_tree *const object) {
+    assert_red_black_tree(object);
+    assert_int_equal(assert_sizes(object->root), object->count);
+    struct rock_red_black_tree_node *node, *out;
+    uintmax_t rank;
+    for (uintmax_t i = 0; i < object->count; i++) {
+        if (!i) {
+            assert_int_equal(rock_red_black_tree_first(object, &node), 0);
+        } else {
+            assert_int_equal(rock_red_black_tree_next(node, &node), 0);
+        }
+        assert_int_equal(rock_red_black_tree_select(object, i, &out), 0);
+        assert_ptr_equal(node, out);
+        assert_int_equal(rock_red_black_tree_rank(object, node, &rank), 0);
+        assert_int_equal(i, rank);
+    }
+}
+
+static void check_select_and_rank(void **state) {
+    srand(time(NULL));
+    const uintmax_t LIMIT = 500;
+    struct sized_entry entries[LIMIT];
+    bool is_present[LIMIT];
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_order_statistic(
+            &object, compare_sized_entry), 0);
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        entries[i].value = i;
+        is_present[i] = false;
+    }
+    struct rock_red_black_tree_node *out;
+    for (uintmax_t round = 0; round < 4 * LIMIT; round++) {
+        const uintmax_t i = rand() % LIMIT;
+        if (is_present[i]) {
+            assert_int_equal(rock_red_black_tree_remove(
+                    &object, &entries[i].node.node), 0);
+        } else if (round % 2) {
+            assert_int_equal(rock_red_black_tree_find_or_insert(
+                    &object, &entries[i].node.node, &out), 0);
+        } else {
+            /* insert below the node the descent ended on */
+            const int error = rock_red_black_tree_find(
+                    &object, NULL, &entries[i].node.node, &out);
+            assert_int_equal(ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND,
+                             error);
+            assert_int_equal(rock_red_black_tree_insert(
+                    &object, out, &entries[i].node.node), 0);
+        }
+        is_present[i] = !is_present[i];
+        if (!(round % 50)) {
+            assert_order_statistic(&object);
+        }
+    }
+    assert_order_statistic(&object);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_count_range(void **state) {
+    const uintmax_t LIMIT = 100;
+    struct sized_entry entries[LIMIT];
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_order_statistic(
+            &object, compare_sized_entry), 0);
+    struct rock_red_black_tree_node *out;
+    /* values are 2, 4, ..., 2 * LIMIT */
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        entries[i].value = 2 * (1 + i);
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node.node, &out), 0);
+    }
+    struct sized_entry low, high;
+    uintmax_t count;
+    for (low.value = 0; low.value <= 2 * LIMIT + 1; low.value++) {
+        for (high.value = 0; high.value <= 2 * LIMIT + 1; high.value++) {
+            assert_int_equal(rock_red_black_tree_count_range(
+                    &object, &low.node.node, &high.node.node, &count), 0);
+            uintmax_t expected = 0;
+            for (uintmax_t i = 0; i < LIMIT; i++) {
+                expected += entries[i].value >= low.value
+                            && entries[i].value <= high.value;
+            }
+            assert_int_equal(expected, count);
+        }
+    }
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+struct weighted_entry {
+    uintmax_t value;
+    uintmax_t weight;
+    /* sum of the weights in the subtree */
+    uintmax_t sum;
+    struct rock_red_black_tree_node node;
+};
+
+static int compare_weighted_entry(const struct rock_red_black_tree_node *a,
+                                  const struct rock_red_black_tree_node *b) {
+    struct weighted_entry *A = rock_container_of(a, struct weighted_entry,
+                                                 node);
+    struct weighted_entry *B = rock_container_of(b, struct weighted_entry,
+                                                 node);
+    return seagrass_uintmax_t_compare(A->value, B->value);
+}
+
+static uintmax_t weighted_sum(const struct rock_red_black_tree_node *node) {
+    return node
+           ? rock_container_of(node, struct weighted_entry, node)->sum
+           : 0;
+}
+
+static bool weighted_compute(struct rock_red_black_tree_node *node) {
+    struct weighted_entry *entry = rock_container_of(
+            node, struct weighted_entry, node);
+    const uintmax_t sum = entry->weight + weighted_sum(node->left)
+                          + weighted_sum(node->right);
+    if (sum == entry->sum) {
+        return false;
+    }
+    entry->sum = sum;
+    return true;
+}
+
+static void weighted_propagate(struct rock_red_black_tree_node *node,
+                               const struct rock_red_black_tree_node *stop) {
+    while (node != stop && weighted_compute(node)) {
+        assert_int_equal(rock_red_black_tree_node_get_parent(node, &node), 0);
+    }
+}
+
+static void weighted_copy(const struct rock_red_black_tree_node *node,
+                          struct rock_red_black_tree_node *other) {
+    rock_container_of(other, struct weighted_entry, node)->sum
+            = weighted_sum(node);
+}
+
+static void weighted_rotate(struct rock_red_black_tree_node *node,
+                            struct rock_red_black_tree_node *top) {
+    weighted_copy(node, top);
+    weighted_compute(node);
+}
+
+static const struct rock_red_black_tree_augment weighted_augment = {
+        .propagate = weighted_propagate,
+        .copy = weighted_copy,
+        .rotate = weighted_rotate
+};
+
+static uintmax_t assert_weighted(const struct rock_red_black_tree_node *node) {
+    if (!node) {
+        return 0;
+    }
+    const struct weighted_entry *entry = rock_container_of(
+            node, struct weighted_entry, node);
+    const uintmax_t sum = entry->weight + assert_weighted(node->left)
+                          + assert_weighted(node->right);
+    assert_int_equal(sum, entry->sum);
+    return sum;
+}
+
+/* sum of the weights of the nodes less than value in a single descent */
+static uintmax_t weighted_prefix(const struct rock_red_black_tree *object,
+                                 const uintmax_t value) {
+    uintmax_t sum = 0;
+    for (const struct rock_red_black_tree_node *node = object->root; node;) {
+        const struct weighted_entry *entry = rock_container_of(
+                node, struct weighted_entry, node);
+        if (value <= entry->value) {
+            node = node->left;
+        } else {
+            sum += entry->weight + weighted_sum(node->left);
+            node = node->right;
+        }
+    }
+    return sum;
+}
+
+static void check_augmented(void **state) {
+    srand(time(NULL));
+    const uintmax_t LIMIT = 300;
+    struct weighted_entry entries[LIMIT];
+    bool is_present[LIMIT];
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_augmented(
+            &object, compare_weighted_entry, &weighted_augment), 0);
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        entries[i].value = i;
+        /* identical weights make values of neighbours coincide */
+        entries[i].weight = rand() % 4;
+        entries[i].sum = rand() % 4;
+        is_present[i] = false;
+    }
+    struct rock_red_black_tree_node *out;
+    for (uintmax_t round = 0; round < 4 * LIMIT; round++) {
+        const uintmax_t i = rand() % LIMIT;
+        if (is_present[i]) {
+            assert_int_equal(rock_red_black_tree_remove(
+                    &object, &entries[i].node), 0);
+        } else {
+            assert_int_equal(rock_red_black_tree_find_or_insert(
+                    &object, &entries[i].node, &out), 0);
+        }
+        is_present[i] = !is_present[i];
+        assert_red_black_tree(&object);
+        assert_weighted(object.root);
+        const uintmax_t value = rand() % (1 + LIMIT);
+        uintmax_t expected = 0;
+        for (uintmax_t o = 0; o < value; o++) {
+            expected += is_present[o] ? entries[o].weight : 0;
+        }
+        assert_int_equal(expected, weighted_prefix(&object, value));
+    }
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_insert(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_insert_error_on_insertion_point_is_null(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) 1
+    };
+    assert_int_equal(
+            rock_red_black_tree_insert(&object, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_INSERTION_POINT_IS_NULL);
+}
+
+static void check_insert_error_on_node_is_null(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) 1
+    };
+    assert_int_equal(
+            rock_red_black_tree_insert(&object, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_insert_error_on_node_already_exists(void **state) {
+    srand(time(NULL));
+    struct rock_red_black_tree object;
     assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a, b, c;
+    struct entry a, b;
     assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
     assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
-    a.value = 4;
-    b.value = 2;
-    c.value = 1;
-    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &a.node, &b.node), 0);
-    /*
-     *         a(4B)
-     *         /
-     *     b(2R)
-     */
-    assert_ptr_equal(object.root, &a.node);
-    assert_red_black_tree_node(&a.node, NULL, false, &b.node, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&b.node, &a.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree(&object);
-    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &c.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *         b(2B)
-     *         /  \
-     *     c(1R)  a(4R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    object.root = &a.node;
+    assert_int_equal(rock_red_black_tree_node_set_color(
+            object.root, ROCK_RED_BLACK_TREE_COLOR_BLACK), 0);
+    a.value = b.value = (rand() % UINTMAX_MAX);
+    assert_ptr_not_equal(&a.node, &b.node);
+    assert_int_equal(
+            rock_red_black_tree_insert(&object, object.root, &b.node),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS);
     assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
 }
 
-static void check_insert_case_2b_configuration_2(void **state) {
+static void check_insert_case_0(void **state) {
+    srand(time(NULL));
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a;
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    a.value = (rand() % UINTMAX_MAX);
+    bool color = ROCK_RED_BLACK_TREE_COLOR_BLACK;
+    assert_int_equal(rock_red_black_tree_node_get_color(&a.node, &color), 0);
+    assert_int_equal(ROCK_RED_BLACK_TREE_COLOR_RED, color);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(rock_red_black_tree_find(&object, NULL, &a.node, &out),
+                     ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+    assert_null(out);
+    assert_null(object.root);
+    /* insert 'a' into an empty tree */
+    assert_int_equal(rock_red_black_tree_insert(&object, out, &a.node), 0);
+    assert_red_black_tree(&object);
+    assert_red_black_tree_node(&a.node, NULL, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_case_1(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry root, a, b;
+    assert_int_equal(rock_red_black_tree_node_init(&root.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
+    root.value = 199;
+    a.value = 50;
+    b.value = 263;
+    assert_int_equal(rock_red_black_tree_insert(
+            &object, NULL, &root.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(
+            &object, &root.node, &a.node), 0);
+    /*
+     *      root(199B)
+     *        /
+     *     a(50R)
+     */
+    assert_ptr_equal(object.root, &root.node);
+    assert_red_black_tree_node(&root.node, NULL, false, &a.node, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&a.node, &root.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_insert(
+            &object, &root.node, &b.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *      root(199B)
+     *        /    \
+     *     a(50R)  b(263R)
+     */
+    assert_ptr_equal(object.root, &root.node);
+    assert_red_black_tree_node(&root.node, NULL, false, &a.node, &b.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&a.node, &root.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&b.node, &root.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_case_2b_configuration_3(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a, b, c;
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
+    a.value = 4;
+    b.value = 2;
+    c.value = 1;
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &a.node, &b.node), 0);
+    /*
+     *         a(4B)
+     *         /
+     *     b(2R)
+     */
+    assert_ptr_equal(object.root, &a.node);
+    assert_red_black_tree_node(&a.node, NULL, false, &b.node, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&b.node, &a.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &c.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *         b(2B)
+     *         /  \
+     *     c(1R)  a(4R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_case_2b_configuration_2(void **state) {
     struct rock_red_black_tree object = {};
     assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
     struct entry a, b, c;
@@ -1767,204 +2752,1141 @@ static void check_insert_case_2b_configuration_2(void **state) {
     assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
 }
 
-static void check_insert_case_2b_configuration_1(void **state) {
-    struct rock_red_black_tree object = {};
-    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a, b, c;
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
-    a.value = 4;
-    b.value = 2;
-    c.value = 1;
-    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &c.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &a.node), 0);
-    /*
-     *         c(1B)
-     *             \
-     *             a(4R)
-     */
-    assert_ptr_equal(object.root, &c.node);
-    assert_red_black_tree_node(&c.node, NULL, false, NULL, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&a.node, &c.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree(&object);
-    assert_int_equal(rock_red_black_tree_insert(&object, &a.node, &b.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *         b(2B)
-     *         /  \
-     *     c(1R)  a(4R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+static void check_insert_case_2b_configuration_1(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a, b, c;
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
+    a.value = 4;
+    b.value = 2;
+    c.value = 1;
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &c.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &a.node), 0);
+    /*
+     *         c(1B)
+     *             \
+     *             a(4R)
+     */
+    assert_ptr_equal(object.root, &c.node);
+    assert_red_black_tree_node(&c.node, NULL, false, NULL, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&a.node, &c.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_insert(&object, &a.node, &b.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *         b(2B)
+     *         /  \
+     *     c(1R)  a(4R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_case_2b_configuration_0(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a, b, c;
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
+    a.value = 4;
+    b.value = 2;
+    c.value = 1;
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &c.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &b.node), 0);
+    /*
+     *         c(1B)
+     *             \
+     *             b(2R)
+     */
+    assert_ptr_equal(object.root, &c.node);
+    assert_red_black_tree_node(&c.node, NULL, false, NULL, &b.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&b.node, &c.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &a.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *         b(2B)
+     *         /  \
+     *     c(1R)  a(4R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_case_2a(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a, b, c, d;
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&d.node), 0);
+    a.value = 5;
+    b.value = 4;
+    c.value = 2;
+    d.value = 1;
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &b.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &a.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &c.node), 0);
+    /*
+     *         b(4B)
+     *         /  \
+     *     c(2R)  a(5R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &d.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *         b(4B)
+     *         /  \
+     *     c(2B)  a(5B)
+     *     /
+     *   d(1R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, &d.node, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&d.node, &c.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a, b, c, d, e;
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&d.node), 0);
+    assert_int_equal(rock_red_black_tree_node_init(&e.node), 0);
+    a.value = 9;
+    b.value = 5;
+    c.value = 2;
+    d.value = 4;
+    e.value = 1;
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &a.node, &b.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &c.node), 0);
+    /*
+     *         b(5B)
+     *         /  \
+     *     c(2R)  a(9R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &d.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *         b(5B)
+     *         /  \
+     *     d(4B)  a(9B)
+     *       /
+     *   c(2R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &d.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&d.node, &b.node, true, &c.node, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &d.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &e.node), 0);
+    assert_red_black_tree(&object);
+    /*
+     *         b(5B)
+     *         /  \
+     *     c(2B)  a(9B)
+     *       / \
+     *   e(1R) d(4R)
+     */
+    assert_ptr_equal(object.root, &b.node);
+    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&c.node, &b.node, true, &e.node, &d.node,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
+    assert_red_black_tree_node(&e.node, &c.node, true, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_red_black_tree_node(&d.node, &c.node, false, NULL, NULL,
+                               ROCK_RED_BLACK_TREE_COLOR_RED);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_find_or_insert_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_find_or_insert(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_find_or_insert_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_find_or_insert((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_find_or_insert_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_find_or_insert((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_find_or_insert(void **state) {
+    const uintmax_t LIMIT = 1000;
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry *entries = calloc(LIMIT, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree_node *out;
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        entries[i].value = (i * 7919) % LIMIT;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node, &out), 0);
+        assert_ptr_equal(&entries[i].node, out);
+        assert_int_equal(1 + i, object.count);
+    }
+    assert_red_black_tree(&object);
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        struct entry duplicate = {
+                .value = entries[i].value
+        };
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &duplicate.node, &out), 0);
+        assert_ptr_equal(&entries[i].node, out);
+    }
+    assert_int_equal(LIMIT, object.count);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(entries);
+}
+
+static void check_find_near_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_find_near(NULL, NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_find_near_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_find_near((void *) 1, NULL, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_find_near_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_find_near((void *) 1, NULL, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_find_near(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 500;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry needle = {};
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_find_near(&object, NULL, &needle.node, &out),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+    assert_null(out);
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = 2 * i + 1;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node, &out), 0);
+    }
+    /* the same node or insertion point as when searching from the root */
+    for (uintmax_t i = 0; i < 4 * count; i++) {
+        struct entry *const hint = &entries[rand() % count];
+        needle.value = rand() % (2 * count + 1);
+        struct rock_red_black_tree_node *expected;
+        const int error = rock_red_black_tree_find(&object, NULL,
+                                                   &needle.node, &expected);
+        assert_int_equal(error, rock_red_black_tree_find_near(
+                &object, &hint->node, &needle.node, &out));
+        assert_ptr_equal(expected, out);
+    }
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(entries);
+}
+
+static void check_insert_near_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_insert_near(NULL, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_insert_near_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_insert_near((void *) 1, NULL, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_insert_near_error_on_node_already_exists(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a = {.value = 1}, b = {.value = 2}, c = {.value = 2};
+    assert_int_equal(rock_red_black_tree_insert_near(&object, NULL, &a.node),
+                     0);
+    assert_int_equal(rock_red_black_tree_insert_near(&object, &a.node,
+                                                     &b.node), 0);
+    assert_int_equal(
+            rock_red_black_tree_insert_near(&object, &a.node, &c.node),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_insert_near(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 1000;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_cached(&object, compare_entry),
+                     0);
+    /* mostly increasing keys with the previous node as hint */
+    struct rock_red_black_tree_node *hint = NULL;
+    uintmax_t inserted = 0;
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = 4 * i + rand() % 16;
+        const int error = rock_red_black_tree_insert_near(
+                &object, hint, &entries[i].node);
+        if (error) {
+            assert_int_equal(ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS,
+                             error);
+            continue;
+        }
+        hint = &entries[i].node;
+        inserted++;
+    }
+    assert_int_equal(inserted, object.count);
+    assert_red_black_tree(&object);
+    assert_extremes(&object);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(entries);
+}
+
+static uintmax_t compare_count;
+
+static int compare_entry_counted(const struct rock_red_black_tree_node *a,
+                                 const struct rock_red_black_tree_node *b) {
+    compare_count++;
+    return compare_entry(a, b);
+}
+
+static void check_append_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_append(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_append_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_append((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_append(void **state) {
+    const uintmax_t count = 1000;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_cached(
+            &object, compare_entry_counted), 0);
+    compare_count = 0;
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = 2 * i + 1;
+        assert_int_equal(rock_red_black_tree_append(&object,
+                                                    &entries[i].node), 0);
+    }
+    /* a single comparison against the last node for each but the first */
+    assert_int_equal(count - 1, compare_count);
+    assert_red_black_tree(&object);
+    assert_extremes(&object);
+    /* out of order nodes are still inserted at their place */
+    struct entry a = {.value = 0}, b = {.value = count};
+    assert_int_equal(rock_red_black_tree_append(&object, &a.node), 0);
+    assert_int_equal(rock_red_black_tree_append(&object, &b.node), 0);
+    assert_int_equal(
+            rock_red_black_tree_append(&object, &entries[count / 2].node),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS);
+    assert_int_equal(count + 2, object.count);
+    assert_red_black_tree(&object);
+    assert_extremes(&object);
+    /* a node beyond the cached last node is linked without climbing */
+    struct entry c = {.value = 4 * count};
+    compare_count = 0;
+    assert_int_equal(rock_red_black_tree_insert_near(
+            &object, &entries[count - 1].node, &c.node), 0);
+    assert_int_equal(1, compare_count);
+    assert_red_black_tree(&object);
+    assert_extremes(&object);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    /* without cached extremes appending links below the last node too */
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry_counted),
+                     0);
+    compare_count = 0;
+    for (uintmax_t i = 0; i < count; i++) {
+        assert_int_equal(rock_red_black_tree_append(&object,
+                                                    &entries[i].node), 0);
+    }
+    assert_int_equal(count - 1, compare_count);
+    assert_int_equal(count, object.count);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(entries);
+}
+
+static void check_link_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_link(NULL, NULL, (void *) 1, false),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_link_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_link((void *) 1, NULL, NULL, false),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_define_error_on_object_is_null(void **state) {
+    struct entry *out;
+    assert_int_equal(
+            typed_entry_find(NULL, (void *) 1, &out),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+    assert_int_equal(
+            typed_entry_lower_bound(NULL, (void *) 1, &out),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+    assert_int_equal(
+            typed_entry_insert(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_define_error_on_needle_is_null(void **state) {
+    struct entry *out;
+    assert_int_equal(
+            typed_entry_find((void *) 1, NULL, &out),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+    assert_int_equal(
+            typed_entry_lower_bound((void *) 1, NULL, &out),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_define_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            typed_entry_find((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+    assert_int_equal(
+            typed_entry_lower_bound((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_define_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            typed_entry_insert((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_define(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 1000;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree object;
+    assert_int_equal(typed_entry_init(&object), 0);
+    struct entry needle = {};
+    struct entry *out = NULL;
+    assert_int_equal(typed_entry_find(&object, &needle, &out),
+                     ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+    assert_int_equal(typed_entry_lower_bound(&object, &needle, &out),
+                     ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = 2 * i + 1;
+    }
+    for (uintmax_t i = count - 1; i > 0; i--) {
+        const uintmax_t j = rand() % (i + 1);
+        const uintmax_t value = entries[i].value;
+        entries[i].value = entries[j].value;
+        entries[j].value = value;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        assert_int_equal(typed_entry_insert(&object, &entries[i]), 0);
+    }
+    assert_int_equal(typed_entry_insert(&object, &entries[count / 2]),
+                     ROCK_RED_BLACK_TREE_ERROR_NODE_ALREADY_EXISTS);
+    assert_int_equal(count, object.count);
+    assert_red_black_tree(&object);
+    for (uintmax_t i = 0; i <= 2 * count; i++) {
+        needle.value = i;
+        const int error = typed_entry_find(&object, &needle, &out);
+        if (i & 1) {
+            assert_int_equal(0, error);
+            assert_int_equal(i, out->value);
+        } else {
+            assert_int_equal(ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND,
+                             error);
+        }
+        if (i < 2 * count) {
+            assert_int_equal(typed_entry_lower_bound(&object, &needle, &out),
+                             0);
+            assert_int_equal(i | 1, out->value);
+        } else {
+            assert_int_equal(typed_entry_lower_bound(&object, &needle, &out),
+                             ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+        }
+    }
+    /* the generic functions operate on the same red black tree */
+    for (uintmax_t i = 0; i < count; i += 2) {
+        assert_int_equal(rock_red_black_tree_remove(&object,
+                                                    &entries[i].node), 0);
+    }
+    assert_red_black_tree(&object);
+    struct rock_red_black_tree_node *node;
+    needle.value = entries[1].value;
+    assert_int_equal(rock_red_black_tree_find(&object, NULL, &needle.node,
+                                              &node), 0);
+    assert_ptr_equal(&entries[1].node, node);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(entries);
+}
+
+static void check_define_string(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(named_init(&object), 0);
+    struct named names[] = {
+            {.name = "pear"},
+            {.name = "apple"},
+            {.name = "fig"},
+            {.name = "banana"},
+            {.name = "cherry"}
+    };
+    const uintmax_t count = sizeof(names) / sizeof(names[0]);
+    for (uintmax_t i = 0; i < count; i++) {
+        assert_int_equal(named_insert(&object, &names[i]), 0);
+    }
+    assert_red_black_tree(&object);
+    struct named needle = {.name = "fig"};
+    struct named *out = NULL;
+    assert_int_equal(named_find(&object, &needle, &out), 0);
+    assert_ptr_equal(&names[2], out);
+    needle.name = "blueberry";
+    assert_int_equal(named_find(&object, &needle, &out),
+                     ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+    assert_int_equal(named_lower_bound(&object, &needle, &out), 0);
+    assert_ptr_equal(&names[4], out);
+    struct rock_red_black_tree_node *first;
+    assert_int_equal(rock_red_black_tree_first(&object, &first), 0);
+    assert_ptr_equal(&names[1].node, first);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_build_sorted_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_build_sorted(NULL, (void *) 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_build_sorted_error_on_nodes_is_null(void **state) {
+    struct rock_red_black_tree object = {};
+    assert_int_equal(
+            rock_red_black_tree_build_sorted(&object, NULL, 1),
+            ROCK_RED_BLACK_TREE_ERROR_NODES_IS_NULL);
+}
+
+static void check_build_sorted_error_on_tree_is_not_empty(void **state) {
+    struct rock_red_black_tree object = {
+            .root = (void *) 1
+    };
+    assert_int_equal(
+            rock_red_black_tree_build_sorted(&object, (void *) 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY);
+}
+
+static void check_build_sorted(void **state) {
+    const uintmax_t LIMIT = 1100;
+    struct entry *entries = calloc(LIMIT, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree_node **nodes = calloc(LIMIT, sizeof(*nodes));
+    assert_non_null(nodes);
+    for (uintmax_t i = 0; i < LIMIT; i++) {
+        entries[i].value = i;
+        nodes[i] = &entries[i].node;
+    }
+    for (uintmax_t count = 0; count <= LIMIT; count += 1 + count / 16) {
+        struct rock_red_black_tree object;
+        assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+        assert_int_equal(rock_red_black_tree_build_sorted(&object, nodes,
+                                                          count), 0);
+        assert_int_equal(count, object.count);
+        assert_red_black_tree(&object);
+        struct rock_red_black_tree_node *node;
+        if (!count) {
+            assert_null(object.root);
+            continue;
+        }
+        assert_int_equal(rock_red_black_tree_first(&object, &node), 0);
+        for (uintmax_t i = 0; i < count; i++) {
+            assert_ptr_equal(&entries[i].node, node);
+            assert_int_equal(rock_red_black_tree_next(node, &node),
+                             1 + i < count
+                             ? 0
+                             : ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+        }
+        /* the built tree remains usable */
+        assert_int_equal(rock_red_black_tree_remove(&object, object.root), 0);
+        assert_red_black_tree(&object);
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    }
+    free(nodes);
+    free(entries);
+}
+
+static void check_join_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_join(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_join_error_on_node_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_join((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_IS_NULL);
+}
+
+static void check_join_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_join((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_split_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_split(NULL, (void *) 1, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_split_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_split((void *) 1, NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_split_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_split((void *) 1, (void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_split_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_split((void *) 1, (void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_split_error_on_tree_is_not_empty(void **state) {
+    struct rock_red_black_tree other = {
+            .root = (void *) 1
+    };
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_split((void *) 1, (void *) 1, &other, &out),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NOT_EMPTY);
+}
+
+static void check_union_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_union(NULL, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_union_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_union((void *) 1, NULL, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_intersection_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_intersection(NULL, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_intersection_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_intersection((void *) 1, NULL, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_difference_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_difference(NULL, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_difference_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_difference((void *) 1, NULL, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_parallel_union_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_union(
+                    NULL, (void *) 1, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_parallel_union_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_union(
+                    (void *) 1, NULL, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_parallel_union_error_on_pool_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_union(
+                    (void *) 1, (void *) 1, NULL, NULL, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL);
+}
+
+static void check_parallel_union_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_union(
+                    (void *) 1, (void *) 1, NULL, (void *) 1, 0, 1),
+            ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_parallel_union_error_on_threads_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_union(
+                    (void *) 1, (void *) 1, NULL, (void *) 1, 1, 0),
+            ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO);
+}
+
+static void check_parallel_intersection_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_intersection(
+                    NULL, (void *) 1, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_parallel_intersection_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_intersection(
+                    (void *) 1, NULL, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_parallel_intersection_error_on_pool_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_intersection(
+                    (void *) 1, (void *) 1, NULL, NULL, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL);
+}
+
+static void check_parallel_intersection_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_intersection(
+                    (void *) 1, (void *) 1, NULL, (void *) 1, 0, 1),
+            ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_parallel_intersection_error_on_threads_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_intersection(
+                    (void *) 1, (void *) 1, NULL, (void *) 1, 1, 0),
+            ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO);
+}
+
+static void check_parallel_difference_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_difference(
+                    NULL, (void *) 1, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_parallel_difference_error_on_other_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_difference(
+                    (void *) 1, NULL, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OTHER_IS_NULL);
+}
+
+static void check_parallel_difference_error_on_pool_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_difference(
+                    (void *) 1, (void *) 1, NULL, NULL, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL);
+}
+
+static void check_parallel_difference_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_difference(
+                    (void *) 1, (void *) 1, NULL, (void *) 1, 0, 1),
+            ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_parallel_difference_error_on_threads_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_parallel_difference(
+                    (void *) 1, (void *) 1, NULL, (void *) 1, 1, 0),
+            ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO);
+}
+
+static void insert_values(struct rock_red_black_tree *const object,
+                          struct entry *const entries,
+                          const uintmax_t from,
+                          const uintmax_t to,
+                          const uintmax_t step) {
+    struct rock_red_black_tree_node *out;
+    for (uintmax_t i = from; i < to; i += step) {
+        entries[i].value = i;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                object, &entries[i].node, &out), 0);
+        assert_ptr_equal(&entries[i].node, out);
+    }
+}
+
+static void assert_values(const struct rock_red_black_tree *const object,
+                          const bool *const expected,
+                          const uintmax_t limit) {
+    assert_red_black_tree(object);
+    struct rock_red_black_tree_node *node = NULL;
+    if (object->root) {
+        assert_int_equal(rock_red_black_tree_first(object, &node), 0);
+    }
+    uintmax_t count = 0;
+    for (uintmax_t i = 0; i < limit; i++) {
+        if (!expected[i]) {
+            continue;
+        }
+        assert_non_null(node);
+        assert_int_equal(i, rock_container_of(node, struct entry,
+                                              node)->value);
+        if (rock_red_black_tree_next(node, &node)) {
+            node = NULL;
+        }
+        count++;
+    }
+    assert_null(node);
+    assert_int_equal(count, object->count);
+}
+
+static void check_join(void **state) {
+    const uintmax_t LIMIT = 300;
+    struct entry entries[LIMIT];
+    bool expected[LIMIT];
+    for (uintmax_t left = 0; left < LIMIT - 1; left += 1 + left / 2) {
+        for (uintmax_t right = left + 1; right < LIMIT;
+             right += 1 + right / 3) {
+            struct rock_red_black_tree object, other;
+            assert_int_equal(rock_red_black_tree_init(&object, compare_entry),
+                             0);
+            assert_int_equal(rock_red_black_tree_init(&other, compare_entry),
+                             0);
+            insert_values(&object, entries, 0, left, 1);
+            insert_values(&other, entries, right + 1, LIMIT, 1);
+            entries[right].value = right;
+            assert_int_equal(rock_red_black_tree_join(
+                    &object, &entries[right].node, &other), 0);
+            assert_null(other.root);
+            assert_int_equal(0, other.count);
+            for (uintmax_t i = 0; i < LIMIT; i++) {
+                expected[i] = i < left || i >= right;
+            }
+            assert_values(&object, expected, LIMIT);
+            assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+        }
+    }
+}
+
+static void check_split(void **state) {
+    const uintmax_t LIMIT = 200;
+    struct entry entries[LIMIT];
+    bool expected[LIMIT];
+    for (uintmax_t i = 0; i <= LIMIT; i++) {
+        struct rock_red_black_tree object, other;
+        assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+        assert_int_equal(rock_red_black_tree_init(&other, compare_entry), 0);
+        /* only the even values are present */
+        insert_values(&object, entries, 0, LIMIT, 2);
+        struct entry needle = {
+                .value = i
+        };
+        struct rock_red_black_tree_node *out;
+        assert_int_equal(rock_red_black_tree_split(
+                &object, &needle.node, &other, &out), 0);
+        if (i < LIMIT && !(i % 2)) {
+            assert_ptr_equal(&entries[i].node, out);
+        } else {
+            assert_null(out);
+        }
+        for (uintmax_t o = 0; o < LIMIT; o++) {
+            expected[o] = !(o % 2) && o < i;
+        }
+        assert_values(&object, expected, LIMIT);
+        for (uintmax_t o = 0; o < LIMIT; o++) {
+            expected[o] = !(o % 2) && o > i;
+        }
+        assert_values(&other, expected, LIMIT);
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+        assert_int_equal(rock_red_black_tree_invalidate(&other, NULL), 0);
+    }
 }
 
-static void check_insert_case_2b_configuration_0(void **state) {
-    struct rock_red_black_tree object = {};
-    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a, b, c;
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
-    a.value = 4;
-    b.value = 2;
-    c.value = 1;
-    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &c.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &b.node), 0);
-    /*
-     *         c(1B)
-     *             \
-     *             b(2R)
-     */
-    assert_ptr_equal(object.root, &c.node);
-    assert_red_black_tree_node(&c.node, NULL, false, NULL, &b.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&b.node, &c.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree(&object);
-    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &a.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *         b(2B)
-     *         /  \
-     *     c(1R)  a(4R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+static void assert_removed(const struct rock_red_black_tree_node *node) {
+    /* every removed node is handed out as freshly initialised */
+    struct rock_red_black_tree_node expected;
+    assert_int_equal(rock_red_black_tree_node_init(&expected), 0);
+    assert_memory_equal(&expected, node, sizeof(expected));
 }
 
-static void check_insert_case_2a(void **state) {
-    struct rock_red_black_tree object = {};
-    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a, b, c, d;
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&d.node), 0);
-    a.value = 5;
-    b.value = 4;
-    c.value = 2;
-    d.value = 1;
-    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &b.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &a.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &c.node), 0);
-    /*
-     *         b(4B)
-     *         /  \
-     *     c(2R)  a(5R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree(&object);
-    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &d.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *         b(4B)
-     *         /  \
-     *     c(2B)  a(5B)
-     *     /
-     *   d(1R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, &d.node, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&d.node, &c.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+static void on_remove(struct rock_red_black_tree_node *node) {
+    assert_removed(node);
+    function_called();
 }
 
-static void check_insert(void **state) {
-    struct rock_red_black_tree object = {};
-    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
-    struct entry a, b, c, d, e;
-    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&b.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&c.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&d.node), 0);
-    assert_int_equal(rock_red_black_tree_node_init(&e.node), 0);
-    a.value = 9;
-    b.value = 5;
-    c.value = 2;
-    d.value = 4;
-    e.value = 1;
-    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &a.node, &b.node), 0);
-    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &c.node), 0);
-    /*
-     *         b(5B)
-     *         /  \
-     *     c(2R)  a(9R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree(&object);
-    assert_int_equal(rock_red_black_tree_insert(&object, &b.node, &d.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *         b(5B)
-     *         /  \
-     *     d(4B)  a(9B)
-     *       /
-     *   c(2R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &d.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&d.node, &b.node, true, &c.node, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &d.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_int_equal(rock_red_black_tree_insert(&object, &c.node, &e.node), 0);
-    assert_red_black_tree(&object);
-    /*
-     *         b(5B)
-     *         /  \
-     *     c(2B)  a(9B)
-     *       / \
-     *   e(1R) d(4R)
-     */
-    assert_ptr_equal(object.root, &b.node);
-    assert_red_black_tree_node(&b.node, NULL, false, &c.node, &a.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&c.node, &b.node, true, &e.node, &d.node,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&a.node, &b.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_BLACK);
-    assert_red_black_tree_node(&e.node, &c.node, true, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_red_black_tree_node(&d.node, &c.node, false, NULL, NULL,
-                               ROCK_RED_BLACK_TREE_COLOR_RED);
-    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+static atomic_uintmax_t removed_count;
+
+static void on_remove_parallel(struct rock_red_black_tree_node *node) {
+    assert_removed(node);
+    atomic_fetch_add(&removed_count, 1);
+}
+
+static void check_set_operation(
+        int (*const operation)(struct rock_red_black_tree *,
+                               struct rock_red_black_tree *,
+                               void (*)(struct rock_red_black_tree_node *)),
+        int (*const parallel)(struct rock_red_black_tree *,
+                              struct rock_red_black_tree *,
+                              void (*)(struct rock_red_black_tree_node *),
+                              struct rock_thread_pool *,
+                              uintmax_t,
+                              uintmax_t),
+        bool (*const keep)(bool in_object, bool in_other)) {
+    struct rock_thread_pool pool;
+    if (parallel) {
+        assert_int_equal(rock_thread_pool_init(&pool, 4), 0);
+    }
+    const uintmax_t LIMIT = 2000;
+    struct entry *a = calloc(LIMIT, sizeof(*a));
+    assert_non_null(a);
+    struct entry *b = calloc(LIMIT, sizeof(*b));
+    assert_non_null(b);
+    bool expected[LIMIT];
+    for (uintmax_t round = 0; round < 20; round++) {
+        struct rock_red_black_tree object, other;
+        assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+        assert_int_equal(rock_red_black_tree_init(&other, compare_entry), 0);
+        /* vary the density of both sides, other is at times far smaller */
+        const uintmax_t x = 1 + rand() % 4;
+        const uintmax_t y = 1 + rand() % (round % 2 ? 4 : 64);
+        uintmax_t removed = 0;
+        for (uintmax_t i = 0; i < LIMIT; i++) {
+            const bool in_object = !(rand() % x);
+            const bool in_other = !(rand() % y);
+            struct rock_red_black_tree_node *out;
+            if (in_object) {
+                a[i].value = i;
+                assert_int_equal(rock_red_black_tree_find_or_insert(
+                        &object, &a[i].node, &out), 0);
+            }
+            if (in_other) {
+                b[i].value = i;
+                assert_int_equal(rock_red_black_tree_find_or_insert(
+                        &other, &b[i].node, &out), 0);
+            }
+            expected[i] = keep(in_object, in_other);
+            removed += in_object + in_other - expected[i];
+        }
+        if (parallel) {
+            atomic_store(&removed_count, 0);
+            /* small grain and budget so that forking occurs at every size */
+            assert_int_equal(parallel(&object, &other, on_remove_parallel,
+                                      &pool, 1 + round, 1 + round % 8), 0);
+            assert_int_equal(removed, atomic_load(&removed_count));
+        } else {
+            if (removed) {
+                expect_function_calls(on_remove, (int) removed);
+            }
+            assert_int_equal(operation(&object, &other, on_remove), 0);
+        }
+        assert_null(other.root);
+        assert_int_equal(0, other.count);
+        assert_values(&object, expected, LIMIT);
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    }
+    if (parallel) {
+        assert_int_equal(rock_thread_pool_invalidate(&pool), 0);
+    }
+    free(a);
+    free(b);
+}
+
+static bool keep_union(const bool in_object, const bool in_other) {
+    return in_object || in_other;
+}
+
+static bool keep_intersection(const bool in_object, const bool in_other) {
+    return in_object && in_other;
+}
+
+static bool keep_difference(const bool in_object, const bool in_other) {
+    return in_object && !in_other;
+}
+
+static void check_union(void **state) {
+    srand(time(NULL));
+    check_set_operation(rock_red_black_tree_union, NULL, keep_union);
+}
+
+static void check_intersection(void **state) {
+    srand(time(NULL));
+    check_set_operation(rock_red_black_tree_intersection, NULL,
+                        keep_intersection);
+}
+
+static void check_difference(void **state) {
+    srand(time(NULL));
+    check_set_operation(rock_red_black_tree_difference, NULL, keep_difference);
+}
+
+static void check_parallel_union(void **state) {
+    srand(time(NULL));
+    check_set_operation(NULL, rock_red_black_tree_parallel_union,
+                        keep_union);
+}
+
+static void check_parallel_intersection(void **state) {
+    srand(time(NULL));
+    check_set_operation(NULL, rock_red_black_tree_parallel_intersection,
+                        keep_intersection);
+}
+
+static void check_parallel_difference(void **state) {
+    srand(time(NULL));
+    check_set_operation(NULL, rock_red_black_tree_parallel_difference,
+                        keep_difference);
+}
+
+static void check_order_statistic_join_split_and_set_operations(
+        void **state) {
+    srand(time(NULL));
+    const uintmax_t LIMIT = 1000;
+    struct sized_entry *a = calloc(LIMIT, sizeof(*a));
+    assert_non_null(a);
+    struct sized_entry *b = calloc(LIMIT, sizeof(*b));
+    assert_non_null(b);
+    struct rock_red_black_tree_node **nodes = calloc(LIMIT, sizeof(*nodes));
+    assert_non_null(nodes);
+    struct rock_thread_pool pool;
+    assert_int_equal(rock_thread_pool_init(&pool, 4), 0);
+    for (uintmax_t round = 0; round < 10; round++) {
+        struct rock_red_black_tree object, other;
+        assert_int_equal(rock_red_black_tree_init_order_statistic(
+                &object, compare_sized_entry), 0);
+        assert_int_equal(rock_red_black_tree_init_order_statistic(
+                &other, compare_sized_entry), 0);
+        uintmax_t count = 0;
+        for (uintmax_t i = 0; i < LIMIT; i++) {
+            a[i].value = b[i].value = i;
+            if (rand() % 2) {
+                nodes[count++] = &a[i].node.node;
+            }
+        }
+        assert_int_equal(rock_red_black_tree_build_sorted(
+                &object, nodes, count), 0);
+        assert_order_statistic(&object);
+        struct rock_red_black_tree_node *out;
+        for (uintmax_t i = 0; i < LIMIT; i++) {
+            if (!(rand() % 3)) {
+                assert_int_equal(rock_red_black_tree_find_or_insert(
+                        &other, &b[i].node.node, &out), 0);
+            }
+        }
+        switch (round % 4) {
+            case 0: {
+                assert_int_equal(rock_red_black_tree_union(
+                        &object, &other, NULL), 0);
+                break;
+            }
+            case 1: {
+                assert_int_equal(rock_red_black_tree_intersection(
+                        &object, &other, NULL), 0);
+                break;
+            }
+            case 2: {
+                assert_int_equal(rock_red_black_tree_difference(
+                        &object, &other, NULL), 0);
+                break;
+            }
+            default: {
+                assert_int_equal(rock_red_black_tree_parallel_union(
+                        &object, &other, NULL, &pool, 16, 4), 0);
+            }
+        }
+        assert_order_statistic(&object);
+        struct sized_entry needle = {
+                .value = rand() % LIMIT
+        };
+        assert_int_equal(rock_red_black_tree_split(
+                &object, &needle.node.node, &other, &out), 0);
+        assert_ptr_equal(&rock_red_black_tree_size_augment, other.augment);
+        assert_order_statistic(&object);
+        assert_order_statistic(&other);
+        if (!out) {
+            needle.node.node = (struct rock_red_black_tree_node) {0};
+            out = &needle.node.node;
+        }
+        assert_int_equal(rock_red_black_tree_join(&object, out, &other), 0);
+        assert_order_statistic(&object);
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    }
+    assert_int_equal(rock_thread_pool_invalidate(&pool), 0);
+    free(nodes);
+    free(a);
+    free(b);
 }
 
 static void check_first_error_on_object_is_null(void **state) {
@@ -2096,6 +4018,150 @@ static void check_last(void **state) {
     assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
 }
 
+static void check_pop_first_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_pop_first(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_pop_first_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_pop_first((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_pop_first_error_on_tree_is_empty(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_cached(&object, compare_entry),
+                     0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_pop_first(&object, &out),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_pop_last_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_pop_last(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_pop_last_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_pop_last((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_pop_last_error_on_tree_is_empty(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_pop_last(&object, &out),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_pop(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 256;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    for (uintmax_t i = 0; i < 2; i++) {
+        struct rock_red_black_tree object;
+        assert_int_equal(i
+                         ? rock_red_black_tree_init_cached(&object,
+                                                           compare_entry)
+                         : rock_red_black_tree_init(&object, compare_entry),
+                         0);
+        for (uintmax_t j = 0; j < count; j++) {
+            entries[j].value = rand() % (count / 2);
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_find_or_insert(
+                    &object, &entries[j].node, &out), 0);
+            if (i) {
+                assert_extremes(&object);
+            }
+        }
+        uintmax_t previous = 0;
+        uintmax_t last = UINTMAX_MAX;
+        while (object.root) {
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_pop_first(&object, &out), 0);
+            const uintmax_t value = rock_container_of(
+                    out, struct entry, node)->value;
+            assert_true(previous <= value);
+            previous = value;
+            if (!object.root) {
+                break;
+            }
+            assert_int_equal(rock_red_black_tree_pop_last(&object, &out), 0);
+            const uintmax_t other = rock_container_of(
+                    out, struct entry, node)->value;
+            assert_true(other <= last);
+            assert_true(value < other);
+            last = other;
+            if (i) {
+                assert_extremes(&object);
+            }
+        }
+        assert_int_equal(0, object.count);
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    }
+    free(entries);
+}
+
+static void check_cached(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 512;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree_node **const nodes
+            = calloc(count, sizeof(*nodes));
+    assert_non_null(nodes);
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = i;
+        nodes[i] = &entries[i].node;
+    }
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init_cached(&object, compare_entry),
+                     0);
+    assert_int_equal(rock_red_black_tree_build_sorted(&object, nodes, count),
+                     0);
+    assert_extremes(&object);
+    /* remove and insert again at random through an insertion point */
+    for (uintmax_t i = 0; i < count; i++) {
+        struct entry *const entry = &entries[rand() % count];
+        assert_int_equal(rock_red_black_tree_remove(&object, &entry->node),
+                         0);
+        assert_extremes(&object);
+        struct rock_red_black_tree_node *out;
+        assert_int_equal(rock_red_black_tree_find(
+                &object, NULL, &entry->node, &out),
+                         ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+        assert_int_equal(rock_red_black_tree_insert(
+                &object, out, &entry->node), 0);
+        assert_extremes(&object);
+    }
+    struct rock_red_black_tree other = {};
+    struct entry needle = {.value = count / 3};
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(rock_red_black_tree_split(&object, &needle.node, &other,
+                                               &out), 0);
+    assert_ptr_equal(&entries[count / 3].node, out);
+    assert_extremes(&object);
+    assert_extremes(&other);
+    assert_int_equal(rock_red_black_tree_join(&object, out, &other), 0);
+    assert_extremes(&object);
+    assert_extremes(&other);
+    assert_int_equal(count, object.count);
+    assert_red_black_tree(&object);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(nodes);
+    free(entries);
+}
+
 static void check_next_error_on_node_is_null(void **state) {
     struct rock_red_black_tree_node *out;
     assert_int_equal(
@@ -2214,6 +4280,576 @@ static void check_prev(void **state) {
     assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
 }
 
+static void check_cursor_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_init(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_cursor_init_error_on_tree_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_init((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_NULL);
+}
+
+static void check_cursor_init(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct rock_red_black_tree_cursor cursor = {
+            .depth = (-1)
+    };
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    assert_ptr_equal(&object, cursor.tree);
+    assert_int_equal(0, cursor.depth);
+}
+
+static void check_cursor_first_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_first(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_cursor_first_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_first((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_cursor_first_error_on_tree_is_empty(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct rock_red_black_tree_cursor cursor;
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_cursor_first(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY);
+}
+
+static void check_cursor_last_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_last(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_cursor_last_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_last((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_cursor_last_error_on_tree_is_empty(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct rock_red_black_tree_cursor cursor;
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_cursor_last(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_TREE_IS_EMPTY);
+}
+
+static void check_cursor_seek_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_seek(NULL, (void *) 1, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_cursor_seek_error_on_needle_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_seek((void *) 1, NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_NEEDLE_IS_NULL);
+}
+
+static void check_cursor_seek_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_seek((void *) 1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_cursor_seek_error_on_node_not_found(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct entry a = {.value = 5}, needle = {.value = 6};
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
+    struct rock_red_black_tree_cursor cursor;
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_cursor_seek(&cursor, &needle.node, &out),
+            ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND);
+    assert_int_equal(0, cursor.depth);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_cursor_next_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_next(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_cursor_next_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_next((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_cursor_next_error_on_end_of_sequence(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct rock_red_black_tree_cursor cursor;
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_cursor_next(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+    struct entry a = {.value = 5};
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
+    assert_int_equal(rock_red_black_tree_cursor_last(&cursor, &out), 0);
+    assert_int_equal(
+            rock_red_black_tree_cursor_next(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+    assert_int_equal(1, cursor.depth);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_cursor_prev_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_prev(NULL, (void *) 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_cursor_prev_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_cursor_prev((void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OUT_IS_NULL);
+}
+
+static void check_cursor_prev_error_on_end_of_sequence(void **state) {
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    struct rock_red_black_tree_cursor cursor;
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    struct rock_red_black_tree_node *out;
+    assert_int_equal(
+            rock_red_black_tree_cursor_prev(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+    struct entry a = {.value = 5};
+    assert_int_equal(rock_red_black_tree_node_init(&a.node), 0);
+    assert_int_equal(rock_red_black_tree_insert(&object, NULL, &a.node), 0);
+    assert_int_equal(rock_red_black_tree_cursor_first(&cursor, &out), 0);
+    assert_int_equal(
+            rock_red_black_tree_cursor_prev(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+    assert_int_equal(1, cursor.depth);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+}
+
+static void check_cursor(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 1000;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    for (uintmax_t i = 0; i < count; i++) {
+        /* even values only, so that seeking odd values falls in between */
+        entries[i].value = 2 * (rand() % (4 * count));
+        struct rock_red_black_tree_node *out;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node, &out), 0);
+    }
+    struct rock_red_black_tree_cursor cursor;
+    assert_int_equal(rock_red_black_tree_cursor_init(&cursor, &object), 0);
+    /* forward and backward scans agree with next and prev */
+    struct rock_red_black_tree_node *node, *out;
+    assert_int_equal(rock_red_black_tree_first(&object, &node), 0);
+    assert_int_equal(rock_red_black_tree_cursor_first(&cursor, &out), 0);
+    uintmax_t visited = 1;
+    assert_ptr_equal(node, out);
+    while (!rock_red_black_tree_next(node, &node)) {
+        assert_int_equal(rock_red_black_tree_cursor_next(&cursor, &out), 0);
+        assert_ptr_equal(node, out);
+        visited++;
+    }
+    assert_int_equal(object.count, visited);
+    assert_int_equal(
+            rock_red_black_tree_cursor_next(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+    assert_int_equal(rock_red_black_tree_last(&object, &node), 0);
+    assert_int_equal(rock_red_black_tree_cursor_last(&cursor, &out), 0);
+    assert_ptr_equal(node, out);
+    while (!rock_red_black_tree_prev(node, &node)) {
+        assert_int_equal(rock_red_black_tree_cursor_prev(&cursor, &out), 0);
+        assert_ptr_equal(node, out);
+    }
+    assert_int_equal(
+            rock_red_black_tree_cursor_prev(&cursor, &out),
+            ROCK_RED_BLACK_TREE_ERROR_END_OF_SEQUENCE);
+    /* seeking agrees with lower bound and may be followed by any walk */
+    for (uintmax_t i = 0; i < count; i++) {
+        struct entry needle = {.value = rand() % (8 * count)};
+        const int error = rock_red_black_tree_lower_bound(
+                &object, &needle.node, &node);
+        assert_int_equal(
+                rock_red_black_tree_cursor_seek(&cursor, &needle.node, &out),
+                error);
+        if (error) {
+            assert_int_equal(ROCK_RED_BLACK_TREE_ERROR_NODE_NOT_FOUND, error);
+            continue;
+        }
+        assert_ptr_equal(node, out);
+        for (uintmax_t j = 0; j < 16; j++) {
+            const bool is_next = rand() % 2;
+            struct rock_red_black_tree_node *expected;
+            const int result = (is_next
+                                ? rock_red_black_tree_next
+                                : rock_red_black_tree_prev)(node, &expected);
+            assert_int_equal((is_next
+                              ? rock_red_black_tree_cursor_next
+                              : rock_red_black_tree_cursor_prev)(
+                    &cursor, &out), result);
+            if (!result) {
+                assert_ptr_equal(expected, out);
+                node = expected;
+            }
+        }
+    }
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(entries);
+}
+
+static void check_post_order_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_post_order(NULL, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_post_order_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_post_order((void *) 1, NULL, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL);
+}
+
+struct visit {
+    struct entry *entries;
+    uintmax_t *order;
+    uintmax_t count;
+};
+
+static void on_visit(struct rock_red_black_tree_node *node, void *context) {
+    struct visit *const visit = context;
+    struct entry *const entry = rock_container_of(node, struct entry, node);
+    /* every node is visited exactly once */
+    assert_int_equal(0, visit->order[entry - visit->entries]);
+    visit->order[entry - visit->entries] = ++visit->count;
+}
+
+static void on_visit_free(struct rock_red_black_tree_node *node,
+                          void *context) {
+    (*(uintmax_t *) context)++;
+    free(rock_container_of(node, struct entry, node));
+}
+
+static void check_post_order(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 1000;
+    struct entry *const entries = calloc(count, sizeof(*entries));
+    assert_non_null(entries);
+    uintmax_t *const order = calloc(count, sizeof(*order));
+    assert_non_null(order);
+    struct rock_red_black_tree object;
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    for (uintmax_t i = 0; i < count; i++) {
+        entries[i].value = rand() % (4 * count);
+        struct rock_red_black_tree_node *out;
+        assert_int_equal(rock_red_black_tree_find_or_insert(
+                &object, &entries[i].node, &out), 0);
+    }
+    struct visit visit = {.entries = entries, .order = order};
+    assert_int_equal(rock_red_black_tree_post_order(&object, on_visit,
+                                                    &visit), 0);
+    assert_int_equal(object.count, visit.count);
+    /* children are visited before their parent */
+    for (uintmax_t i = 0; i < count; i++) {
+        if (!order[i]) {
+            continue;
+        }
+        struct rock_red_black_tree_node *parent;
+        assert_int_equal(rock_red_black_tree_node_get_parent(
+                &entries[i].node, &parent), 0);
+        if (parent) {
+            const struct entry *const P = rock_container_of(
+                    parent, struct entry, node);
+            assert_true(order[i] < order[P - entries]);
+        } else {
+            assert_int_equal(object.count, order[i]);
+        }
+    }
+    /* the tree is left untouched */
+    struct rock_red_black_tree_node *node;
+    assert_int_equal(rock_red_black_tree_first(&object, &node), 0);
+    uintmax_t found = 1;
+    for (; !rock_red_black_tree_next(node, &node); found++) {
+    }
+    assert_int_equal(object.count, found);
+    assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+    free(order);
+    free(entries);
+
+    /* visited nodes may be released */
+    assert_int_equal(rock_red_black_tree_init(&object, compare_entry), 0);
+    for (uintmax_t i = 0; i < count; i++) {
+        struct entry *const entry = malloc(sizeof(*entry));
+        assert_non_null(entry);
+        entry->value = i;
+        assert_int_equal(rock_red_black_tree_node_init(&entry->node), 0);
+        assert_int_equal(rock_red_black_tree_append(&object, &entry->node),
+                         0);
+    }
+    uintmax_t released = 0;
+    assert_int_equal(rock_red_black_tree_post_order(&object, on_visit_free,
+                                                    &released), 0);
+    assert_int_equal(count, released);
+}
+
+static void check_invalidate_parallel_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_parallel(
+                    NULL, NULL, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_invalidate_parallel_error_on_pool_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_parallel(
+                    (void *) 1, NULL, NULL, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL);
+}
+
+static void check_invalidate_parallel_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_parallel(
+                    (void *) 1, NULL, (void *) 1, 0, 1),
+            ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_invalidate_parallel_error_on_threads_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_parallel(
+                    (void *) 1, NULL, (void *) 1, 1, 0),
+            ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO);
+}
+
+static void check_invalidate_batch_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_batch(
+                    NULL, (void *) 1, 1, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_invalidate_batch_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_batch(
+                    (void *) 1, NULL, 1, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL);
+}
+
+static void check_invalidate_batch_error_on_size_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_batch(
+                    (void *) 1, (void *) 1, 0, (void *) 1, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_SIZE_IS_ZERO);
+}
+
+static void check_invalidate_batch_error_on_pool_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_batch(
+                    (void *) 1, (void *) 1, 1, NULL, 1, 1),
+            ROCK_RED_BLACK_TREE_ERROR_POOL_IS_NULL);
+}
+
+static void check_invalidate_batch_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_batch(
+                    (void *) 1, (void *) 1, 1, (void *) 1, 0, 1),
+            ROCK_RED_BLACK_TREE_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_invalidate_batch_error_on_threads_is_zero(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_invalidate_batch(
+                    (void *) 1, (void *) 1, 1, (void *) 1, 1, 0),
+            ROCK_RED_BLACK_TREE_ERROR_THREADS_IS_ZERO);
+}
+
+static atomic_uintmax_t destroyed_count;
+static uintmax_t destroyed_size;
+
+static void on_destroy_free(struct rock_red_black_tree_node *node) {
+    atomic_fetch_add(&destroyed_count, 1);
+    free(rock_container_of(node, struct entry, node));
+}
+
+static void on_destroy_batch_free(struct rock_red_black_tree_node **nodes,
+                                  const uintmax_t count) {
+    assert_true(count > 0 && count <= destroyed_size);
+    atomic_fetch_add(&destroyed_count, count);
+    for (uintmax_t i = 0; i < count; i++) {
+        free(rock_container_of(nodes[i], struct entry, node));
+    }
+}
+
+static void insert_allocated_entries(struct rock_red_black_tree *const object,
+                                     const uintmax_t count) {
+    assert_int_equal(rock_red_black_tree_init(object, compare_entry), 0);
+    for (uintmax_t i = 0; i < count; i++) {
+        struct entry *const entry = malloc(sizeof(*entry));
+        assert_non_null(entry);
+        entry->value = i;
+        assert_int_equal(rock_red_black_tree_node_init(&entry->node), 0);
+        assert_int_equal(rock_red_black_tree_append(object, &entry->node), 0);
+    }
+}
+
+static void check_invalidate_parallel(void **state) {
+    struct rock_thread_pool pool;
+    assert_int_equal(rock_thread_pool_init(&pool, 4), 0);
+    for (uintmax_t round = 0; round < 20; round++) {
+        const uintmax_t count = round * 97;
+        struct rock_red_black_tree object;
+        insert_allocated_entries(&object, count);
+        atomic_store(&destroyed_count, 0);
+        /* small grain and budget so that forking occurs at every size */
+        assert_int_equal(rock_red_black_tree_invalidate_parallel(
+                &object, on_destroy_free, &pool, 1 + round, 1 + round % 8),
+                         0);
+        assert_int_equal(count, atomic_load(&destroyed_count));
+        assert_null(object.root);
+        assert_int_equal(0, object.count);
+    }
+    assert_int_equal(rock_thread_pool_invalidate(&pool), 0);
+}
+
+static void check_invalidate_batch(void **state) {
+    struct rock_thread_pool pool;
+    assert_int_equal(rock_thread_pool_init(&pool, 4), 0);
+    for (uintmax_t round = 0; round < 20; round++) {
+        const uintmax_t count = round * 97;
+        struct rock_red_black_tree object;
+        insert_allocated_entries(&object, count);
+        atomic_store(&destroyed_count, 0);
+        destroyed_size = 1 + round % 5 * 16;
+        assert_int_equal(rock_red_black_tree_invalidate_batch(
+                &object, on_destroy_batch_free, destroyed_size, &pool,
+                1 + round, 1 + round % 8), 0);
+        assert_int_equal(count, atomic_load(&destroyed_count));
+        assert_null(object.root);
+        assert_int_equal(0, object.count);
+    }
+    assert_int_equal(rock_thread_pool_invalidate(&pool), 0);
+}
+
+static void check_relocate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_relocate(
+                    NULL, ROCK_RED_BLACK_TREE_LAYOUT_BREADTH_FIRST,
+                    (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_relocate_error_on_layout_is_invalid(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_relocate((void *) 1, -1, (void *) 1, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_LAYOUT_IS_INVALID);
+}
+
+static void check_relocate_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_red_black_tree_relocate(
+                    (void *) 1, ROCK_RED_BLACK_TREE_LAYOUT_VAN_EMDE_BOAS,
+                    NULL, NULL),
+            ROCK_RED_BLACK_TREE_ERROR_FUNCTION_IS_NULL);
+}
+
+static struct rock_red_black_tree_node *on_move(
+        struct rock_red_black_tree_node *node,
+        const uintmax_t index,
+        void *context) {
+    struct entry *const arena = context;
+    /* positions are handed out one after the other */
+    assert_int_equal(0, arena[index].value);
+    memcpy(&arena[index], rock_container_of(node, struct entry, node),
+           sizeof(*arena));
+    return &arena[index].node;
+}
+
+static uintmax_t depth_of(struct rock_red_black_tree_node *node) {
+    uintmax_t depth = 0;
+    for (; node; depth++) {
+        assert_int_equal(rock_red_black_tree_node_get_parent(node, &node),
+                         0);
+    }
+    return depth;
+}
+
+static void check_relocate(void **state) {
+    srand(time(NULL));
+    const uintmax_t count = 1000;
+    const int layouts[] = {
+            ROCK_RED_BLACK_TREE_LAYOUT_BREADTH_FIRST,
+            ROCK_RED_BLACK_TREE_LAYOUT_VAN_EMDE_BOAS
+    };
+    for (uintmax_t i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++) {
+        struct entry *const entries = calloc(count, sizeof(*entries));
+        assert_non_null(entries);
+        struct entry *const arena = calloc(count, sizeof(*arena));
+        assert_non_null(arena);
+        struct rock_red_black_tree object;
+        assert_int_equal(rock_red_black_tree_init_cached(
+                &object, compare_entry), 0);
+        bool expected[4 * count];
+        memset(expected, 0, sizeof(expected));
+        for (uintmax_t j = 0; j < count; j++) {
+            /* zero is kept apart to mark unused positions of the arena */
+            entries[j].value = 1 + rand() % (4 * count - 1);
+            struct rock_red_black_tree_node *out;
+            assert_int_equal(rock_red_black_tree_find_or_insert(
+                    &object, &entries[j].node, &out), 0);
+            expected[entries[j].value] = true;
+        }
+        assert_int_equal(rock_red_black_tree_relocate(
+                &object, layouts[i], on_move, arena), 0);
+        free(entries);
+        assert_ptr_equal(&arena[0].node, object.root);
+        assert_extremes(&object);
+        assert_values(&object, expected, 4 * count);
+        for (uintmax_t j = 1; j < object.count; j++) {
+            struct rock_red_black_tree_node *parent;
+            assert_int_equal(rock_red_black_tree_node_get_parent(
+                    &arena[j].node, &parent), 0);
+            /* parents always precede their children */
+            assert_non_null(parent);
+            assert_true(parent < &arena[j].node);
+            if (ROCK_RED_BLACK_TREE_LAYOUT_BREADTH_FIRST == layouts[i]) {
+                assert_true(depth_of(&arena[j - 1].node)
+                            <= depth_of(&arena[j].node));
+            }
+        }
+        /* the relocated tree can still be modified */
+        for (uintmax_t j = 0; j < object.count; j += 2) {
+            assert_int_equal(rock_red_black_tree_remove(
+                    &object, &arena[j].node), 0);
+            expected[arena[j].value] = false;
+        }
+        assert_values(&object, expected, 4 * count);
+        assert_int_equal(rock_red_black_tree_invalidate(&object, NULL), 0);
+        free(arena);
+    }
+}
+
 static void check_remove_error_on_object_is_null(void **state) {
     assert_int_equal(
             rock_red_black_tree_remove(NULL, (void *) 1),
@@ -3124,6 +5760,30 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_init_error_on_object_is_null),
             cmocka_unit_test(check_init_error_on_compare_is_null),
             cmocka_unit_test(check_init),
+            cmocka_unit_test(check_init_order_statistic_error_on_object_is_null),
+            cmocka_unit_test(check_init_order_statistic_error_on_compare_is_null),
+            cmocka_unit_test(check_init_order_statistic),
+            cmocka_unit_test(check_init_augmented_error_on_object_is_null),
+            cmocka_unit_test(check_init_augmented_error_on_compare_is_null),
+            cmocka_unit_test(check_init_augmented_error_on_augment_is_null),
+            cmocka_unit_test(check_init_augmented_error_on_function_is_null),
+            cmocka_unit_test(check_init_augmented),
+            cmocka_unit_test(check_init_keyed_error_on_object_is_null),
+            cmocka_unit_test(check_init_keyed_error_on_key_kind_is_invalid),
+            cmocka_unit_test(check_init_keyed),
+            cmocka_unit_test(check_keyed),
+            cmocka_unit_test(check_prefixed_node_init_error_on_node_is_null),
+            cmocka_unit_test(check_prefixed_node_init_error_on_key_is_null),
+            cmocka_unit_test(check_prefixed_node_init),
+            cmocka_unit_test(check_init_prefixed_error_on_object_is_null),
+            cmocka_unit_test(check_init_prefixed_error_on_key_kind_is_invalid),
+            cmocka_unit_test(check_init_prefixed),
+            cmocka_unit_test(check_prefixed),
+            cmocka_unit_test(check_init_cached_error_on_object_is_null),
+            cmocka_unit_test(check_init_cached_error_on_compare_is_null),
+            cmocka_unit_test(check_init_cached),
+            cmocka_unit_test(check_set_cached_error_on_object_is_null),
+            cmocka_unit_test(check_set_cached),
             cmocka_unit_test(check_invalidate_on_object_is_null),
             cmocka_unit_test(check_invalidate),
             cmocka_unit_test(check_count_error_on_object_is_null),
@@ -3135,6 +5795,36 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_find_error_on_node_not_found),
             cmocka_unit_test(check_find_empty_tree),
             cmocka_unit_test(check_find),
+            cmocka_unit_test(check_find_batch_error_on_object_is_null),
+            cmocka_unit_test(check_find_batch_error_on_needles_is_null),
+            cmocka_unit_test(check_find_batch_error_on_out_is_null),
+            cmocka_unit_test(check_find_batch),
+            cmocka_unit_test(check_lower_bound_error_on_object_is_null),
+            cmocka_unit_test(check_lower_bound_error_on_needle_is_null),
+            cmocka_unit_test(check_lower_bound_error_on_out_is_null),
+            cmocka_unit_test(check_upper_bound_error_on_object_is_null),
+            cmocka_unit_test(check_upper_bound_error_on_needle_is_null),
+            cmocka_unit_test(check_upper_bound_error_on_out_is_null),
+            cmocka_unit_test(check_floor_error_on_object_is_null),
+            cmocka_unit_test(check_floor_error_on_needle_is_null),
+            cmocka_unit_test(check_floor_error_on_out_is_null),
+            cmocka_unit_test(check_ceiling_error_on_object_is_null),
+            cmocka_unit_test(check_ceiling_error_on_needle_is_null),
+            cmocka_unit_test(check_ceiling_error_on_out_is_null),
+            cmocka_unit_test(check_bounds),
+            cmocka_unit_test(check_select_error_on_object_is_null),
+            cmocka_unit_test(check_select_error_on_out_is_null),
+            cmocka_unit_test(check_select_error_on_index_is_out_of_bounds),
+            cmocka_unit_test(check_rank_error_on_object_is_null),
+            cmocka_unit_test(check_rank_error_on_node_is_null),
+            cmocka_unit_test(check_rank_error_on_out_is_null),
+            cmocka_unit_test(check_count_range_error_on_object_is_null),
+            cmocka_unit_test(check_count_range_error_on_low_is_null),
+            cmocka_unit_test(check_count_range_error_on_high_is_null),
+            cmocka_unit_test(check_count_range_error_on_out_is_null),
+            cmocka_unit_test(check_select_and_rank),
+            cmocka_unit_test(check_count_range),
+            cmocka_unit_test(check_augmented),
             cmocka_unit_test(check_insert_error_on_object_is_null),
             cmocka_unit_test(check_insert_error_on_insertion_point_is_null),
             cmocka_unit_test(check_insert_error_on_node_is_null),
@@ -3147,6 +5837,71 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_insert_case_2b_configuration_0),
             cmocka_unit_test(check_insert_case_2a),
             cmocka_unit_test(check_insert),
+            cmocka_unit_test(check_find_or_insert_error_on_object_is_null),
+            cmocka_unit_test(check_find_or_insert_error_on_node_is_null),
+            cmocka_unit_test(check_find_or_insert_error_on_out_is_null),
+            cmocka_unit_test(check_find_or_insert),
+            cmocka_unit_test(check_find_near_error_on_object_is_null),
+            cmocka_unit_test(check_find_near_error_on_needle_is_null),
+            cmocka_unit_test(check_find_near_error_on_out_is_null),
+            cmocka_unit_test(check_find_near),
+            cmocka_unit_test(check_insert_near_error_on_object_is_null),
+            cmocka_unit_test(check_insert_near_error_on_node_is_null),
+            cmocka_unit_test(check_insert_near_error_on_node_already_exists),
+            cmocka_unit_test(check_insert_near),
+            cmocka_unit_test(check_append_error_on_object_is_null),
+            cmocka_unit_test(check_append_error_on_node_is_null),
+            cmocka_unit_test(check_append),
+            cmocka_unit_test(check_link_error_on_object_is_null),
+            cmocka_unit_test(check_link_error_on_node_is_null),
+            cmocka_unit_test(check_define_error_on_object_is_null),
+            cmocka_unit_test(check_define_error_on_needle_is_null),
+            cmocka_unit_test(check_define_error_on_out_is_null),
+            cmocka_unit_test(check_define_error_on_node_is_null),
+            cmocka_unit_test(check_define),
+            cmocka_unit_test(check_define_string),
+            cmocka_unit_test(check_build_sorted_error_on_object_is_null),
+            cmocka_unit_test(check_build_sorted_error_on_nodes_is_null),
+            cmocka_unit_test(check_build_sorted_error_on_tree_is_not_empty),
+            cmocka_unit_test(check_build_sorted),
+            cmocka_unit_test(check_join_error_on_object_is_null),
+            cmocka_unit_test(check_join_error_on_node_is_null),
+            cmocka_unit_test(check_join_error_on_other_is_null),
+            cmocka_unit_test(check_join),
+            cmocka_unit_test(check_split_error_on_object_is_null),
+            cmocka_unit_test(check_split_error_on_needle_is_null),
+            cmocka_unit_test(check_split_error_on_other_is_null),
+            cmocka_unit_test(check_split_error_on_out_is_null),
+            cmocka_unit_test(check_split_error_on_tree_is_not_empty),
+            cmocka_unit_test(check_split),
+            cmocka_unit_test(check_union_error_on_object_is_null),
+            cmocka_unit_test(check_union_error_on_other_is_null),
+            cmocka_unit_test(check_union),
+            cmocka_unit_test(check_intersection_error_on_object_is_null),
+            cmocka_unit_test(check_intersection_error_on_other_is_null),
+            cmocka_unit_test(check_intersection),
+            cmocka_unit_test(check_difference_error_on_object_is_null),
+            cmocka_unit_test(check_difference_error_on_other_is_null),
+            cmocka_unit_test(check_difference),
+            cmocka_unit_test(check_parallel_union_error_on_object_is_null),
+            cmocka_unit_test(check_parallel_union_error_on_other_is_null),
+            cmocka_unit_test(check_parallel_union_error_on_pool_is_null),
+            cmocka_unit_test(check_parallel_union_error_on_grain_is_zero),
+            cmocka_unit_test(check_parallel_union_error_on_threads_is_zero),
+            cmocka_unit_test(check_parallel_union),
+            cmocka_unit_test(check_parallel_intersection_error_on_object_is_null),
+            cmocka_unit_test(check_parallel_intersection_error_on_other_is_null),
+            cmocka_unit_test(check_parallel_intersection_error_on_pool_is_null),
+            cmocka_unit_test(check_parallel_intersection_error_on_grain_is_zero),
+            cmocka_unit_test(check_parallel_intersection_error_on_threads_is_zero),
+            cmocka_unit_test(check_parallel_intersection),
+            cmocka_unit_test(check_parallel_difference_error_on_object_is_null),
+            cmocka_unit_test(check_parallel_difference_error_on_other_is_null),
+            cmocka_unit_test(check_parallel_difference_error_on_pool_is_null),
+            cmocka_unit_test(check_parallel_difference_error_on_grain_is_zero),
+            cmocka_unit_test(check_parallel_difference_error_on_threads_is_zero),
+            cmocka_unit_test(check_parallel_difference),
+            cmocka_unit_test(check_order_statistic_join_split_and_set_operations),
             cmocka_unit_test(check_first_error_on_object_is_null),
             cmocka_unit_test(check_first_error_on_out_is_null),
             cmocka_unit_test(check_first_error_on_tree_is_empty),
@@ -3155,12 +5910,59 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_last_error_on_null_out_is_null),
             cmocka_unit_test(check_last_error_on_tree_is_empty),
             cmocka_unit_test(check_last),
+            cmocka_unit_test(check_pop_first_error_on_object_is_null),
+            cmocka_unit_test(check_pop_first_error_on_out_is_null),
+            cmocka_unit_test(check_pop_first_error_on_tree_is_empty),
+            cmocka_unit_test(check_pop_last_error_on_object_is_null),
+            cmocka_unit_test(check_pop_last_error_on_out_is_null),
+            cmocka_unit_test(check_pop_last_error_on_tree_is_empty),
+            cmocka_unit_test(check_pop),
+            cmocka_unit_test(check_cached),
             cmocka_unit_test(check_next_error_on_node_is_null),
             cmocka_unit_test(check_next_error_on_out_is_null),
             cmocka_unit_test(check_next),
             cmocka_unit_test(check_prev_error_on_node_is_null),
             cmocka_unit_test(check_prev_error_on_out_is_null),
             cmocka_unit_test(check_prev),
+            cmocka_unit_test(check_cursor_init_error_on_object_is_null),
+            cmocka_unit_test(check_cursor_init_error_on_tree_is_null),
+            cmocka_unit_test(check_cursor_init),
+            cmocka_unit_test(check_cursor_first_error_on_object_is_null),
+            cmocka_unit_test(check_cursor_first_error_on_out_is_null),
+            cmocka_unit_test(check_cursor_first_error_on_tree_is_empty),
+            cmocka_unit_test(check_cursor_last_error_on_object_is_null),
+            cmocka_unit_test(check_cursor_last_error_on_out_is_null),
+            cmocka_unit_test(check_cursor_last_error_on_tree_is_empty),
+            cmocka_unit_test(check_cursor_seek_error_on_object_is_null),
+            cmocka_unit_test(check_cursor_seek_error_on_needle_is_null),
+            cmocka_unit_test(check_cursor_seek_error_on_out_is_null),
+            cmocka_unit_test(check_cursor_seek_error_on_node_not_found),
+            cmocka_unit_test(check_cursor_next_error_on_object_is_null),
+            cmocka_unit_test(check_cursor_next_error_on_out_is_null),
+            cmocka_unit_test(check_cursor_next_error_on_end_of_sequence),
+            cmocka_unit_test(check_cursor_prev_error_on_object_is_null),
+            cmocka_unit_test(check_cursor_prev_error_on_out_is_null),
+            cmocka_unit_test(check_cursor_prev_error_on_end_of_sequence),
+            cmocka_unit_test(check_cursor),
+            cmocka_unit_test(check_post_order_error_on_object_is_null),
+            cmocka_unit_test(check_post_order_error_on_function_is_null),
+            cmocka_unit_test(check_post_order),
+            cmocka_unit_test(check_invalidate_parallel_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate_parallel_error_on_pool_is_null),
+            cmocka_unit_test(check_invalidate_parallel_error_on_grain_is_zero),
+            cmocka_unit_test(check_invalidate_parallel_error_on_threads_is_zero),
+            cmocka_unit_test(check_invalidate_parallel),
+            cmocka_unit_test(check_invalidate_batch_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate_batch_error_on_function_is_null),
+            cmocka_unit_test(check_invalidate_batch_error_on_size_is_zero),
+            cmocka_unit_test(check_invalidate_batch_error_on_pool_is_null),
+            cmocka_unit_test(check_invalidate_batch_error_on_grain_is_zero),
+            cmocka_unit_test(check_invalidate_batch_error_on_threads_is_zero),
+            cmocka_unit_test(check_invalidate_batch),
+            cmocka_unit_test(check_relocate_error_on_object_is_null),
+            cmocka_unit_test(check_relocate_error_on_layout_is_invalid),
+            cmocka_unit_test(check_relocate_error_on_function_is_null),
+            cmocka_unit_test(check_relocate),
             cmocka_unit_test(check_remove_error_on_object_is_null),
             cmocka_unit_test(check_remove_error_on_node_is_null),
             cmocka_unit_test(check_remove_leaf_nodes),
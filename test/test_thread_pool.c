@@ -0,0 +1,544 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <rock.h>
+
+#include "private/thread_pool.h"
+#include <test/cmocka.h>
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_init(NULL, 1),
+            ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_error_on_count_is_zero(void **state) {
+    assert_int_equal(
+            rock_thread_pool_init((void *) 1, 0),
+            ROCK_THREAD_POOL_ERROR_COUNT_IS_ZERO);
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(
+            rock_thread_pool_init(&object, UINTMAX_MAX),
+            ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_thread_pool_init(&object, 2),
+            ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+}
+
+static void check_init(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 3), 0);
+    assert_int_equal(3, object.count);
+    assert_non_null(object.workers);
+    for (uintmax_t i = 0; i < object.count; i++) {
+        assert_ptr_equal(&object, object.workers[i].pool);
+        assert_int_equal(i, object.workers[i].id);
+    }
+    assert_int_equal(0, object.pending);
+    assert_false(object.is_shutdown);
+    assert_null(rock_thread_pool_worker_current(&object));
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_invalidate(NULL),
+            ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_invalidate(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 2), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+    assert_null(object.workers);
+    assert_int_equal(0, object.count);
+}
+
+#define ORDER_LIMIT         100
+
+struct order {
+    struct rock_thread_pool *pool;
+    atomic_bool is_started;
+    atomic_bool is_released;
+    atomic_uintmax_t remaining;
+    atomic_uintmax_t count;
+    uintmax_t seen[ORDER_LIMIT];
+};
+
+static void on_order_block(void *context,
+                           const uintmax_t begin,
+                           const uintmax_t end) {
+    struct order *const order = context;
+    atomic_store(&order->is_started, true);
+    while (!atomic_load(&order->is_released)) {
+        sched_yield();
+    }
+    rock_thread_pool_complete(order->pool, &order->remaining, 1);
+}
+
+static void on_order_record(void *context,
+                            const uintmax_t begin,
+                            const uintmax_t end) {
+    struct order *const order = context;
+    order->seen[atomic_fetch_add(&order->count, 1)] = begin;
+    rock_thread_pool_complete(order->pool, &order->remaining, 1);
+}
+
+static void check_execute_in_submission_order(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 1), 0);
+    struct order order = {
+            .pool = &object
+    };
+    atomic_init(&order.remaining, 1 + ORDER_LIMIT);
+    /* keep the only worker busy until every task has been submitted */
+    const struct rock_thread_pool_task block = {
+            .function = on_order_block,
+            .context = &order
+    };
+    assert_int_equal(rock_thread_pool_spawn(&object, &block), 0);
+    for (uintmax_t i = 0; i < ORDER_LIMIT; i++) {
+        const struct rock_thread_pool_task task = {
+                .function = on_order_record,
+                .context = &order,
+                .begin = i,
+                .end = 1 + i
+        };
+        assert_int_equal(rock_thread_pool_spawn(&object, &task), 0);
+    }
+    atomic_store(&order.is_released, true);
+    rock_thread_pool_wait(&object, &order.remaining);
+    assert_int_equal(ORDER_LIMIT, order.count);
+    for (uintmax_t i = 0; i < ORDER_LIMIT; i++) {
+        assert_int_equal(i, order.seen[i]);
+    }
+    assert_int_equal(0, object.head);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_execute_compacts_queue(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 1), 0);
+    struct order order = {
+            .pool = &object
+    };
+    atomic_init(&order.remaining, 1 + ORDER_LIMIT);
+    const struct rock_thread_pool_task block = {
+            .function = on_order_block,
+            .context = &order
+    };
+    assert_int_equal(rock_thread_pool_spawn(&object, &block), 0);
+    while (!atomic_load(&order.is_started)) {
+        sched_yield();
+    }
+    /* the queue never runs empty while tasks keep being submitted, yet the
+     * consumed items are released */
+    for (uintmax_t i = 0; i < ORDER_LIMIT; i++) {
+        const struct rock_thread_pool_task task = {
+                .function = on_order_record,
+                .context = &order,
+                .begin = i,
+                .end = 1 + i
+        };
+        assert_int_equal(rock_thread_pool_spawn(&object, &task), 0);
+        if (!i) {
+            continue;
+        }
+        assert_true(rock_thread_pool_execute(&object, NULL));
+        assert_int_equal(1, object.queue.length - object.head);
+        assert_true(object.queue.length <= 2);
+    }
+    atomic_store(&order.is_released, true);
+    rock_thread_pool_wait(&object, &order.remaining);
+    assert_int_equal(ORDER_LIMIT, order.count);
+    for (uintmax_t i = 0; i < ORDER_LIMIT; i++) {
+        assert_int_equal(i, order.seen[i]);
+    }
+    assert_int_equal(0, object.head);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_count_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_count(NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_count_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_count((void *) 1, NULL),
+            ROCK_THREAD_POOL_ERROR_OUT_IS_NULL);
+}
+
+static void check_count(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 2), 0);
+    uintmax_t count;
+    assert_int_equal(rock_thread_pool_count(&object, &count), 0);
+    assert_int_equal(2, count);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_parallel_for_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_for(NULL, (void *) 1, 1, (void *) 1,
+                                          NULL),
+            ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_parallel_for_error_on_array_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_for((void *) 1, NULL, 1, (void *) 1,
+                                          NULL),
+            ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL);
+}
+
+static void check_parallel_for_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_for((void *) 1, (void *) 1, 0,
+                                          (void *) 1, NULL),
+            ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_parallel_for_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_for((void *) 1, (void *) 1, 1, NULL,
+                                          NULL),
+            ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL);
+}
+
+struct visit {
+    uintmax_t grain;
+    atomic_uint *seen;
+    atomic_uintmax_t calls;
+    atomic_bool is_oversized;
+};
+
+static void on_visit(const struct rock_array *array,
+                     const uintmax_t begin,
+                     const uintmax_t end,
+                     void *context) {
+    struct visit *const visit = context;
+    atomic_fetch_add(&visit->calls, 1);
+    if (begin >= end || end - begin > visit->grain) {
+        atomic_store(&visit->is_oversized, true);
+    }
+    for (uintmax_t i = begin; i < end; i++) {
+        uintmax_t *item;
+        if (!rock_array_get(array, i, (void **) &item) && *item == i) {
+            atomic_fetch_add(&visit->seen[i], 1);
+        }
+    }
+}
+
+static void init_array(struct rock_array *const array, const uintmax_t count) {
+    assert_int_equal(rock_array_init(array, sizeof(uintmax_t), count), 0);
+    for (uintmax_t i = 0; i < count; i++) {
+        assert_int_equal(rock_array_add(array, &i), 0);
+    }
+}
+
+static void check_parallel_for_on_empty(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 2), 0);
+    struct rock_array array;
+    init_array(&array, 0);
+    struct visit visit = {.grain = 1};
+    assert_int_equal(rock_thread_pool_parallel_for(&object, &array, 1,
+                                                   on_visit, &visit), 0);
+    assert_int_equal(0, visit.calls);
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_parallel_for(void **state) {
+    const uintmax_t limit = 100000;
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 4), 0);
+    struct rock_array array;
+    init_array(&array, limit);
+    const uintmax_t grains[] = {1, 7, 1000, limit, 2 * limit};
+    for (uintmax_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        struct visit visit = {
+                .grain = grains[g],
+                .seen = calloc(limit, sizeof(atomic_uint))
+        };
+        assert_non_null(visit.seen);
+        assert_int_equal(rock_thread_pool_parallel_for(
+                &object, &array, visit.grain, on_visit, &visit), 0);
+        assert_false(visit.is_oversized);
+        assert_true(visit.calls >= (limit + visit.grain - 1) / visit.grain);
+        for (uintmax_t i = 0; i < limit; i++) {
+            assert_int_equal(1, visit.seen[i]);
+        }
+        free(visit.seen);
+    }
+    assert_int_equal(object.pending, 0);
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+struct nested {
+    struct rock_thread_pool *pool;
+    struct rock_array *inner;
+    atomic_uintmax_t total;
+    atomic_bool is_failed;
+};
+
+static void on_nested_inner(const struct rock_array *array,
+                            const uintmax_t begin,
+                            const uintmax_t end,
+                            void *context) {
+    struct nested *const nested = context;
+    atomic_fetch_add(&nested->total, end - begin);
+}
+
+static void on_nested_outer(const struct rock_array *array,
+                            const uintmax_t begin,
+                            const uintmax_t end,
+                            void *context) {
+    struct nested *const nested = context;
+    for (uintmax_t i = begin; i < end; i++) {
+        if (rock_thread_pool_parallel_for(nested->pool, nested->inner, 16,
+                                          on_nested_inner, nested)) {
+            atomic_store(&nested->is_failed, true);
+        }
+    }
+}
+
+static void check_parallel_for_nested(void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 3), 0);
+    struct rock_array outer;
+    init_array(&outer, 64);
+    struct rock_array inner;
+    init_array(&inner, 1000);
+    struct nested nested = {
+            .pool = &object,
+            .inner = &inner
+    };
+    assert_int_equal(rock_thread_pool_parallel_for(
+            &object, &outer, 1, on_nested_outer, &nested), 0);
+    assert_false(nested.is_failed);
+    assert_int_equal(64 * 1000, nested.total);
+    assert_int_equal(rock_array_invalidate(&inner, NULL), 0);
+    assert_int_equal(rock_array_invalidate(&outer, NULL), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_parallel_reduce_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    NULL, (void *) 1, 1, 1, (void *) 1, (void *) 1,
+                    (void *) 1, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_parallel_reduce_error_on_array_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, NULL, 1, 1, (void *) 1, (void *) 1,
+                    (void *) 1, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_ARRAY_IS_NULL);
+}
+
+static void check_parallel_reduce_error_on_grain_is_zero(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, (void *) 1, 0, 1, (void *) 1, (void *) 1,
+                    (void *) 1, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_GRAIN_IS_ZERO);
+}
+
+static void check_parallel_reduce_error_on_size_is_zero(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, (void *) 1, 1, 0, (void *) 1, (void *) 1,
+                    (void *) 1, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_SIZE_IS_ZERO);
+}
+
+static void check_parallel_reduce_error_on_identity_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, (void *) 1, 1, 1, NULL, (void *) 1,
+                    (void *) 1, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_IDENTITY_IS_NULL);
+}
+
+static void check_parallel_reduce_error_on_function_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, (void *) 1, 1, 1, (void *) 1, NULL,
+                    (void *) 1, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL);
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, (void *) 1, 1, 1, (void *) 1, (void *) 1,
+                    NULL, NULL, (void *) 1),
+            ROCK_THREAD_POOL_ERROR_FUNCTION_IS_NULL);
+}
+
+static void check_parallel_reduce_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    (void *) 1, (void *) 1, 1, 1, (void *) 1, (void *) 1,
+                    (void *) 1, NULL, NULL),
+            ROCK_THREAD_POOL_ERROR_OUT_IS_NULL);
+}
+
+static void on_fold_sum(void *accumulator,
+                        const struct rock_array *array,
+                        const uintmax_t begin,
+                        const uintmax_t end,
+                        void *context) {
+    uintmax_t *const sum = accumulator;
+    for (uintmax_t i = begin; i < end; i++) {
+        uintmax_t *item;
+        if (!rock_array_get(array, i, (void **) &item)) {
+            *sum += *item;
+        }
+    }
+}
+
+static void on_combine_sum(void *accumulator,
+                           const void *other,
+                           void *context) {
+    *(uintmax_t *) accumulator += *(const uintmax_t *) other;
+}
+
+struct wide {
+    uintmax_t sum;
+    unsigned char padding[70];
+    uintmax_t count;
+};
+
+static void on_fold_wide(void *accumulator,
+                         const struct rock_array *array,
+                         const uintmax_t begin,
+                         const uintmax_t end,
+                         void *context) {
+    struct wide *const wide = accumulator;
+    on_fold_sum(&wide->sum, array, begin, end, context);
+    wide->count += end - begin;
+}
+
+static void on_combine_wide(void *accumulator,
+                            const void *other,
+                            void *context) {
+    struct wide *const wide = accumulator;
+    const struct wide *const from = other;
+    wide->sum += from->sum;
+    wide->count += from->count;
+}
+
+static void check_parallel_reduce_error_on_memory_allocation_failed(
+        void **state) {
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 2), 0);
+    struct rock_array array;
+    init_array(&array, 100);
+    const uintmax_t identity = 0;
+    uintmax_t sum;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_thread_pool_parallel_reduce(
+                    &object, &array, 1, sizeof(uintmax_t), &identity,
+                    on_fold_sum, on_combine_sum, NULL, &sum),
+            ROCK_THREAD_POOL_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_parallel_reduce(void **state) {
+    const uintmax_t limit = 100000;
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 4), 0);
+    struct rock_array array;
+    init_array(&array, 0);
+    const uintmax_t identity = 0;
+    uintmax_t sum = 1;
+    assert_int_equal(rock_thread_pool_parallel_reduce(
+            &object, &array, 10, sizeof(uintmax_t), &identity,
+            on_fold_sum, on_combine_sum, NULL, &sum), 0);
+    assert_int_equal(0, sum);
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    init_array(&array, limit);
+    const uintmax_t grains[] = {1, 64, limit};
+    for (uintmax_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        assert_int_equal(rock_thread_pool_parallel_reduce(
+                &object, &array, grains[g], sizeof(uintmax_t), &identity,
+                on_fold_sum, on_combine_sum, NULL, &sum), 0);
+        assert_int_equal((limit * (limit - 1)) / 2, sum);
+    }
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+static void check_parallel_reduce_wide_accumulator(void **state) {
+    const uintmax_t limit = 10000;
+    struct rock_thread_pool object;
+    assert_int_equal(rock_thread_pool_init(&object, 3), 0);
+    struct rock_array array;
+    init_array(&array, limit);
+    const struct wide identity = {0};
+    struct wide wide;
+    assert_int_equal(rock_thread_pool_parallel_reduce(
+            &object, &array, 16, sizeof(struct wide), &identity,
+            on_fold_wide, on_combine_wide, NULL, &wide), 0);
+    assert_int_equal((limit * (limit - 1)) / 2, wide.sum);
+    assert_int_equal(limit, wide.count);
+    assert_int_equal(rock_array_invalidate(&array, NULL), 0);
+    assert_int_equal(rock_thread_pool_invalidate(&object), 0);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_count_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_execute_in_submission_order),
+            cmocka_unit_test(check_execute_compacts_queue),
+            cmocka_unit_test(check_count_error_on_object_is_null),
+            cmocka_unit_test(check_count_error_on_out_is_null),
+            cmocka_unit_test(check_count),
+            cmocka_unit_test(check_parallel_for_error_on_object_is_null),
+            cmocka_unit_test(check_parallel_for_error_on_array_is_null),
+            cmocka_unit_test(check_parallel_for_error_on_grain_is_zero),
+            cmocka_unit_test(check_parallel_for_error_on_function_is_null),
+            cmocka_unit_test(check_parallel_for_on_empty),
+            cmocka_unit_test(check_parallel_for),
+            cmocka_unit_test(check_parallel_for_nested),
+            cmocka_unit_test(check_parallel_reduce_error_on_object_is_null),
+            cmocka_unit_test(check_parallel_reduce_error_on_array_is_null),
+            cmocka_unit_test(check_parallel_reduce_error_on_grain_is_zero),
+            cmocka_unit_test(check_parallel_reduce_error_on_size_is_zero),
+            cmocka_unit_test(check_parallel_reduce_error_on_identity_is_null),
+            cmocka_unit_test(check_parallel_reduce_error_on_function_is_null),
+            cmocka_unit_test(check_parallel_reduce_error_on_out_is_null),
+            cmocka_unit_test(
+                    check_parallel_reduce_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_parallel_reduce),
+            cmocka_unit_test(check_parallel_reduce_wide_accumulator),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
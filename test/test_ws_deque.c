@@ -0,0 +1,383 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <rock.h>
+
+#include "private/ws_deque.h"
+#include <test/cmocka.h>
+
+static void check_init_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_init(NULL, sizeof(uintmax_t), 0),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    assert_int_equal(
+            rock_ws_deque_init((void *) 1, 0, 0),
+            ROCK_WS_DEQUE_ERROR_SIZE_IS_ZERO);
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(
+            rock_ws_deque_init(&object, sizeof(uintmax_t), UINTMAX_MAX),
+            ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_ws_deque_init(&object, sizeof(uintmax_t), 10),
+            ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+}
+
+static void check_init(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    assert_int_equal(sizeof(uintmax_t), object.size);
+    assert_non_null(object.buffer);
+    assert_int_equal(1, object.buffer->capacity);
+    assert_null(object.retired);
+    assert_int_equal(0, object.top);
+    assert_int_equal(0, object.bottom);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 5), 0);
+    assert_int_equal(8, object.buffer->capacity);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_invalidate(NULL, NULL),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void on_destroy(void *item) {
+    function_called();
+    assert_non_null(item);
+}
+
+static void check_invalidate(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_int_equal(rock_ws_deque_push(&object, &i), 0);
+    }
+    uintmax_t out;
+    assert_int_equal(rock_ws_deque_steal(&object, &out), 0);
+    assert_int_equal(rock_ws_deque_pop(&object, &out), 0);
+    expect_function_calls(on_destroy, 8);
+    assert_int_equal(rock_ws_deque_invalidate(&object, on_destroy), 0);
+    assert_null(object.buffer);
+    assert_null(object.retired);
+    assert_int_equal(0, object.size);
+}
+
+static void check_size_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_size(NULL, (void *) 1),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_size_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_size((void *) 1, NULL),
+            ROCK_WS_DEQUE_ERROR_OUT_IS_NULL);
+}
+
+static void check_size(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, 13, 0), 0);
+    size_t out;
+    assert_int_equal(rock_ws_deque_size(&object, &out), 0);
+    assert_int_equal(13, out);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_count_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_count(NULL, (void *) 1),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_count_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_count((void *) 1, NULL),
+            ROCK_WS_DEQUE_ERROR_OUT_IS_NULL);
+}
+
+static void check_count(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    uintmax_t out;
+    assert_int_equal(rock_ws_deque_count(&object, &out), 0);
+    assert_int_equal(0, out);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(rock_ws_deque_push(&object, &i), 0);
+    }
+    assert_int_equal(rock_ws_deque_count(&object, &out), 0);
+    assert_int_equal(3, out);
+    uintmax_t item;
+    assert_int_equal(rock_ws_deque_steal(&object, &item), 0);
+    assert_int_equal(rock_ws_deque_count(&object, &out), 0);
+    assert_int_equal(2, out);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_push_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_push(NULL, (void *) 1),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_push_error_on_item_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_push((void *) 1, NULL),
+            ROCK_WS_DEQUE_ERROR_ITEM_IS_NULL);
+}
+
+static void check_push_error_on_memory_allocation_failed(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 2), 0);
+    uintmax_t item = 0;
+    assert_int_equal(rock_ws_deque_push(&object, &item), 0);
+    assert_int_equal(rock_ws_deque_push(&object, &item), 0);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_int_equal(
+            rock_ws_deque_push(&object, &item),
+            ROCK_WS_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED);
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    uintmax_t out;
+    assert_int_equal(rock_ws_deque_count(&object, &out), 0);
+    assert_int_equal(2, out);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_push(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 2), 0);
+    uintmax_t item = 1;
+    assert_int_equal(rock_ws_deque_push(&object, &item), 0);
+    assert_int_equal(1, object.bottom);
+    assert_int_equal(2, object.buffer->capacity);
+    item = 2;
+    assert_int_equal(rock_ws_deque_push(&object, &item), 0);
+    assert_null(object.retired);
+    item = 3;
+    assert_int_equal(rock_ws_deque_push(&object, &item), 0);
+    assert_int_equal(4, object.buffer->capacity);
+    assert_non_null(object.retired);
+    assert_int_equal(2, object.retired->capacity);
+    assert_int_equal(3, object.bottom);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(i + 1, *(uintmax_t *) rock_ws_deque_buffer_address(
+                object.buffer, object.size, i));
+    }
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_pop_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_pop(NULL, (void *) 1),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_pop_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_pop((void *) 1, NULL),
+            ROCK_WS_DEQUE_ERROR_OUT_IS_NULL);
+}
+
+static void check_pop_error_on_deque_is_empty(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    uintmax_t out;
+    assert_int_equal(
+            rock_ws_deque_pop(&object, &out),
+            ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY);
+    assert_int_equal(0, object.bottom);
+    assert_int_equal(0, object.top);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_pop(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    for (uintmax_t i = 0; i < 100; i++) {
+        assert_int_equal(rock_ws_deque_push(&object, &i), 0);
+    }
+    uintmax_t out;
+    for (uintmax_t i = 100; i; i--) {
+        assert_int_equal(rock_ws_deque_pop(&object, &out), 0);
+        assert_int_equal(i - 1, out);
+    }
+    assert_int_equal(
+            rock_ws_deque_pop(&object, &out),
+            ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_steal_error_on_object_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_steal(NULL, (void *) 1),
+            ROCK_WS_DEQUE_ERROR_OBJECT_IS_NULL);
+}
+
+static void check_steal_error_on_out_is_null(void **state) {
+    assert_int_equal(
+            rock_ws_deque_steal((void *) 1, NULL),
+            ROCK_WS_DEQUE_ERROR_OUT_IS_NULL);
+}
+
+static void check_steal_error_on_deque_is_empty(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    uintmax_t out;
+    assert_int_equal(
+            rock_ws_deque_steal(&object, &out),
+            ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_steal(void **state) {
+    struct rock_ws_deque object;
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(uintmax_t), 0), 0);
+    for (uintmax_t i = 0; i < 100; i++) {
+        assert_int_equal(rock_ws_deque_push(&object, &i), 0);
+    }
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 50; i++) {
+        assert_int_equal(rock_ws_deque_steal(&object, &out), 0);
+        assert_int_equal(i, out);
+    }
+    for (uintmax_t i = 100; i > 50; i--) {
+        assert_int_equal(rock_ws_deque_pop(&object, &out), 0);
+        assert_int_equal(i - 1, out);
+    }
+    assert_int_equal(
+            rock_ws_deque_steal(&object, &out),
+            ROCK_WS_DEQUE_ERROR_DEQUE_IS_EMPTY);
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+static void check_steal_partial_word(void **state) {
+    struct rock_ws_deque object;
+    char item[sizeof(uintptr_t) + 5];
+    assert_int_equal(rock_ws_deque_init(&object, sizeof(item), 0), 0);
+    for (uintmax_t i = 0; i < 10; i++) {
+        memset(item, 'a' + (int) i, sizeof(item));
+        assert_int_equal(rock_ws_deque_push(&object, item), 0);
+    }
+    char out[sizeof(item) + 1];
+    for (uintmax_t i = 0; i < 5; i++) {
+        memset(out, 0, sizeof(out));
+        assert_int_equal(rock_ws_deque_steal(&object, out), 0);
+        memset(item, 'a' + (int) i, sizeof(item));
+        assert_memory_equal(item, out, sizeof(item));
+        assert_int_equal(0, out[sizeof(item)]);
+    }
+    for (uintmax_t i = 10; i > 5; i--) {
+        memset(out, 0, sizeof(out));
+        assert_int_equal(rock_ws_deque_pop(&object, out), 0);
+        memset(item, 'a' + (int) (i - 1), sizeof(item));
+        assert_memory_equal(item, out, sizeof(item));
+        assert_int_equal(0, out[sizeof(item)]);
+    }
+    assert_int_equal(rock_ws_deque_invalidate(&object, NULL), 0);
+}
+
+#define STRESS_LIMIT        200000
+#define STRESS_THIEVES      4
+
+struct stress {
+    struct rock_ws_deque deque;
+    atomic_bool done;
+    atomic_uint seen[STRESS_LIMIT];
+};
+
+static void *stress_thief(void *arg) {
+    struct stress *const stress = arg;
+    uintmax_t item;
+    while (true) {
+        const bool done = atomic_load(&stress->done);
+        if (!rock_ws_deque_steal(&stress->deque, &item)) {
+            atomic_fetch_add(&stress->seen[item], 1);
+        } else if (done) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void check_stress(void **state) {
+    struct stress *const stress = calloc(1, sizeof(*stress));
+    assert_non_null(stress);
+    assert_int_equal(rock_ws_deque_init(&stress->deque,
+                                        sizeof(uintmax_t), 0), 0);
+    pthread_t thieves[STRESS_THIEVES];
+    for (uintmax_t i = 0; i < STRESS_THIEVES; i++) {
+        assert_int_equal(pthread_create(&thieves[i], NULL, stress_thief,
+                                        stress), 0);
+    }
+    uintmax_t item;
+    for (uintmax_t i = 0; i < STRESS_LIMIT; i++) {
+        assert_int_equal(rock_ws_deque_push(&stress->deque, &i), 0);
+        /* owner consumes a share of its own work as a scheduler would */
+        if (!(i % 3) && !rock_ws_deque_pop(&stress->deque, &item)) {
+            atomic_fetch_add(&stress->seen[item], 1);
+        }
+    }
+    while (!rock_ws_deque_pop(&stress->deque, &item)) {
+        atomic_fetch_add(&stress->seen[item], 1);
+    }
+    atomic_store(&stress->done, true);
+    for (uintmax_t i = 0; i < STRESS_THIEVES; i++) {
+        assert_int_equal(pthread_join(thieves[i], NULL), 0);
+    }
+    for (uintmax_t i = 0; i < STRESS_LIMIT; i++) {
+        assert_int_equal(1, atomic_load(&stress->seen[i]));
+    }
+    assert_int_equal(rock_ws_deque_invalidate(&stress->deque, NULL), 0);
+    free(stress);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_size_error_on_object_is_null),
+            cmocka_unit_test(check_size_error_on_out_is_null),
+            cmocka_unit_test(check_size),
+            cmocka_unit_test(check_count_error_on_object_is_null),
+            cmocka_unit_test(check_count_error_on_out_is_null),
+            cmocka_unit_test(check_count),
+            cmocka_unit_test(check_push_error_on_object_is_null),
+            cmocka_unit_test(check_push_error_on_item_is_null),
+            cmocka_unit_test(check_push_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_push),
+            cmocka_unit_test(check_pop_error_on_object_is_null),
+            cmocka_unit_test(check_pop_error_on_out_is_null),
+            cmocka_unit_test(check_pop_error_on_deque_is_empty),
+            cmocka_unit_test(check_pop),
+            cmocka_unit_test(check_steal_error_on_object_is_null),
+            cmocka_unit_test(check_steal_error_on_out_is_null),
+            cmocka_unit_test(check_steal_error_on_deque_is_empty),
+            cmocka_unit_test(check_steal),
+            cmocka_unit_test(check_steal_partial_word),
+            cmocka_unit_test(check_stress),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}